@@ -2,6 +2,9 @@
 #include "App.h"
 
 #include <ppltasks.h>
+#include <fstream>
+
+#include "Simulation\Profiler.hpp"
 
 using namespace SimpleSample_DirectXTK_UWP;
 
@@ -79,6 +82,12 @@ void App::SetWindow(CoreWindow^ window)
 	DisplayInformation::DisplayContentsInvalidated +=
 		ref new TypedEventHandler<DisplayInformation^, Object^>(this, &App::OnDisplayContentsInvalidated);
 
+	window->KeyDown +=
+		ref new TypedEventHandler<CoreWindow^, KeyEventArgs^>(this, &App::OnKeyDown);
+
+	window->KeyUp +=
+		ref new TypedEventHandler<CoreWindow^, KeyEventArgs^>(this, &App::OnKeyUp);
+
 	keyboardPointer->SetWindow(window);
 
 	m_deviceResources->SetWindow(window);
@@ -90,23 +99,31 @@ void App::Load(Platform::String^ entryPoint)
 	if (m_main == nullptr)
 	{
 		m_main = std::unique_ptr<SimpleSample_DirectXTK_UWPMain>(new SimpleSample_DirectXTK_UWPMain(m_deviceResources));
+
+		// Frame times of the whole session, for Tools\FrameLogReport.
+		auto folder = Windows::Storage::ApplicationData::Current->LocalFolder->Path;
+		m_main->OpenFrameLog(std::wstring(folder->Data()) + L"\\frame_times.pgft");
 	}
 }
 
 // This method is called after the window becomes active.
 void App::Run()
 {
+	Simulation::Profiler::Get().SetThreadName("Game loop");
+
 	while (!m_windowClosed)
 	{
 		if (m_windowVisible)
 		{
+			PROFILE_ZONE("Frame");
+
 			CoreWindow::GetForCurrentThread()->Dispatcher->ProcessEvents(CoreProcessEventsOption::ProcessAllIfPresent);
 
 			m_main->Update();
 
 			if (m_main->Render())
 			{
-				m_deviceResources->Present();
+				m_main->Present();
 			}
 		}
 		else
@@ -143,7 +160,9 @@ void App::OnSuspending(Platform::Object^ sender, SuspendingEventArgs^ args)
 	{
         m_deviceResources->Trim();
 
-		// Insert your code here.
+		// Keep the input of this session; Tools\ReplayRunner replays it as a performance test.
+		auto folder = Windows::Storage::ApplicationData::Current->LocalFolder->Path;
+		m_main->SaveInputLog(std::wstring(folder->Data()) + L"\\last_session.pgil");
 
 		deferral->Complete();
 	});
@@ -158,6 +177,58 @@ void App::OnResuming(Platform::Object^ sender, Platform::Object^ args)
 	// Insert your code here.
 }
 
+// Input event handlers.
+
+// Key presses and releases are timed from here for the input latency
+// shown by the FPS overlay; auto repeats change nothing and are not.
+// F7 writes the memory used per subsystem to LocalFolder\memory.txt.
+// F8 switches late latching of the player's movement on and off.
+// F9 starts a profiler capture and the next F9 stops it, writing the zones
+// of the last seconds to LocalFolder\profile.json for chrome://tracing or
+// ui.perfetto.dev.
+void App::OnKeyDown(CoreWindow^ sender, KeyEventArgs^ args)
+{
+	if (args->KeyStatus.WasKeyDown)
+		return;
+
+	m_main->OnInput();
+
+	if (args->VirtualKey == VirtualKey::F7)
+	{
+		auto folder = Windows::Storage::ApplicationData::Current->LocalFolder->Path;
+		m_main->SaveMemoryReport(std::wstring(folder->Data()) + L"\\memory.txt");
+		return;
+	}
+
+	if (args->VirtualKey == VirtualKey::F8)
+	{
+		m_main->SetLateLatch(!m_main->IsLateLatchEnabled());
+		return;
+	}
+
+	if (args->VirtualKey != VirtualKey::F9)
+		return;
+
+	auto& profiler = Simulation::Profiler::Get();
+	if (!profiler.IsEnabled())
+	{
+		profiler.Clear();
+		profiler.SetEnabled(true);
+		return;
+	}
+
+	profiler.SetEnabled(false);
+
+	auto folder = Windows::Storage::ApplicationData::Current->LocalFolder->Path;
+	std::ofstream file(std::wstring(folder->Data()) + L"\\profile.json");
+	profiler.WriteChromeTrace(file);
+}
+
+void App::OnKeyUp(CoreWindow^ sender, KeyEventArgs^ args)
+{
+	m_main->OnInput();
+}
+
 // Window event handlers.
 
 void App::OnWindowSizeChanged(CoreWindow^ sender, WindowSizeChangedEventArgs^ args)
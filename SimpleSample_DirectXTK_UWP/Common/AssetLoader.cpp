@@ -0,0 +1,225 @@
+﻿#include "pch.h"
+#include "AssetLoader.h"
+#include "DirectXHelper.h"
+#include "TextureMemory.h"
+#include "..\Simulation\Profiler.hpp"
+
+#include "DDSTextureLoader.h"
+
+#include <fstream>
+#include <iterator>
+
+using namespace DX;
+using namespace Microsoft::WRL;
+
+namespace
+{
+	bool IsDdsPath(const std::wstring& path)
+	{
+		return path.size() >= 4 && _wcsicmp(path.c_str() + path.size() - 4, L".dds") == 0;
+	}
+
+	std::vector<uint8_t> ReadFileBytes(const std::wstring& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			throw std::exception("Asset file could not be opened");
+
+		return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	}
+}
+
+AssetLoader::AssetLoader(const std::shared_ptr<DX::DeviceResources>& deviceResources) :
+	m_deviceResources(deviceResources),
+	m_ready(std::make_shared<ReadyQueue>()),
+	m_generation(0),
+	m_doneCount(0),
+	m_requiredCount(0),
+	m_requiredDone(0),
+	m_requiredSeconds(0.0)
+{
+	// The factory is free threaded and shared by the decode tasks.
+	DX::ThrowIfFailed(
+		CoCreateInstance(CLSID_WICImagingFactory2, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(m_wicFactory.GetAddressOf()))
+		);
+}
+
+std::shared_future<AssetLoader::Texture> AssetLoader::LoadTexture(const std::wstring& path, bool required)
+{
+	Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Assets);
+
+	if (m_requests.empty())
+	{
+		m_startTime = std::chrono::steady_clock::now();
+	}
+
+	std::unique_ptr<Request> request(new Request);
+	request->path = path;
+	request->required = required;
+	request->dds = IsDdsPath(path);
+	std::shared_future<Texture> future = request->promise.get_future().share();
+
+	size_t index = m_requests.size();
+	m_requests.push_back(std::move(request));
+	if (required)
+	{
+		m_requiredCount++;
+	}
+
+	// The task owns copies of everything it touches, so it may outlive the loader.
+	auto ready = m_ready;
+	auto factory = m_wicFactory;
+	uint64_t generation = m_generation;
+	bool dds = m_requests[index]->dds;
+	Concurrency::create_task([ready, factory, generation, index, path, dds]()
+	{
+		Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Assets);
+
+		Decoded decoded;
+		decoded.request = index;
+		decoded.generation = generation;
+		decoded.width = 0;
+		decoded.height = 0;
+		try
+		{
+			{
+				PROFILE_ZONE("Asset read");
+				decoded.data = ReadFileBytes(path);
+			}
+			if (!dds)
+			{
+				PROFILE_ZONE("Asset decode");
+				DecodeImage(factory.Get(), decoded);
+			}
+		}
+		catch (...)
+		{
+			decoded.error = std::current_exception();
+		}
+
+		std::lock_guard<std::mutex> lock(ready->mutex);
+		ready->items.push_back(std::move(decoded));
+	});
+
+	return future;
+}
+
+void AssetLoader::Update()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_ready->mutex);
+		if (m_ready->items.empty())
+			return;
+		m_creating.swap(m_ready->items);
+	}
+
+	PROFILE_ZONE("Asset create");
+	Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Assets);
+
+	for (Decoded& decoded : m_creating)
+	{
+		// Finished after a Reset; the request it belonged to is gone.
+		if (decoded.generation != m_generation)
+			continue;
+
+		Request& request = *m_requests[decoded.request];
+		try
+		{
+			if (decoded.error)
+			{
+				std::rethrow_exception(decoded.error);
+			}
+			request.promise.set_value(CreateTexture(request, decoded));
+		}
+		catch (...)
+		{
+			request.promise.set_exception(std::current_exception());
+		}
+
+		m_doneCount++;
+		if (request.required && ++m_requiredDone == m_requiredCount)
+		{
+			m_requiredSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+		}
+	}
+	m_creating.clear();
+}
+
+void AssetLoader::Reset()
+{
+	m_generation++;
+	m_requests.clear();
+	m_doneCount = 0;
+	m_requiredCount = 0;
+	m_requiredDone = 0;
+	m_requiredSeconds = 0.0;
+}
+
+float AssetLoader::GetProgress() const
+{
+	return m_requests.empty() ? 1.f : (float)m_doneCount / (float)m_requests.size();
+}
+
+// Runs on a worker: converts the encoded image in decoded.data to 32bpp RGBA in place.
+void AssetLoader::DecodeImage(IWICImagingFactory* factory, Decoded& decoded)
+{
+	ComPtr<IWICStream> stream;
+	DX::ThrowIfFailed(factory->CreateStream(stream.GetAddressOf()));
+	DX::ThrowIfFailed(stream->InitializeFromMemory(decoded.data.data(), (DWORD)decoded.data.size()));
+
+	ComPtr<IWICBitmapDecoder> decoder;
+	DX::ThrowIfFailed(
+		factory->CreateDecoderFromStream(stream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf())
+		);
+
+	ComPtr<IWICBitmapFrameDecode> frame;
+	DX::ThrowIfFailed(decoder->GetFrame(0, frame.GetAddressOf()));
+	DX::ThrowIfFailed(frame->GetSize(&decoded.width, &decoded.height));
+
+	ComPtr<IWICFormatConverter> converter;
+	DX::ThrowIfFailed(factory->CreateFormatConverter(converter.GetAddressOf()));
+	DX::ThrowIfFailed(
+		converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom)
+		);
+
+	UINT stride = decoded.width * 4;
+	std::vector<uint8_t> pixels((size_t)stride * decoded.height);
+	DX::ThrowIfFailed(converter->CopyPixels(nullptr, stride, (UINT)pixels.size(), pixels.data()));
+	decoded.data.swap(pixels);
+}
+
+AssetLoader::Texture AssetLoader::CreateTexture(const Request& request, const Decoded& decoded)
+{
+	auto device = m_deviceResources->GetD3DDevice();
+
+	Texture texture;
+	if (request.dds)
+	{
+		DX::ThrowIfFailed(
+			DirectX::CreateDDSTextureFromMemory(device, decoded.data.data(), decoded.data.size(), nullptr, texture.GetAddressOf())
+			);
+		DX::TrackTextureMemory(texture.Get());
+		return texture;
+	}
+
+	// Sprites are drawn unscaled, so like CreateWICTextureFromFile there is a single mip.
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = decoded.width;
+	desc.Height = decoded.height;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	D3D11_SUBRESOURCE_DATA initialData = {};
+	initialData.pSysMem = decoded.data.data();
+	initialData.SysMemPitch = decoded.width * 4;
+
+	ComPtr<ID3D11Texture2D> resource;
+	DX::ThrowIfFailed(device->CreateTexture2D(&desc, &initialData, resource.GetAddressOf()));
+	DX::TrackTextureMemory(resource.Get());
+	DX::ThrowIfFailed(device->CreateShaderResourceView(resource.Get(), nullptr, texture.GetAddressOf()));
+	return texture;
+}
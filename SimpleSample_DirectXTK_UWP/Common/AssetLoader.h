@@ -0,0 +1,83 @@
+﻿#pragma once
+
+#include <chrono>
+#include <future>
+#include <mutex>
+
+#include "DeviceResources.h"
+
+namespace DX
+{
+	// Loads textures in parallel without stalling the thread that renders.
+	// Reading the file and decoding it (WIC images are the expensive part) run
+	// as tasks on the thread pool; the D3D objects are created one after the
+	// other on the thread that owns the loader, in Update, which is also where
+	// the future returned for each asset becomes ready.
+	class AssetLoader
+	{
+	public:
+		typedef Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> Texture;
+
+		AssetLoader(const std::shared_ptr<DX::DeviceResources>& deviceResources);
+
+		// Starts loading a .dds, or any image WIC decodes. Required assets gate
+		// IsRequiredSetResident; the others keep streaming in afterwards.
+		std::shared_future<Texture> LoadTexture(const std::wstring& path, bool required = true);
+
+		// Creates the GPU resources of everything decoded since the last call.
+		void Update();
+
+		// Drops every pending load, e.g. on device lost. Their futures are
+		// left with a broken_promise and late results are discarded.
+		void Reset();
+
+		bool		IsRequiredSetResident() const			{ return m_requiredDone == m_requiredCount; }
+		uint32_t	GetLoadedCount() const					{ return m_doneCount; }
+		uint32_t	GetTotalCount() const					{ return (uint32_t)m_requests.size(); }
+		float		GetProgress() const;
+
+		// Time from the first LoadTexture to the required set being resident.
+		double		GetRequiredLoadSeconds() const			{ return m_requiredSeconds; }
+
+	private:
+		struct Request
+		{
+			std::wstring				path;
+			bool						required;
+			bool						dds;
+			std::promise<Texture>		promise;
+		};
+
+		// Produced on a worker: the file for DDS, RGBA pixels for WIC images.
+		struct Decoded
+		{
+			size_t						request;
+			uint64_t					generation;
+			std::vector<uint8_t>		data;
+			uint32_t					width;
+			uint32_t					height;
+			std::exception_ptr			error;
+		};
+
+		struct ReadyQueue
+		{
+			std::mutex					mutex;
+			std::vector<Decoded>		items;
+		};
+
+		static void DecodeImage(IWICImagingFactory* factory, Decoded& decoded);
+		Texture CreateTexture(const Request& request, const Decoded& decoded);
+
+		std::shared_ptr<DX::DeviceResources>				m_deviceResources;
+		Microsoft::WRL::ComPtr<IWICImagingFactory>			m_wicFactory;
+		std::shared_ptr<ReadyQueue>							m_ready;
+		std::vector<Decoded>								m_creating;
+		std::vector<std::unique_ptr<Request>>				m_requests;
+		uint64_t											m_generation;
+		uint32_t											m_doneCount;
+		uint32_t											m_requiredCount;
+		uint32_t											m_requiredDone;
+		std::chrono::steady_clock::time_point				m_startTime;
+		double												m_requiredSeconds;
+	};
+}
@@ -0,0 +1,86 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <cstdint>
+
+// Counts the sprites drawn in a frame and how SpriteBatch turns them into
+// GPU work. In the default deferred sort mode SpriteBatch binds a texture
+// and issues a draw call for every run of consecutive sprites sharing one
+// texture, split again every MaxBatchSize sprites, so those numbers follow
+// from the order in which sprites are submitted. SpriteBatchRenderer calls
+// Note with the texture of every sprite it hands to SpriteBatch.
+
+struct DrawStatsFrame
+{
+	uint32_t	sprites;
+	uint32_t	textureSwitches;
+	uint32_t	drawCalls;
+};
+
+class DrawStats
+{
+public:
+	// SpriteBatch::MaxBatchSize.
+	static const uint32_t MaxBatchSize = 2048;
+
+	DrawStats() : m_texture(nullptr), m_run(0)
+	{
+		m_current = m_last = DrawStatsFrame();
+	}
+
+	// Statistics of the frame being drawn. Content classes report here; the
+	// renderer reads them back after the frame.
+	static DrawStats& Get()
+	{
+		static DrawStats stats;
+		return stats;
+	}
+
+	void BeginFrame()
+	{
+		m_current = DrawStatsFrame();
+		m_texture = nullptr;
+		m_run = 0;
+	}
+
+	// A sprite drawn with texture.
+	void Note(const void* texture)
+	{
+		if (texture != m_texture)
+		{
+			m_texture = texture;
+			m_run = 0;
+			m_current.textureSwitches++;
+		}
+		if (m_run % MaxBatchSize == 0)
+		{
+			m_current.drawCalls++;
+		}
+		m_run++;
+		m_current.sprites++;
+	}
+
+	// SpriteBatch::End flushes, so the next sprite starts a new batch.
+	void EndBatch()
+	{
+		m_texture = nullptr;
+		m_run = 0;
+	}
+
+	void EndFrame()
+	{
+		EndBatch();
+		m_last = m_current;
+	}
+
+	// Totals of the last finished frame.
+	const DrawStatsFrame& GetLastFrame() const	{ return m_last; }
+
+private:
+	DrawStatsFrame		m_current;
+	DrawStatsFrame		m_last;
+	const void*			m_texture;
+	uint32_t			m_run;
+};
@@ -0,0 +1,1327 @@
+//// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+//// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+//// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+//// PARTICULAR PURPOSE.
+////
+//// Copyright (c) Microsoft Corporation. All rights reserved
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Platform independent core of the InputManager: the player actions it
+// reports and the translation of raw key, pointer and gamepad state into
+// those actions once per frame. All state lives in fixed-size tables
+// (virtual keys, pointer slots, touch regions, per-player action bits),
+// so once constructed, translating input neither allocates nor locks.
+// CoreWindow callbacks hand their events to the game thread through a
+// single producer, single consumer ring.
+
+namespace SimpleSample_DirectXTK_UWP
+{
+    //
+    // ** Begin enumerations **
+    //
+
+#pragma region InputManagerEnums
+
+    // Bit values of all the actions a player can
+    // initiate, and which can be returned by the
+    // input manager after processing.
+    // NOTE TO DEVELOPERS: Actions are stored as bits of a 32 bit mask per
+    // player, so there can be at most 32 of them (including INPUT_NONE).
+    enum PLAYER_ACTION_TYPES
+    {
+        // These are examples of input events a game might have:
+        INPUT_NONE = 0,
+        INPUT_COORDINATES_ONLY = 1, // raw coord data
+        INPUT_MOVE,
+        INPUT_AIM,
+        INPUT_FIRE,
+        INPUT_FIRE_UP,
+        INPUT_FIRE_DOWN,
+        INPUT_FIRE_PRESSED,
+        INPUT_FIRE_RELEASED,
+        INPUT_JUMP,
+        INPUT_JUMP_UP,
+        INPUT_JUMP_DOWN,
+        INPUT_JUMP_PRESSED,
+        INPUT_JUMP_RELEASED,
+        INPUT_ACCEL,
+        INPUT_BRAKE,
+        INPUT_SELECT,
+        INPUT_START,
+        INPUT_CANCEL,
+        INPUT_EXIT,
+        INPUT_DIRECTIONAL,
+        // ...
+        // Note to developer: Add the input events your game demands!
+        // ...
+
+        INPUT_MAX
+    };
+
+    static_assert(INPUT_MAX <= 32, "Player actions must fit in a 32 bit mask");
+
+
+    // Types of Windows input events. Used internally for handling passed-through input events.
+    enum INPUT_EVENT_TYPE
+    {
+        INPUT_EVENT_TYPE_DOWN,
+        INPUT_EVENT_TYPE_UP,
+        INPUT_EVENT_TYPE_MOVED,
+        INPUT_EVENT_TYPE_EXITED,
+
+        INPUT_EVENT_TYPE_NUM
+    };
+
+
+    // Bit values of all the input devices supported by the input manager.
+    enum INPUT_DEVICE_TYPES
+    {
+        INPUT_DEVICE_NONE     = 0x00,
+        INPUT_DEVICE_MOUSE    = 0x01,
+        INPUT_DEVICE_KEYBOARD = 0x02,
+        INPUT_DEVICE_TOUCH    = 0x04,
+        INPUT_DEVICE_XINPUT   = 0x08,
+        INPUT_DEVICE_ALL =
+           (INPUT_DEVICE_MOUSE    |
+            INPUT_DEVICE_KEYBOARD |
+            INPUT_DEVICE_TOUCH    |
+            INPUT_DEVICE_XINPUT)
+    };
+
+
+    // Bit values for all the players supported by the input manager.
+    // NOTE TO DEVELOPERS: When you change this list, please
+    // increment or decrement INPUT_MAX_PLAYERS accordingly!
+    enum PLAYER_ID
+    {
+        PLAYER_ID_ONE   = 0x01,
+        PLAYER_ID_TWO   = 0x02,
+        PLAYER_ID_THREE = 0x04,
+        PLAYER_ID_FOUR  = 0x08,
+        // ...
+        // Note to developer: Add more players as your game demands, and as practically
+        // supported by the hardware.
+        // ...
+        PLAYER_ID_MAX
+    };
+
+    // Types of touch screen virtual controls.
+    // NOTE TO DEVELOPERS: You can add to, or update, these touch-screen
+    // control types.
+    enum TOUCH_CONTROL_REGION_TYPES
+    {
+        TOUCH_CONTROL_REGION_REPORT_COORDS_ONLY = 0,
+        TOUCH_CONTROL_REGION_ANALOG_STICK = 1,
+        TOUCH_CONTROL_REGION_BUTTON = 2,
+        TOUCH_CONTROL_REGION_ANALOG_SLIDER = 3,
+
+        TOUCH_CONTROL_REGION_MAX
+    };
+
+    // Gamepad buttons; the same bits as the XINPUT_GAMEPAD_* values in XInput.h.
+    enum GAMEPAD_BUTTONS
+    {
+        GAMEPAD_DPAD_UP          = 0x0001,
+        GAMEPAD_DPAD_DOWN        = 0x0002,
+        GAMEPAD_DPAD_LEFT        = 0x0004,
+        GAMEPAD_DPAD_RIGHT       = 0x0008,
+        GAMEPAD_START            = 0x0010,
+        GAMEPAD_BACK             = 0x0020,
+        GAMEPAD_LEFT_THUMB       = 0x0040, // l-stick click in
+        GAMEPAD_RIGHT_THUMB      = 0x0080, // r-stick click in
+        GAMEPAD_LEFT_SHOULDER    = 0x0100,
+        GAMEPAD_RIGHT_SHOULDER   = 0x0200,
+        GAMEPAD_A                = 0x1000,
+        GAMEPAD_B                = 0x2000,
+        GAMEPAD_X                = 0x4000,
+        GAMEPAD_Y                = 0x8000
+    };
+
+    // The virtual keys bound by default; the same values as Windows::System::VirtualKey.
+    enum INPUT_VIRTUAL_KEYS
+    {
+        INPUT_KEY_CONTROL = 0x11,
+        INPUT_KEY_ESCAPE  = 0x1B,
+        INPUT_KEY_SPACE   = 0x20,
+        INPUT_KEY_LEFT    = 0x25,
+        INPUT_KEY_UP      = 0x26,
+        INPUT_KEY_RIGHT   = 0x27,
+        INPUT_KEY_DOWN    = 0x28
+    };
+
+    //
+    // ** End InputManager enums **
+    //
+#pragma endregion
+
+    // Keyboard/touch/mouse default to player 1 (index 0).
+#define DEFAULT_KEYBOARD_PLAYER_ID               0
+#define DEFAULT_POINTER_PLAYER_ID                0
+
+
+    // Touch region definition errors
+#define INVALID_TOUCH_REGION_ID                 -1
+#define INVALID_TOUCH_REGION_OVERLAPS           -2
+#define INVALID_TOUCH_REGION_INVERTED           -3
+#define INVALID_TOUCH_REGION_OFFSCREEN          -4
+#define INVALID_TOUCH_REGION_TOO_MANY           -5
+
+
+#pragma region InputManagerConsts
+
+    //
+    // Table sizes
+    //
+    // Players actions are reported for; matches XUSER_MAX_COUNT.
+#define INPUT_MAX_PLAYERS               4
+
+    // Virtual key codes are bytes.
+#define INPUT_MAX_KEYS                  256
+
+    // Pointers tracked at the same time: ten fingers, a pen and a mouse, with room to spare.
+#define INPUT_MAX_POINTERS              16
+
+    // Touch control regions that can be defined.
+#define INPUT_MAX_TOUCH_REGIONS         16
+
+
+    //
+    // Constants for handling XInput
+    //
+    // Defines the maximum numbers of Xinput controllers to process. XInput
+    // supports a maximum of 4 controllers.
+#define XINPUT_MAX_CONTROLLERS          4
+
+
+    // The maximum XInput analog throw value. Full range is
+    // -32768 to 32767.
+#define XINPUT_ANALOG_STICK_THROW_MAX   32767.0f
+
+
+    // Stick dead zones; the same values as XINPUT_GAMEPAD_*_THUMB_DEADZONE.
+#define GAMEPAD_LEFT_THUMB_DEADZONE     7849
+#define GAMEPAD_RIGHT_THUMB_DEADZONE    8689
+
+
+    //
+    // Constants for handling pointer devices (mouse/touch)
+    //
+    // Pixel move radius from touchdown for virtual stick deadzone.
+#define POINTER_VIRTUAL_STICK_DEADZONE  10.0f
+#define POINTER_VIRTUAL_STICK_THROW_MAX 45.0f
+
+
+#pragma endregion
+
+#pragma region InputManagerStructs
+
+    // The state of one gamepad for one frame, laid out like XINPUT_GAMEPAD.
+    struct GamepadState
+    {
+        uint16_t        Buttons;        // GAMEPAD_BUTTONS
+        uint8_t         LeftTrigger;
+        uint8_t         RightTrigger;
+        int16_t         ThumbLX;
+        int16_t         ThumbLY;
+        int16_t         ThumbRX;
+        int16_t         ThumbRY;
+    };
+
+
+    // Contains the state of an individual pointer action. Note that a
+    // PointerId is NOT the same as a player or controller ID, as it is used
+    // to track a a press or move event from start to completion.
+    // -- CHANGE LEFT/RIGHT/MIDDLE to IsTouchPressed;
+    struct PointerControllerAction
+    {
+        unsigned int    PointerId;
+        float           CurrentX;
+        float           CurrentY;
+        bool            IsTouchEvent;
+        bool            IsMouseEvent;
+        bool            IsLeftButtonPressed;
+        bool            IsRightButtonPressed;
+        bool            IsMiddleButtonPressed;
+    };
+
+
+    // A CoreWindow key or pointer event, queued for the game thread.
+    struct InputEvent
+    {
+        INPUT_EVENT_TYPE            Type;
+        bool                        IsKeyEvent;
+        unsigned int                VirtualKey;     // Key events only.
+        PointerControllerAction     Pointer;        // Pointer events only.
+        uint64_t                    Timestamp;      // Arrival, steady clock nanoseconds; 0 if not stamped.
+    };
+
+
+    // What holding a virtual key does. Keys bound to INPUT_NONE are ignored.
+    struct KeyBinding
+    {
+        PLAYER_ACTION_TYPES     Action;
+        unsigned int            PlayerId;
+        float                   NormalizedInputValue;
+        float                   X;
+        float                   Y;
+    };
+
+
+    // A touch control region as the translator stores it.
+    struct TouchRegionBounds
+    {
+        float                           Left;
+        float                           Top;
+        float                           Right;
+        float                           Bottom;
+        TOUCH_CONTROL_REGION_TYPES      RegionType;
+        PLAYER_ACTION_TYPES             DefinedAction;
+        bool                            IsEnabled;
+    };
+
+
+    // Defines a final player input action state returned to the game.
+    struct PlayerInputData
+    {
+    public:
+        // The zero-based player ID value for the player that initiated the action.
+        unsigned int ID;
+
+        // The PLAYER_ACTION_TYPES value for the initiated action.
+        PLAYER_ACTION_TYPES PlayerAction;
+
+        // The normalized value (i.e. between 0.f and 1.f) returned from the
+        // input device. For digital inputs, either a value of 0.f or 1.0f is
+        // returned, depending on the action.
+        float NormalizedInputValue;
+
+        // Indicates whether this possible input state is different from last frame.
+
+        // The raw screen coordinate data (x, y) for pointer events. For non-pointer events,
+        // such as virtual key presses or XInput analog stick and digital pad actions, both
+        // of these values are used to indicate the direction of the action, where 1.0 could
+        // indicate up/forward, and -1.0 could indicate down/back. It is up to your game to
+        // interpret the meaning.
+        float X;
+        float Y;
+
+        // Raw coordinate position for touch/mouse input. For non-pointer events, these values
+        // are set to 0.f.
+        float PointerRawX;
+        float PointerRawY;
+
+        // Value used to determine if the acion originated from a touch event.
+        bool IsTouchAction;
+
+        // Virtual throw for touch stick input. For non-touch actions, these values are set to
+        // 0.f by default. You can use them for additional calibration or smoothing information
+        // for custom controls.
+        float PointerThrowX;
+        float PointerThrowY;
+
+        // ctor
+        PlayerInputData() :
+                ID(0),
+                PlayerAction(INPUT_NONE),
+                NormalizedInputValue(0.f),
+                X(0.f),
+                Y(0.f),
+                PointerRawX(0.f),
+                PointerRawY(0.f),
+                IsTouchAction(false),
+                PointerThrowX(-1.f), // -1 means this is not a relative touch input event.
+                PointerThrowY(-1.f)
+        {
+        }
+    };
+
+#pragma endregion
+
+#pragma region PlayerActionsClassDecl
+
+    // A read-only range of player actions.
+    class PlayerActionSpan
+    {
+    public:
+        PlayerActionSpan() : m_begin(nullptr), m_end(nullptr) {}
+        PlayerActionSpan(const PlayerInputData* begin, const PlayerInputData* end) : m_begin(begin), m_end(end) {}
+
+        const PlayerInputData* begin() const                        { return m_begin; }
+        const PlayerInputData* end() const                          { return m_end; }
+        unsigned int size() const                                   { return (unsigned int)(m_end - m_begin); }
+        bool empty() const                                          { return m_begin == m_end; }
+        const PlayerInputData& operator[](unsigned int index) const { return m_begin[index]; }
+
+    private:
+        const PlayerInputData*  m_begin;
+        const PlayerInputData*  m_end;
+    };
+
+
+    // The actions of one frame, ordered by player, then action. Besides
+    // the whole list, it offers each player's actions as a span and finds
+    // a player's action of a given type from the action bits, so consumers
+    // need not scan the list for what they are interested in.
+    class PlayerActions
+    {
+    public:
+        // The players that took an action of one type, as the actions themselves.
+        class ActionTypeView
+        {
+        public:
+            class Iterator
+            {
+            public:
+                Iterator(const PlayerActions* actions, PLAYER_ACTION_TYPES action, unsigned int playerId) :
+                    m_actions(actions), m_action(action), m_playerId(playerId)
+                {
+                    SkipPlayersWithout();
+                }
+
+                const PlayerInputData& operator*() const        { return *m_actions->Find(m_playerId, m_action); }
+                const PlayerInputData* operator->() const       { return m_actions->Find(m_playerId, m_action); }
+                bool operator!=(const Iterator& other) const    { return m_playerId != other.m_playerId; }
+                bool operator==(const Iterator& other) const    { return m_playerId == other.m_playerId; }
+
+                Iterator& operator++()
+                {
+                    m_playerId++;
+                    SkipPlayersWithout();
+                    return *this;
+                }
+
+            private:
+                void SkipPlayersWithout()
+                {
+                    while ((m_playerId < INPUT_MAX_PLAYERS) && !m_actions->Has(m_playerId, m_action))
+                        m_playerId++;
+                }
+
+                const PlayerActions*    m_actions;
+                PLAYER_ACTION_TYPES     m_action;
+                unsigned int            m_playerId;
+            };
+
+            ActionTypeView(const PlayerActions* actions, PLAYER_ACTION_TYPES action) : m_actions(actions), m_action(action) {}
+
+            Iterator begin() const      { return Iterator(m_actions, m_action, 0); }
+            Iterator end() const        { return Iterator(m_actions, m_action, INPUT_MAX_PLAYERS); }
+            bool empty() const          { return !(begin() != end()); }
+
+        private:
+            const PlayerActions*    m_actions;
+            PLAYER_ACTION_TYPES     m_action;
+        };
+
+        PlayerActions() : m_count(0), m_oldestInputTime(0)
+        {
+            std::memset(m_playerBegin, 0, sizeof(m_playerBegin));
+            std::memset(m_masks, 0, sizeof(m_masks));
+        }
+
+        //
+        // All actions
+        //
+        const PlayerInputData* begin() const                        { return m_actions; }
+        const PlayerInputData* end() const                          { return m_actions + m_count; }
+        unsigned int size() const                                   { return m_count; }
+        bool empty() const                                          { return m_count == 0; }
+        const PlayerInputData& operator[](unsigned int index) const { return m_actions[index]; }
+
+        // Copies the actions into a caller-owned buffer; returns how many
+        // were copied, at most capacity.
+        unsigned int CopyTo(PlayerInputData* buffer, unsigned int capacity) const
+        {
+            unsigned int count = (m_count < capacity) ? m_count : capacity;
+            std::copy(m_actions, m_actions + count, buffer);
+            return count;
+        }
+
+        //
+        // Filtered views
+        //
+        PlayerActionSpan ForPlayer(unsigned int playerId) const
+        {
+            if (playerId >= INPUT_MAX_PLAYERS)
+                return PlayerActionSpan();
+            return PlayerActionSpan(m_actions + m_playerBegin[playerId], m_actions + m_playerBegin[playerId + 1]);
+        }
+
+        ActionTypeView OfType(PLAYER_ACTION_TYPES action) const     { return ActionTypeView(this, action); }
+
+        // One bit per PLAYER_ACTION_TYPES value the player took this frame.
+        uint32_t GetActionMask(unsigned int playerId) const
+        {
+            return (playerId < INPUT_MAX_PLAYERS) ? m_masks[playerId] : 0;
+        }
+
+        bool Has(unsigned int playerId, PLAYER_ACTION_TYPES action) const
+        {
+            return (action < INPUT_MAX) && ((GetActionMask(playerId) >> action) & 1);
+        }
+
+        // The player's action of that type, or null. The actions before it
+        // in the player's span are counted from the action bits below it.
+        const PlayerInputData* Find(unsigned int playerId, PLAYER_ACTION_TYPES action) const
+        {
+            if (!Has(playerId, action))
+                return nullptr;
+            return m_actions + m_playerBegin[playerId] + CountBits(m_masks[playerId] & ((1u << action) - 1));
+        }
+
+        // Arrival time of the oldest key or pointer event this frame was
+        // translated from, or 0 if it had none; for measuring input latency.
+        uint64_t GetOldestInputTime() const                         { return m_oldestInputTime; }
+
+    private:
+        friend class InputTranslator;
+
+        static unsigned int CountBits(uint32_t bits)
+        {
+            bits = bits - ((bits >> 1) & 0x55555555u);
+            bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+            return (((bits + (bits >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24;
+        }
+
+        PlayerInputData         m_actions[INPUT_MAX_PLAYERS * INPUT_MAX];
+        unsigned int            m_count;
+        unsigned int            m_playerBegin[INPUT_MAX_PLAYERS + 1];  // Where each player's actions start.
+        uint32_t                m_masks[INPUT_MAX_PLAYERS];
+        uint64_t                m_oldestInputTime;
+    };
+
+#pragma endregion
+
+#pragma region InputEventQueueClassDecl
+
+    // Carries events from the CoreWindow callbacks (the only producer) to
+    // the game thread (the only consumer). Push and Pop are wait free and
+    // never allocate. If the game thread stops draining the queue, new
+    // events are dropped and counted instead of blocking the window.
+    class InputEventQueue
+    {
+    public:
+        static const uint32_t Capacity = 256;
+
+        InputEventQueue() : m_head(0), m_tail(0), m_dropped(0) {}
+
+        InputEventQueue(const InputEventQueue&) = delete;
+        InputEventQueue& operator=(const InputEventQueue&) = delete;
+
+        bool Push(const InputEvent& inputEvent)
+        {
+            uint32_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            m_events[tail % Capacity] = inputEvent;
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool Pop(InputEvent& inputEvent)
+        {
+            uint32_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire))
+                return false;
+
+            inputEvent = m_events[head % Capacity];
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        uint32_t GetDroppedCount() const    { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        InputEvent                  m_events[Capacity];
+        std::atomic<uint32_t>       m_head;
+        std::atomic<uint32_t>       m_tail;
+        std::atomic<uint32_t>       m_dropped;
+    };
+
+#pragma endregion
+
+#pragma region InputTranslatorClassDecl
+
+    // Turns the raw input received since the last frame into that frame's
+    // player actions. Used from the game thread only, except for the
+    // event queue, which the CoreWindow thread pushes to.
+    class InputTranslator
+    {
+    public:
+        InputTranslator() :
+            m_droppedPointers(0),
+            m_touchRegionCount(0),
+            m_gamepadMask(0),
+            m_playersSeen(0),
+            m_oldestEventTime(0),
+            m_currentFrame(0)
+        {
+            std::memset(m_keysDown, 0, sizeof(m_keysDown));
+            std::memset(m_pointers, 0, sizeof(m_pointers));
+            std::memset(m_actionsThisFrame, 0, sizeof(m_actionsThisFrame));
+            std::memset(m_actionsLastFrame, 0, sizeof(m_actionsLastFrame));
+
+            SetDefaultKeyBindings();
+        }
+
+        InputTranslator(const InputTranslator&) = delete;
+        InputTranslator& operator=(const InputTranslator&) = delete;
+
+        // The queue CoreWindow key and pointer events are pushed to.
+        InputEventQueue& GetEventQueue()                { return m_events; }
+
+        //
+        // Keyboard bindings
+        //
+        void SetKeyBinding(unsigned int virtualKey, const KeyBinding& binding)
+        {
+            if (virtualKey < INPUT_MAX_KEYS)
+                m_keyBindings[virtualKey] = binding;
+        }
+
+        // Escape exits, space fires, control jumps and the arrow keys move player 1.
+        void SetDefaultKeyBindings()
+        {
+            std::memset(m_keyBindings, 0, sizeof(m_keyBindings));
+            SetKeyBinding(INPUT_KEY_ESCAPE,  MakeKeyBinding(INPUT_EXIT,      1.f,  0.f,  0.f));
+            SetKeyBinding(INPUT_KEY_SPACE,   MakeKeyBinding(INPUT_FIRE_DOWN, 1.f,  0.f,  0.f));
+            SetKeyBinding(INPUT_KEY_CONTROL, MakeKeyBinding(INPUT_JUMP_DOWN, 1.f,  0.f,  0.f));
+            SetKeyBinding(INPUT_KEY_LEFT,    MakeKeyBinding(INPUT_MOVE,     -1.f, -1.f,  0.f));
+            SetKeyBinding(INPUT_KEY_RIGHT,   MakeKeyBinding(INPUT_MOVE,      1.f,  1.f,  0.f));
+            SetKeyBinding(INPUT_KEY_UP,      MakeKeyBinding(INPUT_MOVE,      1.f,  0.f,  1.f));
+            SetKeyBinding(INPUT_KEY_DOWN,    MakeKeyBinding(INPUT_MOVE,     -1.f,  0.f, -1.f));
+        }
+
+        //
+        // Touch regions
+        //
+        // Returns 0 and the new region's id, or one of the INVALID_TOUCH_REGION_* errors.
+        int AddTouchRegion(const TouchRegionBounds& region, unsigned int& regionId)
+        {
+            // Bad touch regions can create weird artifacts!
+            if ((region.Left < 0.f) || (region.Top < 0.f) || (region.Right < 0.f) || (region.Bottom < 0.f))
+                return INVALID_TOUCH_REGION_OFFSCREEN;
+
+            if ((region.Left > region.Right) || (region.Top > region.Bottom))
+                return INVALID_TOUCH_REGION_INVERTED;
+
+            for (unsigned int i = 0; i < m_touchRegionCount; i++)
+            {
+                const TouchRegionBounds& other = m_touchRegions[i];
+                if (!((region.Left > other.Right) || (region.Right < other.Left) ||
+                      (region.Top > other.Bottom) || (region.Bottom < other.Top)))
+                {
+                    return INVALID_TOUCH_REGION_OVERLAPS;
+                }
+            }
+
+            if (m_touchRegionCount == INPUT_MAX_TOUCH_REGIONS)
+                return INVALID_TOUCH_REGION_TOO_MANY;
+
+            regionId = m_touchRegionCount;
+            m_touchRegions[m_touchRegionCount++] = region;
+            return 0;
+        }
+
+        void SetTouchRegionEnabled(unsigned int regionId, bool enabled)
+        {
+            if (regionId < m_touchRegionCount)
+                m_touchRegions[regionId].IsEnabled = enabled;
+        }
+
+        void ClearTouchRegions()                        { m_touchRegionCount = 0; }
+
+        //
+        // Per frame processing
+        //
+        // The state of a connected gamepad for the coming Translate.
+        void SetGamepadState(unsigned int controllerId, const GamepadState& state)
+        {
+            if (controllerId < XINPUT_MAX_CONTROLLERS)
+            {
+                m_gamepads[controllerId] = state;
+                m_gamepadMask |= 1u << controllerId;
+            }
+        }
+
+        // Drains the event queue and translates the input received since the
+        // last call, for the devices in deviceMask, into this frame's actions.
+        void Translate(unsigned int deviceMask)
+        {
+            ProcessEvents();
+
+            m_playersSeen = 0;
+            std::memset(m_actionsThisFrame, 0, sizeof(m_actionsThisFrame));
+
+            if (deviceMask & INPUT_DEVICE_XINPUT)
+            {
+                TranslateGamepads();
+            }
+
+            if (deviceMask & INPUT_DEVICE_KEYBOARD)
+            {
+                TranslateKeyboard();
+            }
+
+            if (deviceMask & INPUT_DEVICE_TOUCH)
+            {
+                TranslateTouchPointers();
+                TranslateMousePointers();
+            }
+
+            AddTransitoryStates();
+            ProcessStatesToPlayerActions(m_frames[m_currentFrame ^ 1]);
+            UpdateLastFrameState();
+
+            m_gamepadMask = 0;
+            m_currentFrame ^= 1;
+        }
+
+        // The actions of the last Translate. They are double buffered: a
+        // reference stays valid, and unchanged, through the next Translate
+        // and only goes stale with the one after it.
+        const PlayerActions& GetActions() const         { return m_frames[m_currentFrame]; }
+
+        // Bits of the players the keyboard or a pointer produced input for in the last Translate.
+        unsigned int GetPlayersSeen() const             { return m_playersSeen; }
+
+        // Pointer events dropped because INPUT_MAX_POINTERS pointers were already tracked.
+        uint32_t GetDroppedPointerCount() const         { return m_droppedPointers; }
+
+        // Compute the normalized magnitude for any analog stick operation, including both
+        // the XInput analog sticks and the touch screen virtual analog stick, and normalize
+        // the input values.
+        static float ComputeThumbstickMagnitudeFactor(
+            float const stickX,
+            float const stickY,
+            int   const deadZone,
+            float const maxThrow)
+        {
+            // Determine how far the controller is pushed.
+            float magnitude = std::sqrt(stickX*stickX + stickY*stickY);
+
+            // Avoid dividing by zero, and zero out the magnitude in the dead zone.
+            if (magnitude <= deadZone) return 0.f;
+
+            // Clip the magnitude at its expected maximum value.
+            if (magnitude > maxThrow) magnitude = maxThrow;
+
+            // Adjust magnitude relative to the end of the dead zone.
+            return (magnitude - deadZone) / (maxThrow - deadZone);
+        }
+
+    private:
+        // A pointer being tracked, with its state from the events of this
+        // frame and from the last frame it was processed in.
+        struct PointerSlot
+        {
+            bool                        InUse;
+            bool                        IsPressed;      // As of its latest event.
+            bool                        HasThisFrame;
+            bool                        HasLastFrame;
+            PointerControllerAction     ThisFrame;
+            PointerControllerAction     LastFrame;
+            float                       TouchDownX;     // Where the press started; the virtual stick's center.
+            float                       TouchDownY;
+        };
+
+        static KeyBinding MakeKeyBinding(PLAYER_ACTION_TYPES action, float value, float x, float y)
+        {
+            KeyBinding binding;
+            binding.Action = action;
+            binding.PlayerId = DEFAULT_KEYBOARD_PLAYER_ID;
+            binding.NormalizedInputValue = value;
+            binding.X = x;
+            binding.Y = y;
+            return binding;
+        }
+
+        static float Clamp(float value)
+        {
+            return (value > 1.f) ? 1.f : ((value < -1.f) ? -1.f : value);
+        }
+
+        bool IsKeyDown(unsigned int virtualKey) const
+        {
+            return (m_keysDown[virtualKey / 64] >> (virtualKey % 64)) & 1;
+        }
+
+        void ProcessEvents()
+        {
+            InputEvent inputEvent;
+            while (m_events.Pop(inputEvent))
+            {
+                if (inputEvent.Timestamp != 0 && (m_oldestEventTime == 0 || inputEvent.Timestamp < m_oldestEventTime))
+                    m_oldestEventTime = inputEvent.Timestamp;
+
+                if (inputEvent.IsKeyEvent)
+                {
+                    if (inputEvent.VirtualKey >= INPUT_MAX_KEYS)
+                        continue;
+
+                    uint64_t bit = 1ull << (inputEvent.VirtualKey % 64);
+                    if (inputEvent.Type == INPUT_EVENT_TYPE_DOWN)
+                        m_keysDown[inputEvent.VirtualKey / 64] |= bit;
+                    else if (inputEvent.Type == INPUT_EVENT_TYPE_UP)
+                        m_keysDown[inputEvent.VirtualKey / 64] &= ~bit;
+                }
+                else
+                {
+                    ProcessPointerEvent(inputEvent.Pointer, inputEvent.Type);
+                }
+            }
+        }
+
+        // The latest event of a pointer within a frame wins.
+        void ProcessPointerEvent(const PointerControllerAction& pointerAction, INPUT_EVENT_TYPE type)
+        {
+            PointerSlot* slot = FindPointerSlot(pointerAction.PointerId);
+            if (!slot)
+            {
+                m_droppedPointers++;
+                return;
+            }
+
+            if (!slot->InUse || type == INPUT_EVENT_TYPE_DOWN)
+            {
+                // Set the touch down point (i.e. where the press event started).
+                slot->TouchDownX = pointerAction.CurrentX;
+                slot->TouchDownY = pointerAction.CurrentY;
+            }
+
+            slot->InUse = true;
+            slot->IsPressed = pointerAction.IsLeftButtonPressed || pointerAction.IsRightButtonPressed || pointerAction.IsMiddleButtonPressed;
+            slot->HasThisFrame = true;
+            slot->ThisFrame = pointerAction;
+        }
+
+        // The slot tracking pointerId, else a free one, else null.
+        PointerSlot* FindPointerSlot(unsigned int pointerId)
+        {
+            PointerSlot* freeSlot = nullptr;
+            for (unsigned int i = 0; i < INPUT_MAX_POINTERS; i++)
+            {
+                PointerSlot& slot = m_pointers[i];
+                if (!slot.InUse)
+                {
+                    if (!freeSlot) freeSlot = &slot;
+                }
+                else if (slot.ThisFrame.PointerId == pointerId)
+                {
+                    return &slot;
+                }
+            }
+            return freeSlot;
+        }
+
+        // Adds a gameplay action to this frame's actions. This method checks
+        // for redundancy, and merges similar events obtained within the frame
+        // into each player's input state.
+        void AddPlayerAction(const PlayerInputData& playerInput)
+        {
+            unsigned int idVal = playerInput.ID;
+            unsigned int actionVal = playerInput.PlayerAction;
+            if ((idVal >= INPUT_MAX_PLAYERS) || (actionVal >= INPUT_MAX))
+                return;
+
+            uint32_t actionBit = 1u << actionVal;
+            PlayerInputData& resolved = m_resolvedActionsThisFrame[idVal][actionVal];
+
+            if (!(m_actionsThisFrame[idVal] & actionBit))
+            {
+                // since this input is new this frame there is no resolve action needed.
+                resolved = playerInput;
+                m_actionsThisFrame[idVal] |= actionBit;
+            }
+            else if ((actionVal == INPUT_MOVE) || (actionVal == INPUT_AIM))
+            {
+                // Resolve move conflicts with XInput and Touch controller if default pointer player ID
+                // is the same as an attached XInput controller player ID.
+                resolved.NormalizedInputValue = Clamp(resolved.NormalizedInputValue + playerInput.NormalizedInputValue);
+                resolved.X = Clamp(resolved.X + playerInput.X);
+                resolved.Y = Clamp(resolved.Y + playerInput.Y);
+
+                if (playerInput.IsTouchAction)
+                {
+                    resolved.PointerRawX   = playerInput.PointerRawX;
+                    resolved.PointerRawY   = playerInput.PointerRawY;
+                    resolved.PointerThrowX = playerInput.PointerThrowX;
+                    resolved.PointerThrowY = playerInput.PointerThrowY;
+                    resolved.IsTouchAction = true;
+                }
+            }
+        }
+
+        // For the digital actions, adds PRESSED or RELEASED when the state
+        // changed since the last frame. Analog actions have no transitions;
+        // it is up to the game to respond to changes in analog state.
+        void AddTransitoryStates()
+        {
+            for (unsigned int idVal = 0; idVal < INPUT_MAX_PLAYERS; idVal++)
+            {
+                uint32_t changed = m_actionsThisFrame[idVal] ^ m_actionsLastFrame[idVal];
+                bool isDown = (m_actionsThisFrame[idVal] & (1u << INPUT_FIRE_DOWN)) != 0;
+                if (changed & (1u << INPUT_FIRE_DOWN))
+                    AddTransitoryState(idVal, isDown ? INPUT_FIRE_PRESSED : INPUT_FIRE_RELEASED);
+
+                isDown = (m_actionsThisFrame[idVal] & (1u << INPUT_JUMP_DOWN)) != 0;
+                if (changed & (1u << INPUT_JUMP_DOWN))
+                    AddTransitoryState(idVal, isDown ? INPUT_JUMP_PRESSED : INPUT_JUMP_RELEASED);
+            }
+        }
+
+        void AddTransitoryState(unsigned int idVal, PLAYER_ACTION_TYPES action)
+        {
+            PlayerInputData playerInput;
+            playerInput.ID = idVal;
+            playerInput.PlayerAction = action;
+            playerInput.NormalizedInputValue = 1.0f;
+
+            m_resolvedActionsThisFrame[idVal][action] = playerInput;
+            m_actionsThisFrame[idVal] |= 1u << action;
+        }
+
+        void ProcessStatesToPlayerActions(PlayerActions& frame)
+        {
+            frame.m_count = 0;
+            for (unsigned int idVal = 0; idVal < INPUT_MAX_PLAYERS; idVal++)
+            {
+                frame.m_playerBegin[idVal] = frame.m_count;
+                frame.m_masks[idVal] = m_actionsThisFrame[idVal];
+
+                uint32_t actions = m_actionsThisFrame[idVal];
+                for (unsigned int actionVal = 0; actions != 0; actionVal++, actions >>= 1)
+                {
+                    if (actions & 1)
+                        frame.m_actions[frame.m_count++] = m_resolvedActionsThisFrame[idVal][actionVal];
+                }
+            }
+            frame.m_playerBegin[INPUT_MAX_PLAYERS] = frame.m_count;
+            frame.m_oldestInputTime = m_oldestEventTime;
+            m_oldestEventTime = 0;
+        }
+
+        // Keeps what the next frame needs to detect state transitions, and
+        // forgets pointers that are neither pressed nor watched any more.
+        void UpdateLastFrameState()
+        {
+            std::memcpy(m_actionsLastFrame, m_actionsThisFrame, sizeof(m_actionsLastFrame));
+
+            // A pointer class that had events this frame replaces its last
+            // frame state; one that had none keeps it.
+            bool touchThisFrame = false;
+            bool mouseThisFrame = false;
+            for (unsigned int i = 0; i < INPUT_MAX_POINTERS; i++)
+            {
+                const PointerSlot& slot = m_pointers[i];
+                if (slot.InUse && slot.HasThisFrame)
+                {
+                    touchThisFrame |= slot.ThisFrame.IsTouchEvent;
+                    mouseThisFrame |= slot.ThisFrame.IsMouseEvent;
+                }
+            }
+
+            for (unsigned int i = 0; i < INPUT_MAX_POINTERS; i++)
+            {
+                PointerSlot& slot = m_pointers[i];
+                if (!slot.InUse)
+                    continue;
+
+                if (slot.ThisFrame.IsTouchEvent ? touchThisFrame : mouseThisFrame)
+                {
+                    slot.HasLastFrame = slot.HasThisFrame;
+                    slot.LastFrame = slot.ThisFrame;
+                }
+
+                slot.HasThisFrame = false;
+                slot.InUse = slot.HasLastFrame || slot.IsPressed;
+            }
+        }
+
+        //
+        // Device translation
+        //
+        // Converts gamepad state to player gameplay actions.
+        void TranslateGamepads()
+        {
+            for (unsigned int i = 0; i < XINPUT_MAX_CONTROLLERS; i++)
+            {
+                if (!(m_gamepadMask & (1u << i)))
+                    continue;
+
+                const GamepadState& gamepad = m_gamepads[i];
+
+                // Set up a player input data structure.
+                PlayerInputData playerInput;
+                playerInput.ID = i;
+
+                // All digital inputs are set to a value of 1.0f for usage convenience.
+
+                //
+                // NOTE TO DEVELOPER: The following section of code is where you add
+                // or update behaviors for different XInput input actions. Use this
+                // implementation as a template when adding your own behaviors.
+                //
+
+                // Handle button presses.
+                static const struct { uint16_t Button; PLAYER_ACTION_TYPES Action; } buttons[] =
+                {
+                    { GAMEPAD_START, INPUT_START },
+                    { GAMEPAD_BACK,  INPUT_EXIT },
+                    { GAMEPAD_A,     INPUT_FIRE_DOWN },
+                    { GAMEPAD_B,     INPUT_JUMP_DOWN },
+                    { GAMEPAD_X,     INPUT_SELECT },
+                    { GAMEPAD_Y,     INPUT_CANCEL },
+                };
+
+                for (const auto& button : buttons)
+                {
+                    if (gamepad.Buttons & button.Button)
+                    {
+                        playerInput.PlayerAction = button.Action;
+                        playerInput.NormalizedInputValue = 1.0f;
+                        AddPlayerAction(playerInput);
+                    }
+                }
+
+                // Handle trigger inputs.
+                if (gamepad.LeftTrigger > 0)
+                {
+                    // NOTE:  Value is between 0.f and 256.f. However, analog triggers often have a max value slightly less than 256.f.
+                    const float padding = 256.f * 0.99f;
+                    float paddedValue = (float) gamepad.LeftTrigger / padding;
+
+                    playerInput.PlayerAction = INPUT_BRAKE;
+                    playerInput.NormalizedInputValue = (paddedValue > 1.f) ? 1.f : paddedValue; // Check for values slightly past our padded range.
+                    AddPlayerAction(playerInput);
+                }
+
+                if (gamepad.RightTrigger > 0)
+                {
+                    // As an example, we treat the analog R-trigger as digital.
+                    playerInput.PlayerAction = INPUT_FIRE_DOWN;
+                    playerInput.NormalizedInputValue = 1.f;
+                    AddPlayerAction(playerInput);
+                }
+
+                // NOTE TO DEVELOPER: Values for thumbsticks return between -32768 and 32767. The
+                // InputManager normalizes them such that all analog controls, both XInput and
+                // virtual touchscreen implementations, return a value between -1.f and 1.f.
+                if ((gamepad.ThumbLX != 0) || (gamepad.ThumbLY != 0))
+                {
+                    AddStickAction(playerInput, INPUT_MOVE, gamepad.ThumbLX, gamepad.ThumbLY, GAMEPAD_LEFT_THUMB_DEADZONE);
+                }
+
+                if ((gamepad.ThumbRX != 0) || (gamepad.ThumbRY != 0))
+                {
+                    AddStickAction(playerInput, INPUT_AIM, gamepad.ThumbRX, gamepad.ThumbRY, GAMEPAD_RIGHT_THUMB_DEADZONE);
+                }
+            }
+        }
+
+        void AddStickAction(PlayerInputData& playerInput, PLAYER_ACTION_TYPES action, int16_t stickX, int16_t stickY, int deadZone)
+        {
+            float magnitude = ComputeThumbstickMagnitudeFactor((float) stickX, (float) stickY, deadZone, XINPUT_ANALOG_STICK_THROW_MAX);
+
+            playerInput.PlayerAction = action;
+
+            // Normalized value of stick press in X and Y direction
+            playerInput.X = (float) stickX * magnitude / XINPUT_ANALOG_STICK_THROW_MAX;
+            playerInput.Y = (float) stickY * magnitude / XINPUT_ANALOG_STICK_THROW_MAX;
+
+            playerInput.NormalizedInputValue = 1.f; // Use this field to indicate positive action.
+            AddPlayerAction(playerInput);
+        }
+
+        // Convert held keys into player gameplay actions through the key bindings.
+        void TranslateKeyboard()
+        {
+            for (unsigned int word = 0; word < INPUT_MAX_KEYS / 64; word++)
+            {
+                uint64_t keys = m_keysDown[word];
+                if (keys == 0)
+                    continue;
+
+                // Enable the player ID for the default keyboard player assignment.
+                m_playersSeen |= 1u << DEFAULT_KEYBOARD_PLAYER_ID;
+
+                for (unsigned int virtualKey = word * 64; keys != 0; virtualKey++, keys >>= 1)
+                {
+                    const KeyBinding& binding = m_keyBindings[virtualKey];
+                    if (!(keys & 1) || (binding.Action == INPUT_NONE))
+                        continue;
+
+                    PlayerInputData playerInput;
+                    playerInput.ID                   = binding.PlayerId;
+                    playerInput.PlayerAction         = binding.Action;
+                    playerInput.NormalizedInputValue = binding.NormalizedInputValue;
+                    playerInput.X                    = binding.X;
+                    playerInput.Y                    = binding.Y;
+                    AddPlayerAction(playerInput);
+                }
+            }
+        }
+
+        // If the coordinates are in a region, returns its index, otherwise
+        // INVALID_TOUCH_REGION_ID.
+        int FindTouchRegion(float x, float y) const
+        {
+            for (unsigned int i = 0; i < m_touchRegionCount; i++)
+            {
+                const TouchRegionBounds& region = m_touchRegions[i];
+                if ((x <= region.Right) && (x >= region.Left) && (y <= region.Bottom) && (y >= region.Top))
+                    return (int) i;
+            }
+            return INVALID_TOUCH_REGION_ID;
+        }
+
+        // Converts touch pointers into virtual stick and button actions.
+        void TranslateTouchPointers()
+        {
+            // Prevents multiple touch points from providing stick input.
+            uint32_t virtualStickProcessedThisFrame = 0;
+
+            for (unsigned int i = 0; i < INPUT_MAX_POINTERS; i++)
+            {
+                PointerSlot& slot = m_pointers[i];
+                if (!slot.InUse || !slot.HasThisFrame || !slot.ThisFrame.IsTouchEvent)
+                    continue;
+
+                // Enable the player ID for the default pointer player assignment.
+                m_playersSeen |= 1u << DEFAULT_POINTER_PLAYER_ID;
+
+                const PointerControllerAction& pointerAction = slot.ThisFrame;
+                int id = FindTouchRegion(pointerAction.CurrentX, pointerAction.CurrentY);
+
+                // Touching the screen provides data for player 1.
+                PlayerInputData playerInput;
+                playerInput.ID = DEFAULT_POINTER_PLAYER_ID;
+                playerInput.IsTouchAction = true;
+
+                if ((id == INVALID_TOUCH_REGION_ID) || !m_touchRegions[id].IsEnabled)
+                {
+                    // Any touch input at all has to be recognized. This enables the
+                    // virtual controller to display itself when the player touches
+                    // the display.
+                    playerInput.PlayerAction = INPUT_NONE;
+                    AddPlayerAction(playerInput);
+                    continue;
+                }
+
+                const TouchRegionBounds& region = m_touchRegions[id];
+                if (region.RegionType == TOUCH_CONTROL_REGION_ANALOG_STICK)
+                {
+                    // Only the first touch point in a stick region drives it.
+                    uint32_t stickBit = 1u << region.DefinedAction;
+                    if (virtualStickProcessedThisFrame & stickBit)
+                        continue;
+                    virtualStickProcessedThisFrame |= stickBit;
+
+                    float centerX, centerY;
+                    if (!slot.HasLastFrame)
+                    {
+                        // A new touch point: the stick is centered on it.
+                        centerX = pointerAction.CurrentX;
+                        centerY = pointerAction.CurrentY;
+                    }
+                    else if (!pointerAction.IsLeftButtonPressed)
+                    {
+                        // Pointer is up, so remove it from the processing state.
+                        slot.HasThisFrame = false;
+                        slot.HasLastFrame = false;
+                        continue;
+                    }
+                    else
+                    {
+                        // Pointer has moved; the stick stays centered on the initial touch.
+                        centerX = slot.TouchDownX;
+                        centerY = slot.TouchDownY;
+                        slot.HasLastFrame = false;
+                    }
+
+                    // Calculate the delta between this action and the touch down point.
+                    float xDelta = pointerAction.CurrentX - centerX;
+                    float yDelta = pointerAction.CurrentY - centerY;
+
+                    // Enforce a circular limit for the controller stick.
+                    float magnitude = std::sqrt(xDelta*xDelta + yDelta*yDelta);
+
+                    // Move the thumbstick with the user's thumb.
+                    if (magnitude > POINTER_VIRTUAL_STICK_THROW_MAX)
+                    {
+                        // Compute how far out the user dragged the joystick.
+                        float magnitudeFactor = POINTER_VIRTUAL_STICK_THROW_MAX / magnitude;
+                        float temp1 = xDelta * magnitudeFactor;
+                        float temp2 = yDelta * magnitudeFactor;
+
+                        // Move the center by the same amount.
+                        centerX = slot.TouchDownX += xDelta - temp1;
+                        centerY = slot.TouchDownY += yDelta - temp2;
+
+                        // Reduce the "thrown" values to their max size.
+                        xDelta = temp1;
+                        yDelta = temp2;
+                    }
+
+                    float normalizedMagnitude = ComputeThumbstickMagnitudeFactor(
+                        xDelta,
+                        yDelta,
+                        (int) POINTER_VIRTUAL_STICK_DEADZONE,
+                        POINTER_VIRTUAL_STICK_THROW_MAX
+                        );
+
+                    // The stick's center and current "thrown" position for virtual controller rendering.
+                    playerInput.PointerRawX = centerX;
+                    playerInput.PointerRawY = centerY;
+                    playerInput.PointerThrowX = centerX + xDelta;
+                    playerInput.PointerThrowY = centerY + yDelta;
+
+                    // Normalized input data, as a physical joystick would report it.
+                    playerInput.X = normalizedMagnitude * xDelta / POINTER_VIRTUAL_STICK_THROW_MAX;
+                    // Y-value must be reversed to map pixel coordinate system to Xbox controller behaviors
+                    playerInput.Y = -(normalizedMagnitude * yDelta / POINTER_VIRTUAL_STICK_THROW_MAX);
+                    playerInput.NormalizedInputValue = 1.f;
+
+                    playerInput.PlayerAction = (region.DefinedAction == INPUT_AIM) ? INPUT_AIM : INPUT_MOVE;
+                    AddPlayerAction(playerInput);
+                }
+                else if (region.RegionType == TOUCH_CONTROL_REGION_BUTTON)
+                {
+                    // Virtual button was pressed.
+                    playerInput.PointerRawX = playerInput.X = pointerAction.CurrentX;
+                    playerInput.PointerRawY = playerInput.Y = pointerAction.CurrentY;
+
+                    // The action type is defined with the touch region.
+                    playerInput.PlayerAction = region.DefinedAction;
+                    playerInput.NormalizedInputValue = 1.f;
+                    AddPlayerAction(playerInput);
+                }
+
+                // NOTE TO DEVELOPERS: Add your own code for handling slide controls, etc. by adding more cases here.
+            }
+        }
+
+        // Converts mouse pointers into fire and coordinate actions.
+        void TranslateMousePointers()
+        {
+            for (unsigned int i = 0; i < INPUT_MAX_POINTERS; i++)
+            {
+                PointerSlot& slot = m_pointers[i];
+                if (!slot.InUse || !slot.HasThisFrame || !slot.ThisFrame.IsMouseEvent)
+                    continue;
+
+                // Enable the player ID for the default pointer player assignment.
+                m_playersSeen |= 1u << DEFAULT_POINTER_PLAYER_ID;
+
+                const PointerControllerAction& pointerAction = slot.ThisFrame;
+
+                // For mouse updates, the raw input coords and the returned x and y values are the same.
+                // This is different for "virtual" controls like the touch analog stick.
+                PlayerInputData playerInput;
+                playerInput.ID = DEFAULT_POINTER_PLAYER_ID;
+                playerInput.PointerRawX = playerInput.X = pointerAction.CurrentX;
+                playerInput.PointerRawY = playerInput.Y = pointerAction.CurrentY;
+
+                bool anyButton = pointerAction.IsLeftButtonPressed || pointerAction.IsMiddleButtonPressed || pointerAction.IsRightButtonPressed;
+                if (slot.HasLastFrame)
+                {
+                    // A pointer we are already watching.
+                    playerInput.PlayerAction = pointerAction.IsLeftButtonPressed ? INPUT_FIRE_DOWN : INPUT_FIRE_UP;
+                    playerInput.NormalizedInputValue = 1.0f;
+
+                    if (!anyButton)
+                    {
+                        // Not moved and no buttons: this pointer is done for now.
+                        if ((pointerAction.CurrentX == slot.LastFrame.CurrentX) && (pointerAction.CurrentY == slot.LastFrame.CurrentY))
+                        {
+                            slot.HasThisFrame = false;
+                            slot.HasLastFrame = false;
+                            continue;
+                        }
+
+                        // The coordinate data is what the game will be processing in this case.
+                        playerInput.NormalizedInputValue = 0.f;
+                        playerInput.PlayerAction = INPUT_COORDINATES_ONLY;
+                    }
+
+                    AddPlayerAction(playerInput);
+                    slot.HasLastFrame = false;
+                }
+                else if (pointerAction.IsLeftButtonPressed)
+                {
+                    // New action detected with left-click.
+                    playerInput.PlayerAction = INPUT_FIRE_DOWN;
+                    playerInput.NormalizedInputValue = 1.f;
+                    AddPlayerAction(playerInput);
+                }
+                else
+                {
+                    playerInput.PlayerAction = INPUT_COORDINATES_ONLY;
+                    playerInput.NormalizedInputValue = 0.f;
+                    AddPlayerAction(playerInput);
+                }
+            }
+
+            // Leftover pointers from last frame: a mouse button is still down, but the mouse has not moved.
+            for (unsigned int i = 0; i < INPUT_MAX_POINTERS; i++)
+            {
+                const PointerSlot& slot = m_pointers[i];
+                if (!slot.InUse || !slot.HasLastFrame || !slot.LastFrame.IsMouseEvent)
+                    continue;
+
+                PlayerInputData playerInput;
+                playerInput.ID = DEFAULT_POINTER_PLAYER_ID;
+                playerInput.PointerRawX = playerInput.X = slot.LastFrame.CurrentX;
+                playerInput.PointerRawY = playerInput.Y = slot.LastFrame.CurrentY;
+                playerInput.PlayerAction = slot.LastFrame.IsLeftButtonPressed ? INPUT_FIRE_DOWN : INPUT_FIRE_UP;
+                playerInput.NormalizedInputValue = 1.0f;
+                AddPlayerAction(playerInput);
+            }
+        }
+
+        InputEventQueue         m_events;
+
+        // Keyboard: one bit per virtual key held, and what each key does.
+        uint64_t                m_keysDown[INPUT_MAX_KEYS / 64];
+        KeyBinding              m_keyBindings[INPUT_MAX_KEYS];
+
+        // Pointers (mouse and touch), tracked by slot rather than pointer id.
+        PointerSlot             m_pointers[INPUT_MAX_POINTERS];
+        uint32_t                m_droppedPointers;
+
+        TouchRegionBounds       m_touchRegions[INPUT_MAX_TOUCH_REGIONS];
+        unsigned int            m_touchRegionCount;
+
+        GamepadState            m_gamepads[XINPUT_MAX_CONTROLLERS];
+        unsigned int            m_gamepadMask;      // Bits of the gamepads set for this frame.
+
+        unsigned int            m_playersSeen;
+        uint64_t                m_oldestEventTime;  // Of the events processed this frame, 0 if none.
+
+        // One bit per PLAYER_ACTION_TYPES value for each player: the actions
+        // taken this frame, and those taken last frame, for detecting
+        // state transitions.
+        uint32_t                m_actionsThisFrame[INPUT_MAX_PLAYERS];
+        uint32_t                m_actionsLastFrame[INPUT_MAX_PLAYERS];
+
+        // The merged data of each action taken this frame.
+        PlayerInputData         m_resolvedActionsThisFrame[INPUT_MAX_PLAYERS][INPUT_MAX];
+
+        // The last two frames' actions; m_currentFrame is the latest.
+        PlayerActions           m_frames[2];
+        unsigned int            m_currentFrame;
+    };
+
+#pragma endregion
+}
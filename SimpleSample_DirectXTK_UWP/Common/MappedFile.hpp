@@ -0,0 +1,122 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <cstddef>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A whole file mapped read-only into memory. The pages are loaded by the OS
+// on first touch and shared with the file cache, so opening costs a few
+// system calls however large the file is.
+class MappedFile
+{
+public:
+	MappedFile() : m_data(nullptr), m_size(0)
+#ifdef _WIN32
+		, m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+#endif
+	{
+	}
+
+	~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+#ifdef _WIN32
+	bool Open(const wchar_t* path)
+	{
+		Close();
+
+		m_file = CreateFile2(path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+		LARGE_INTEGER size;
+		if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+
+		m_mapping = CreateFileMappingFromApp(m_file, nullptr, PAGE_READONLY, 0, nullptr);
+		m_data = m_mapping ? MapViewOfFileFromApp(m_mapping, FILE_MAP_READ, 0, 0) : nullptr;
+		if (!m_data)
+		{
+			Close();
+			return false;
+		}
+
+		m_size = (size_t)size.QuadPart;
+		return true;
+	}
+
+	void Close()
+	{
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping)
+			CloseHandle(m_mapping);
+		if (m_file != INVALID_HANDLE_VALUE)
+			CloseHandle(m_file);
+
+		m_data = nullptr;
+		m_size = 0;
+		m_mapping = nullptr;
+		m_file = INVALID_HANDLE_VALUE;
+	}
+#else
+	bool Open(const char* path)
+	{
+		Close();
+
+		int file = open(path, O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat status;
+		if (fstat(file, &status) == 0 && status.st_size > 0)
+		{
+			void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (data != MAP_FAILED)
+			{
+				m_data = data;
+				m_size = (size_t)status.st_size;
+			}
+		}
+
+		// The mapping keeps the file alive.
+		close(file);
+		return m_data != nullptr;
+	}
+
+	void Close()
+	{
+		if (m_data)
+			munmap(m_data, m_size);
+
+		m_data = nullptr;
+		m_size = 0;
+	}
+#endif
+
+	const void* Data() const				{ return m_data; }
+	size_t Size() const						{ return m_size; }
+
+private:
+	void*			m_data;
+	size_t			m_size;
+#ifdef _WIN32
+	HANDLE			m_file;
+	HANDLE			m_mapping;
+#endif
+};
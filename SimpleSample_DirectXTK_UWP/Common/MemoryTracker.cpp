@@ -0,0 +1,11 @@
+﻿#include "pch.h"
+#include "..\Simulation\MemoryTracker.hpp"
+
+// Every heap allocation of the game is charged to a subsystem for the
+// memory report, and counted so Sample3DSceneRenderer can check in debug
+// builds that a steady-state tick makes none. Shipping builds (Release)
+// define SIMULATION_SHIPPING and keep the system operator new; textures
+// and budgets are still tracked there.
+#ifndef SIMULATION_SHIPPING
+SIMULATION_DEFINE_MEMORY_TRACKER
+#endif
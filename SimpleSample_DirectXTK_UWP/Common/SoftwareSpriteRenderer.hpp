@@ -0,0 +1,433 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "SpriteRenderer.hpp"
+#include "Simulation/JobSystem.hpp"
+#include "Simulation/Simd.hpp"
+
+// SpriteRenderer that rasterizes on the CPU into an RGBA buffer, so frames
+// can be drawn and compared on machines without a GPU, and the cost of
+// submitting sprites measured without a driver in the way.
+//
+// Sprites are kept until End, then binned into TileSize square tiles of
+// the screen; tiles are drawn in parallel on the JobSystem, each one
+// drawing its sprites in submission order. Every pixel is computed the
+// same way whichever tile or thread it falls to, so a frame comes out
+// bit for bit the same at any thread count.
+//
+// Sampling is point sampling at the pixel centre, where SpriteBatch's
+// default sampler is linear; blending is SpriteBatch's default, premultiplied
+// alpha: dst = src + dst * (1 - src.a). Rows are Stride pixels apart, a
+// multiple of 4, so the span loops always work on 4 whole pixels.
+
+// RGBA8 pixels, red in the lowest byte, rows top to bottom without padding.
+struct SoftwareTexture
+{
+	uint32_t				width;
+	uint32_t				height;
+	std::vector<uint32_t>	pixels;
+
+	SoftwareTexture() : width(0), height(0) {}
+};
+
+class SoftwareSpriteRenderer : public SpriteRenderer
+{
+public:
+	static const uint32_t TileSize = 64;
+
+	// jobs is not owned; null draws every tile on the calling thread.
+	SoftwareSpriteRenderer(uint32_t width, uint32_t height, Simulation::JobSystem* jobs = nullptr) :
+		m_jobs(jobs),
+		m_sampler(SpriteSampler_Clamp)
+	{
+		Resize(width, height);
+	}
+
+	void Resize(uint32_t width, uint32_t height)
+	{
+		m_width = width;
+		m_height = height;
+		m_stride = (width + 3) & ~3u;
+		m_tilesX = (width + TileSize - 1) / TileSize;
+		m_tilesY = (height + TileSize - 1) / TileSize;
+		m_pixels.assign((size_t)m_stride * height, 0);
+		m_bins.resize((size_t)m_tilesX * m_tilesY);
+	}
+
+	void SetJobSystem(Simulation::JobSystem* jobs)		{ m_jobs = jobs; }
+
+	void Clear(uint32_t rgba)
+	{
+		std::fill(m_pixels.begin(), m_pixels.end(), rgba);
+	}
+
+	void Begin(SpriteSampler sampler = SpriteSampler_Clamp) override
+	{
+		m_sampler = sampler;
+		m_sprites.clear();
+	}
+
+	// The texture handle is a SoftwareTexture.
+	void Draw(const SpriteDraw& sprite) override
+	{
+		const SoftwareTexture* texture = static_cast<const SoftwareTexture*>(sprite.texture);
+		float width = (float)(sprite.source.right - sprite.source.left);
+		float height = (float)(sprite.source.bottom - sprite.source.top);
+		if (!texture || texture->width == 0 || texture->height == 0 || width <= 0.f || height <= 0.f ||
+			sprite.scaleX == 0.f || sprite.scaleY == 0.f)
+			return;
+
+		Setup setup;
+		setup.texture = texture;
+		setup.left = sprite.source.left;
+		setup.top = sprite.source.top;
+		setup.width = width;
+		setup.height = height;
+		setup.color = PackColor(sprite.color);
+
+		// Sources within the texture, the usual case, are read without addressing.
+		setup.direct = sprite.source.left >= 0 && sprite.source.top >= 0 &&
+			sprite.source.right <= (int32_t)texture->width && sprite.source.bottom <= (int32_t)texture->height &&
+			texture->width < 32768 && texture->height < 32768;
+		setup.base = setup.direct ? texture->pixels.data() + (size_t)sprite.source.top * texture->width + sprite.source.left : nullptr;
+
+		// Screen to source: undo the rotation, the scale and the origin, at pixel centres.
+		float c = sprite.rotation != 0.f ? std::cos(sprite.rotation) : 1.f;
+		float s = sprite.rotation != 0.f ? std::sin(sprite.rotation) : 0.f;
+		float cx = 0.5f - sprite.x;
+		float cy = 0.5f - sprite.y;
+		setup.dudx = c / sprite.scaleX;
+		setup.dudy = s / sprite.scaleX;
+		setup.u0 = sprite.originX + (c * cx + s * cy) / sprite.scaleX;
+		setup.dvdx = -s / sprite.scaleY;
+		setup.dvdy = c / sprite.scaleY;
+		setup.v0 = sprite.originY + (c * cy - s * cx) / sprite.scaleY;
+
+		// Screen bounds of the four corners.
+		float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+		for (int corner = 0; corner < 4; corner++)
+		{
+			float u = ((corner & 1) ? width : 0.f) - sprite.originX;
+			float v = ((corner & 2) ? height : 0.f) - sprite.originY;
+			float x = sprite.x + c * u * sprite.scaleX - s * v * sprite.scaleY;
+			float y = sprite.y + s * u * sprite.scaleX + c * v * sprite.scaleY;
+			minX = (std::min)(minX, x);
+			minY = (std::min)(minY, y);
+			maxX = (std::max)(maxX, x);
+			maxY = (std::max)(maxY, y);
+		}
+
+		setup.minX = (int32_t)(std::max)(std::floor(minX), 0.f);
+		setup.minY = (int32_t)(std::max)(std::floor(minY), 0.f);
+		setup.maxX = (int32_t)(std::min)(std::ceil(maxX), (float)m_width);
+		setup.maxY = (int32_t)(std::min)(std::ceil(maxY), (float)m_height);
+		if (setup.minX >= setup.maxX || setup.minY >= setup.maxY)
+			return;
+
+		m_sprites.push_back(setup);
+	}
+
+	void End() override
+	{
+		if (m_sprites.empty())
+			return;
+
+		for (auto& bin : m_bins)
+		{
+			bin.clear();
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)m_sprites.size(); i++)
+		{
+			const Setup& sprite = m_sprites[i];
+			uint32_t tileMaxX = (uint32_t)(sprite.maxX - 1) / TileSize;
+			uint32_t tileMaxY = (uint32_t)(sprite.maxY - 1) / TileSize;
+			for (uint32_t ty = (uint32_t)sprite.minY / TileSize; ty <= tileMaxY; ty++)
+			{
+				for (uint32_t tx = (uint32_t)sprite.minX / TileSize; tx <= tileMaxX; tx++)
+				{
+					m_bins[ty * m_tilesX + tx].push_back(i);
+				}
+			}
+		}
+
+		auto drawTiles = [this](size_t begin, size_t end)
+		{
+			for (size_t tile = begin; tile < end; tile++)
+			{
+				DrawTile(tile);
+			}
+		};
+
+		if (m_jobs)
+		{
+			m_jobs->ParallelFor(m_bins.size(), 1, drawTiles);
+		}
+		else
+		{
+			drawTiles(0, m_bins.size());
+		}
+
+		m_sprites.clear();
+	}
+
+	uint32_t GetWidth() const							{ return m_width; }
+	uint32_t GetHeight() const							{ return m_height; }
+	uint32_t GetStride() const							{ return m_stride; }
+	const uint32_t* GetPixels() const					{ return m_pixels.data(); }
+
+private:
+	// A sprite ready for drawing: source coordinates u, v in texels from
+	// the top left of the source rectangle are linear in the pixel x, y.
+	struct Setup
+	{
+		const SoftwareTexture*	texture;
+		int32_t					left;
+		int32_t					top;
+		float					width;
+		float					height;
+		bool					direct;						// Source within the texture,
+		const uint32_t*			base;						// whose top left texel is here.
+		float					u0, dudx, dudy;
+		float					v0, dvdx, dvdy;
+		int32_t					minX, minY, maxX, maxY;		// Screen bounds, max exclusive.
+		uint32_t				color;
+	};
+
+	static uint32_t PackColor(const SpriteColor& color)
+	{
+		auto channel = [](float value) { return (uint32_t)((std::min)((std::max)(value, 0.f), 1.f) * 255.f + 0.5f); };
+		return channel(color.r) | channel(color.g) << 8 | channel(color.b) << 16 | channel(color.a) << 24;
+	}
+
+	// x * y / 255 rounded, for x and y in [0, 255].
+	static uint32_t Mul255(uint32_t x, uint32_t y)
+	{
+		uint32_t t = x * y + 128;
+		return (t + (t >> 8)) >> 8;
+	}
+
+	uint32_t Fetch(const Setup& sprite, int32_t u, int32_t v) const
+	{
+		const SoftwareTexture& texture = *sprite.texture;
+		int32_t x = sprite.left + u;
+		int32_t y = sprite.top + v;
+		if (m_sampler == SpriteSampler_Wrap)
+		{
+			x %= (int32_t)texture.width;
+			y %= (int32_t)texture.height;
+			x += x < 0 ? (int32_t)texture.width : 0;
+			y += y < 0 ? (int32_t)texture.height : 0;
+		}
+		else
+		{
+			x = (std::min)((std::max)(x, 0), (int32_t)texture.width - 1);
+			y = (std::min)((std::max)(y, 0), (int32_t)texture.height - 1);
+		}
+		return texture.pixels[(size_t)y * texture.width + x];
+	}
+
+	// Pixels [begin, end) of a row where the sprite may be: where both u
+	// and v are within the source, widened by a pixel for rounding. The
+	// span loop tests every pixel, this only skips the ones surely outside.
+	static void ClipSpan(float rowStart, float step, float size, int32_t& begin, int32_t& end)
+	{
+		if (step == 0.f)
+		{
+			if (!(rowStart >= 0.f && rowStart < size))
+			{
+				end = begin;
+			}
+			return;
+		}
+
+		float a = -rowStart / step;
+		float b = (size - rowStart) / step;
+		float low = (std::min)(a, b) - 1.f;
+		float high = (std::max)(a, b) + 1.f;
+		if (low > (float)begin)
+		{
+			begin = low < (float)end ? (int32_t)low : end;
+		}
+		if (high < (float)end)
+		{
+			end = high > (float)begin ? (int32_t)high + 1 : begin;
+		}
+	}
+
+	void DrawTile(size_t tile)
+	{
+		int32_t tileX = (int32_t)((tile % m_tilesX) * TileSize);
+		int32_t tileY = (int32_t)((tile / m_tilesX) * TileSize);
+		int32_t tileRight = (std::min)(tileX + (int32_t)TileSize, (int32_t)m_width);
+		int32_t tileBottom = (std::min)(tileY + (int32_t)TileSize, (int32_t)m_height);
+
+		for (uint32_t index : m_bins[tile])
+		{
+			const Setup& sprite = m_sprites[index];
+			int32_t top = (std::max)(sprite.minY, tileY);
+			int32_t bottom = (std::min)(sprite.maxY, tileBottom);
+
+			for (int32_t y = top; y < bottom; y++)
+			{
+				float rowU = sprite.u0 + sprite.dudy * (float)y;
+				float rowV = sprite.v0 + sprite.dvdy * (float)y;
+
+				int32_t begin = (std::max)(sprite.minX, tileX);
+				int32_t end = (std::min)(sprite.maxX, tileRight);
+				ClipSpan(rowU, sprite.dudx, sprite.width, begin, end);
+				ClipSpan(rowV, sprite.dvdx, sprite.height, begin, end);
+				if (begin < end)
+				{
+					DrawSpan(sprite, rowU, rowV, begin, end, m_pixels.data() + (size_t)y * m_stride);
+				}
+			}
+		}
+	}
+
+	// Draws pixels [begin, end) of row, 4 at a time from a multiple of 4.
+	// Lanes outside [begin, end) or outside the sprite keep the destination,
+	// so the result does not depend on where a span starts or ends.
+	void DrawSpan(const Setup& sprite, float rowU, float rowV, int32_t begin, int32_t end, uint32_t* row) const
+	{
+		bool tinted = sprite.color != 0xffffffffu;
+
+#if SIMULATION_USE_SSE2
+		const __m128 step = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 width = _mm_set1_ps(sprite.width);
+		const __m128 height = _mm_set1_ps(sprite.height);
+		const __m128i zeroi = _mm_setzero_si128();
+		const __m128i round = _mm_set1_epi16(128);
+		const __m128i full = _mm_set1_epi16(255);
+		const __m128i tint = _mm_unpacklo_epi8(_mm_set1_epi32((int)sprite.color), zeroi);
+		const __m128i lane = _mm_set_epi32(3, 2, 1, 0);
+		const __m128i first = _mm_set1_epi32(begin);
+		const __m128i last = _mm_set1_epi32(end);
+		const __m128i rgb = _mm_set1_epi32(0x00ffffff);
+		const __m128i pitch = _mm_set1_epi32((int)(sprite.texture->width << 16 | 1));
+
+		// x * y / 255 rounded, on 16 bit lanes.
+		auto mul255 = [&](__m128i x, __m128i y)
+		{
+			__m128i t = _mm_add_epi16(_mm_mullo_epi16(x, y), round);
+			return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+		};
+		auto alpha = [](__m128i x)
+		{
+			return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xff), 0xff);
+		};
+
+		for (int32_t x = begin & ~3; x < end; x += 4)
+		{
+			__m128 fx = _mm_add_ps(_mm_set1_ps((float)x), step);
+			__m128 u = _mm_add_ps(_mm_set1_ps(rowU), _mm_mul_ps(_mm_set1_ps(sprite.dudx), fx));
+			__m128 v = _mm_add_ps(_mm_set1_ps(rowV), _mm_mul_ps(_mm_set1_ps(sprite.dvdx), fx));
+
+			__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmplt_ps(u, width)),
+				_mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmplt_ps(v, height)));
+			__m128i xs = _mm_add_epi32(_mm_set1_epi32(x), lane);
+			__m128i inSpan = _mm_andnot_si128(_mm_cmplt_epi32(xs, first), _mm_cmplt_epi32(xs, last));
+			__m128i mask = _mm_and_si128(_mm_castps_si128(inside), inSpan);
+
+			int bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+			if (bits == 0)
+				continue;
+
+			__m128i us = _mm_cvttps_epi32(u);
+			__m128i vs = _mm_cvttps_epi32(v);
+			__m128i src;
+			if (sprite.direct)
+			{
+				// v * width + u as 16 bit pairs; lanes outside the sprite read the first texel.
+				__m128i uv = _mm_and_si128(_mm_or_si128(us, _mm_slli_epi32(vs, 16)), mask);
+				__m128i index = _mm_madd_epi16(uv, pitch);
+				src = _mm_set_epi32((int)sprite.base[_mm_cvtsi128_si32(_mm_shuffle_epi32(index, 3))],
+					(int)sprite.base[_mm_cvtsi128_si32(_mm_shuffle_epi32(index, 2))],
+					(int)sprite.base[_mm_cvtsi128_si32(_mm_shuffle_epi32(index, 1))],
+					(int)sprite.base[_mm_cvtsi128_si32(index)]);
+			}
+			else
+			{
+				alignas(16) int32_t uIndex[4];
+				alignas(16) int32_t vIndex[4];
+				_mm_store_si128((__m128i*)uIndex, us);
+				_mm_store_si128((__m128i*)vIndex, vs);
+				uint32_t texels[4];
+				for (int i = 0; i < 4; i++)
+				{
+					texels[i] = (bits >> i) & 1 ? Fetch(sprite, uIndex[i], vIndex[i]) : 0;
+				}
+				src = _mm_set_epi32((int)texels[3], (int)texels[2], (int)texels[1], (int)texels[0]);
+			}
+
+			__m128i dst = _mm_loadu_si128((const __m128i*)(row + x));
+
+			// Opaque texels replace the destination; the inside of most sprites is.
+			if (!tinted && _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_or_si128(src, rgb), _mm_cmpeq_epi32(src, src))) == 0xffff)
+			{
+				_mm_storeu_si128((__m128i*)(row + x), _mm_or_si128(_mm_and_si128(mask, src), _mm_andnot_si128(mask, dst)));
+				continue;
+			}
+
+			__m128i srcLo = _mm_unpacklo_epi8(src, zeroi);
+			__m128i srcHi = _mm_unpackhi_epi8(src, zeroi);
+			if (tinted)
+			{
+				srcLo = mul255(srcLo, tint);
+				srcHi = mul255(srcHi, tint);
+			}
+
+			__m128i dstLo = _mm_add_epi16(srcLo, mul255(_mm_unpacklo_epi8(dst, zeroi), _mm_sub_epi16(full, alpha(srcLo))));
+			__m128i dstHi = _mm_add_epi16(srcHi, mul255(_mm_unpackhi_epi8(dst, zeroi), _mm_sub_epi16(full, alpha(srcHi))));
+			__m128i blended = _mm_packus_epi16(dstLo, dstHi);
+
+			__m128i result = _mm_or_si128(_mm_and_si128(mask, blended), _mm_andnot_si128(mask, dst));
+			_mm_storeu_si128((__m128i*)(row + x), result);
+		}
+#else
+		for (int32_t x = begin; x < end; x++)
+		{
+			float u = rowU + sprite.dudx * (float)x;
+			float v = rowV + sprite.dvdx * (float)x;
+			if (!(u >= 0.f && u < sprite.width && v >= 0.f && v < sprite.height))
+				continue;
+
+			uint32_t src = Fetch(sprite, (int32_t)u, (int32_t)v);
+			uint32_t dst = row[x];
+			uint32_t srcA = tinted ? Mul255(src >> 24, sprite.color >> 24) : src >> 24;
+			uint32_t result = 0;
+			for (int shift = 0; shift < 32; shift += 8)
+			{
+				uint32_t s = (src >> shift) & 0xff;
+				if (tinted)
+				{
+					s = Mul255(s, (sprite.color >> shift) & 0xff);
+				}
+				uint32_t d = s + Mul255((dst >> shift) & 0xff, 255 - srcA);
+				result |= (std::min)(d, 255u) << shift;
+			}
+			row[x] = result;
+		}
+#endif
+	}
+
+	Simulation::JobSystem*						m_jobs;
+	SpriteSampler								m_sampler;
+	uint32_t									m_width;
+	uint32_t									m_height;
+	uint32_t									m_stride;
+	uint32_t									m_tilesX;
+	uint32_t									m_tilesY;
+	std::vector<uint32_t>						m_pixels;
+
+	std::vector<Setup>							m_sprites;			// Since Begin.
+	std::vector<std::vector<uint32_t>>			m_bins;				// Sprite indices per tile, in submission order.
+};
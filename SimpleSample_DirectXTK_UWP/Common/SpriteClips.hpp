@@ -0,0 +1,89 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "SpriteSheetData.hpp"
+#include "Simulation/Animation.hpp"
+
+// Animation clips built from the frame names of a sprite sheet, so playback
+// works on frame indices and never touches a string. The clips go into a
+// Simulation::AnimationClips table, named by clip, with the sheet's frame
+// indices as their frame ids. Two naming schemes are recognised:
+//
+//   numbered    a name ending in a 4 digit, zero padded frame number, as
+//               exported by TexturePacker and most animation tools:
+//               alien10001 ... alien10015 is clip "alien1", 15 frames.
+//   variants    a name ending in a digit and the same name with one extra
+//               capital letter: F5S1, F5S1N is clip "F5S1", 2 frames.
+//
+// Frames of a numbered clip are ordered by number, gaps are skipped. Names
+// matching neither scheme, or forming a single frame, get no clip. Clips
+// are added in name order, looping at framesPerSecond; returns how many.
+inline size_t BuildSpriteClips(const SpriteSheetView& sheet, float framesPerSecond, Simulation::AnimationClips& clips)
+{
+	const size_t NumberDigits = 4;
+
+	// Clip name -> (frame number, frame index). Variants use 0 for the base and 1 for the variant.
+	std::map<std::string, std::vector<std::pair<uint32_t, uint32_t>>> groups;
+
+	for (uint32_t i = 0; i < sheet.GetFrameCount(); i++)
+	{
+		const char* name = sheet.GetName(i);
+		size_t length = std::strlen(name);
+
+		size_t digits = 0;
+		while (digits < length && std::isdigit((unsigned char)name[length - 1 - digits]))
+			digits++;
+
+		if (digits >= NumberDigits && length > NumberDigits)
+		{
+			uint32_t number = (uint32_t)std::atoi(name + length - NumberDigits);
+			groups[std::string(name, length - NumberDigits)].push_back(std::make_pair(number, i));
+			continue;
+		}
+
+		if (length >= 2 && std::isupper((unsigned char)name[length - 1]) && std::isdigit((unsigned char)name[length - 2]))
+		{
+			std::string base(name, length - 1);
+			uint32_t baseIndex = sheet.FindIndex(base.data(), base.size());
+			if (baseIndex != SpriteSheetEmptyBucket)
+			{
+				auto& group = groups[base];
+				if (group.empty())
+				{
+					group.push_back(std::make_pair(0u, baseIndex));
+				}
+				group.push_back(std::make_pair((uint32_t)(name[length - 1] - 'A' + 1), i));
+			}
+		}
+	}
+
+	size_t added = 0;
+	std::vector<uint32_t> frames;
+	for (auto& group : groups)
+	{
+		if (group.second.size() < 2)
+			continue;
+
+		std::sort(group.second.begin(), group.second.end());
+
+		frames.clear();
+		for (auto& frame : group.second)
+		{
+			frames.push_back(frame.second);
+		}
+		clips.Add(group.first.c_str(), frames.data(), (uint32_t)frames.size(), framesPerSecond);
+		added++;
+	}
+	return added;
+}
@@ -0,0 +1,81 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <cstdint>
+
+// What the Content classes draw sprites with. A backend takes sprites
+// between Begin and End and draws them in the order they were submitted,
+// like SpriteBatch in its deferred sort mode:
+//
+//   SpriteBatchRenderer      SpriteBatch on the D3D11 device (Content)
+//   SoftwareSpriteRenderer   CPU rasterizer into an RGBA buffer, for tools
+//                            and machines without a GPU
+//
+// The geometry is SpriteBatch's: the source rectangle, in texels, is
+// placed with origin at position, scaled and then rotated about origin.
+// A texture is the backend's own handle: an ID3D11ShaderResourceView for
+// SpriteBatchRenderer, a SoftwareTexture for SoftwareSpriteRenderer.
+
+enum SpriteSampler
+{
+	SpriteSampler_Clamp,		// Texture coordinates stop at the edges of the texture.
+	SpriteSampler_Wrap			// The texture repeats; source rectangles may run past it.
+};
+
+struct SpriteRect
+{
+	int32_t		left;
+	int32_t		top;
+	int32_t		right;
+	int32_t		bottom;
+
+	SpriteRect() : left(0), top(0), right(0), bottom(0) {}
+	SpriteRect(int32_t _left, int32_t _top, int32_t _right, int32_t _bottom) : left(_left), top(_top), right(_right), bottom(_bottom) {}
+};
+
+struct SpriteColor
+{
+	float		r;
+	float		g;
+	float		b;
+	float		a;
+
+	SpriteColor() : r(1.f), g(1.f), b(1.f), a(1.f) {}
+	SpriteColor(float _r, float _g, float _b, float _a = 1.f) : r(_r), g(_g), b(_b), a(_a) {}
+};
+
+struct SpriteDraw
+{
+	void*		texture;
+	SpriteRect	source;
+	float		x;
+	float		y;
+	float		originX;		// Texels from the top left of source.
+	float		originY;
+	float		scaleX;
+	float		scaleY;
+	float		rotation;		// Radians, clockwise on screen.
+	SpriteColor	color;			// Multiplies the texture; white leaves it as it is.
+	float		depth;			// Passed on; deferred drawing keeps submission order.
+
+	// The whole of source at x, y, unscaled and untinted.
+	SpriteDraw(void* _texture, const SpriteRect& _source, float _x, float _y) :
+		texture(_texture), source(_source), x(_x), y(_y), originX(0.f), originY(0.f),
+		scaleX(1.f), scaleY(1.f), rotation(0.f), depth(0.f)
+	{
+	}
+};
+
+class SpriteRenderer
+{
+public:
+	virtual ~SpriteRenderer() {}
+
+	virtual void Begin(SpriteSampler sampler = SpriteSampler_Clamp) = 0;
+	virtual void Draw(const SpriteDraw& sprite) = 0;
+
+	// Sprites since Begin are drawn by the time End returns.
+	virtual void End() = 0;
+};
@@ -16,12 +16,16 @@
 #pragma once
 
 #include <exception>
-#include <fstream>
-#include <map>
 #include <string>
+#include <vector>
 #include <SpriteBatch.h>
 #include <wrl.h>
 
+#include "DrawStats.hpp"
+#include "MappedFile.hpp"
+#include "SpriteClips.hpp"
+#include "SpriteSheetData.hpp"
+
 
 class SpriteSheet
 {
@@ -34,124 +38,93 @@ public:
         bool                rotated;
     };
 
+    // szFileName is either TexturePacker .txt data or a binary sheet made from
+    // it by SpriteSheetConverter. Binary sheets are mapped, not parsed; .txt
+    // data is converted to the same layout in memory, so both are looked up
+    // the same way.
     void Load( ID3D11ShaderResourceView* texture, const wchar_t* szFileName )
     {
-        mSprites.clear();
+        mView = SpriteSheetView();
+        mFile.Close();
+        mData.clear();
 
         mTexture = texture;
 
         if (szFileName)
         {
-            //
-            // This code parses the 'MonoGame' project txt file that is produced by CodeAndWeb's TexturePacker.
-            // https://www.codeandweb.com/texturepacker
-            //
-            // You can modify it to match whatever sprite-sheet tool you are using
-            //
-
-            std::wifstream inFile( szFileName );
-            if( !inFile )
-                throw std::exception( "SpriteSheet failed to load .txt data" );
-
-            wchar_t strLine[1024];
-            for(;;)
+            if ( !mFile.Open(szFileName) )
+                throw std::exception( "SpriteSheet failed to load sheet data" );
+
+            if ( !SpriteSheetView::HasMagic(mFile.Data(), mFile.Size()) )
             {
-                inFile >> strLine;
-                if( !inFile )
-                    break;
-
-                if( 0 == wcscmp( strLine, L"#" ) )
-                {
-                    // Comment
-                }
-                else
-                {
-                    // Parse lines of form: Name;rotatedInt;xInt;yInt;widthInt;heightInt;origWidthInt;origHeightInt;offsetXFloat;offsetYFloat
-                    static const wchar_t* delim = L";\n";
-
-                    wchar_t* context = nullptr;
-                    wchar_t* name = wcstok_s(strLine, delim, &context);
-                    if ( !name || !*name )
-                        throw std::exception("SpriteSheet encountered invalid .txt data");
-
-                    if ( mSprites.find( name ) != mSprites.cend() )
-                        throw std::exception("SpriteSheet encountered duplicate in .txt data");
-
-                    wchar_t* str = wcstok_s(nullptr, delim, &context);
-                    if ( !str )
-                        throw std::exception("SpriteSheet encountered invalid .txt data");
-
-                    SpriteFrame frame;
-                    frame.rotated = (_wtoi(str) == 1);
-
-                    str = wcstok_s(nullptr, delim, &context);
-                    if ( !str )
-                        throw std::exception("SpriteSheet encountered invalid .txt data");
-                    frame.sourceRect.left = _wtol(str);
-
-                    str = wcstok_s(nullptr, delim, &context);
-                    if ( !str )
-                        throw std::exception("SpriteSheet encountered invalid .txt data");
-                    frame.sourceRect.top = _wtol(str);
-
-                    str = wcstok_s(nullptr, delim, &context);
-                    if ( !str )
-                        throw std::exception("SpriteSheet encountered invalid .txt data");
-                    LONG dx = _wtol(str);
-                    frame.sourceRect.right = frame.sourceRect.left + dx;
-
-                    str = wcstok_s(nullptr, delim, &context);
-                    if ( !str )
-                        throw std::exception("SpriteSheet encountered invalid .txt data");
-                    LONG dy = + _wtol(str);
-                    frame.sourceRect.bottom = frame.sourceRect.top + dy;
-
-                    str = wcstok_s(nullptr, delim, &context);
-                    if ( !str )
-                        throw std::exception("SpriteSheet encountered invalid .txt data");
-                    frame.size.x = static_cast<float>( _wtof(str) );
-
-                    str = wcstok_s(nullptr, delim, &context);
-                    if ( !str )
-                        throw std::exception("SpriteSheet encountered invalid .txt data");
-                    frame.size.y = static_cast<float>( _wtof(str) );
-
-                    str = wcstok_s(nullptr, delim, &context);
-                    if ( !str )
-                        throw std::exception("SpriteSheet encountered invalid .txt data");
-                    float pivotX = static_cast<float>( _wtof(str) );
-
-                    str = wcstok_s(nullptr, delim, &context);
-                    if ( !str )
-                        throw std::exception("SpriteSheet encountered invalid .txt data");
-                    float pivotY = static_cast<float>( _wtof(str) );
-
-                    if (frame.rotated)
-                    {
-                        frame.origin.x = dx * (1.f - pivotY);
-                        frame.origin.y = dy * pivotX;
-                    }
-                    else
-                    {
-                        frame.origin.x = dx * pivotX;
-                        frame.origin.y = dy * pivotY;
-                    }
-
-                    mSprites.insert( std::pair<std::wstring,SpriteFrame>( std::wstring(name), frame) );
-                }
-
-                inFile.ignore( 1000, '\n' );
+                //
+                // This parses the 'MonoGame' project txt file that is produced by CodeAndWeb's TexturePacker.
+                // https://www.codeandweb.com/texturepacker
+                //
+                // You can modify ParseSpriteSheetText to match whatever sprite-sheet tool you are using
+                //
+                std::vector<SpriteSheetEntry> entries;
+                std::string error;
+                if ( !ParseSpriteSheetText((const char*)mFile.Data(), mFile.Size(), entries, error) )
+                    throw std::exception( "SpriteSheet encountered invalid .txt data" );
+
+                mData = BuildSpriteSheetFile(entries);
+                mFile.Close();
             }
+
+            const void* data = mData.empty() ? mFile.Data() : mData.data();
+            size_t size = mData.empty() ? mFile.Size() : mData.size();
+            if ( !mView.Open(data, size) )
+                throw std::exception( "SpriteSheet encountered invalid binary data" );
         }
     }
 
-    const SpriteFrame* Find(const wchar_t* name) const
+    // Frames are numbered 0 to GetFrameCount() - 1 in sheet order. Look ids
+    // up once, at load time, and use GetFrame on the hot path.
+    typedef uint32_t SpriteId;
+    static const SpriteId InvalidSpriteId = SpriteSheetEmptyBucket;
+
+    SpriteId GetId(const wchar_t* name) const
+    {
+        return mView.FindIndex(name);
+    }
+
+    uint32_t GetFrameCount() const
+    {
+        return mView.GetFrameCount();
+    }
+
+    // Copies the frame out of the mapped sheet, whose layout is not SpriteFrame's.
+    SpriteFrame GetFrame(SpriteId id) const
+    {
+        assert(id < mView.GetFrameCount());
+        const SpriteSheetFileFrame& data = mView.GetFrame(id);
+
+        SpriteFrame frame;
+        frame.sourceRect.left = data.left;
+        frame.sourceRect.top = data.top;
+        frame.sourceRect.right = data.right;
+        frame.sourceRect.bottom = data.bottom;
+        frame.size = DirectX::XMFLOAT2(data.sizeX, data.sizeY);
+        frame.origin = DirectX::XMFLOAT2(data.originX, data.originY);
+        frame.rotated = data.rotated != 0;
+        return frame;
+    }
+
+    // Adds the sheet's clips to clips, with the frame ids GetFrame takes (see SpriteClips.hpp).
+    size_t BuildClips(float framesPerSecond, Simulation::AnimationClips& clips) const
+    {
+        return BuildSpriteClips(mView, framesPerSecond, clips);
+    }
+
+    bool Find(const wchar_t* name, SpriteFrame& frame) const
     {
-        auto it = mSprites.find(name);
-        if (it == mSprites.cend())
-            return nullptr;
+        SpriteId id = GetId(name);
+        if (id == InvalidSpriteId)
+            return false;
 
-        return &it->second;
+        frame = GetFrame(id);
+        return true;
     }
 
     // Draw overloads specifying position and scale as XMFLOAT2.
@@ -179,6 +152,7 @@ public:
         case SpriteEffects_FlipVertically:      origin.y = frame.sourceRect.bottom - frame.sourceRect.top - origin.y; break;
         }
 
+        DrawStats::Get().Note(mTexture.Get());
         batch->Draw(mTexture.Get(), position, &frame.sourceRect, color, rotation, origin, scale, effects, layerDepth );
     }
 
@@ -207,6 +181,7 @@ public:
         case SpriteEffects_FlipVertically:      origin.y = frame.sourceRect.bottom - frame.sourceRect.top - origin.y; break;
         }
 
+        DrawStats::Get().Note(mTexture.Get());
         batch->Draw(mTexture.Get(), position, &frame.sourceRect, color, rotation, origin, scale, effects, layerDepth );
     }
 
@@ -236,6 +211,7 @@ public:
         }
         XMVECTOR vorigin = XMLoadFloat2(&origin);
 
+        DrawStats::Get().Note(mTexture.Get());
         batch->Draw(mTexture.Get(), position, &frame.sourceRect, color, rotation, vorigin, scale, effects, layerDepth );
     }
 
@@ -264,6 +240,7 @@ public:
         }
         XMVECTOR vorigin = XMLoadFloat2(&origin);
 
+        DrawStats::Get().Note(mTexture.Get());
         batch->Draw(mTexture.Get(), position, &frame.sourceRect, color, rotation, vorigin, scale, effects, layerDepth );
     }
 
@@ -292,10 +269,13 @@ public:
         case SpriteEffects_FlipVertically:      origin.y = frame.sourceRect.bottom - frame.sourceRect.top - origin.y; break;
         }
 
+        DrawStats::Get().Note(mTexture.Get());
         batch->Draw(mTexture.Get(), destinationRectangle, &frame.sourceRect, color, rotation, origin, effects, layerDepth );
     }
 
 private:
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>    mTexture;
-    std::map<std::wstring, SpriteFrame>                 mSprites;
+    MappedFile                                          mFile;
+    std::vector<uint8_t>                                mData;
+    SpriteSheetView                                     mView;
 };
@@ -0,0 +1,358 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Binary sprite sheet format. A sheet is one block of little endian data
+// laid out the way it is used, so loading is mapping the file and checking
+// the header; no text is parsed and nothing is allocated per frame.
+//
+//   header    SpriteSheetFileHeader
+//   frames    SpriteSheetFileFrame[frameCount], in source order
+//   buckets   uint32_t[bucketCount], frame index or EmptyBucket; an open
+//             addressing hash table over the frame names (linear probing,
+//             FNV-1a, at most half full)
+//   names     UTF-8 frame names, each followed by a 0
+//
+// SpriteSheetView looks frames up in a mapped sheet. ParseSpriteSheetText
+// reads TexturePacker 'MonoGame' .txt data and BuildSpriteSheetFile turns
+// it into the binary form (see Tools\SpriteSheetConverter).
+
+struct SpriteSheetFileHeader
+{
+	char		magic[4];
+	uint32_t	version;
+	uint32_t	frameCount;
+	uint32_t	bucketCount;
+	uint32_t	framesOffset;
+	uint32_t	bucketsOffset;
+	uint32_t	namesOffset;
+	uint32_t	fileSize;
+};
+
+// SpriteSheet::GetFrame copies the first 36 bytes into a SpriteSheet::SpriteFrame.
+struct SpriteSheetFileFrame
+{
+	int32_t		left;
+	int32_t		top;
+	int32_t		right;
+	int32_t		bottom;
+	float		sizeX;
+	float		sizeY;
+	float		originX;
+	float		originY;
+	uint8_t		rotated;
+	uint8_t		padding[3];
+	uint32_t	nameOffset;
+	uint32_t	nameLength;
+	uint32_t	nameHash;
+};
+
+static_assert(sizeof(SpriteSheetFileHeader) == 32, "SpriteSheetFileHeader is part of the file format");
+static_assert(sizeof(SpriteSheetFileFrame) == 48, "SpriteSheetFileFrame is part of the file format");
+
+const uint32_t SpriteSheetFileVersion = 1;
+const uint32_t SpriteSheetEmptyBucket = 0xffffffffu;
+
+// FNV-1a over the UTF-8 bytes of a name.
+inline uint32_t SpriteSheetHash(const char* name, size_t length)
+{
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+	}
+	return hash;
+}
+
+// UTF-8 encoding of a wide name, as stored in the file. Each wchar_t is
+// taken as one code point, so names outside the BMP are not supported.
+inline size_t SpriteSheetEncodeName(const wchar_t* name, char* out, size_t capacity)
+{
+	size_t length = 0;
+	for (; *name; name++)
+	{
+		uint32_t c = (uint32_t)*name;
+		char bytes[4];
+		size_t count;
+		if (c < 0x80)			{ bytes[0] = (char)c; count = 1; }
+		else if (c < 0x800)		{ bytes[0] = (char)(0xc0 | (c >> 6)); bytes[1] = (char)(0x80 | (c & 0x3f)); count = 2; }
+		else					{ bytes[0] = (char)(0xe0 | ((c >> 12) & 0x0f)); bytes[1] = (char)(0x80 | ((c >> 6) & 0x3f)); bytes[2] = (char)(0x80 | (c & 0x3f)); count = 3; }
+
+		if (length + count > capacity)
+			return (size_t)-1;
+
+		std::memcpy(out + length, bytes, count);
+		length += count;
+	}
+	return length;
+}
+
+// Read-only access to a sheet in memory, usually a mapped file that must
+// outlive the view.
+class SpriteSheetView
+{
+public:
+	SpriteSheetView() : m_header(nullptr), m_frames(nullptr), m_buckets(nullptr), m_names(nullptr) {}
+
+	static bool HasMagic(const void* data, size_t size)
+	{
+		return data && size >= 4 && std::memcmp(data, "PGSS", 4) == 0;
+	}
+
+	// Checks that the header and every frame stay inside size bytes and that
+	// every rotated flag is 0 or 1; false leaves the view closed.
+	bool Open(const void* data, size_t size)
+	{
+		*this = SpriteSheetView();
+
+		if (!HasMagic(data, size) || size < sizeof(SpriteSheetFileHeader) || ((uintptr_t)data & 3) != 0)
+			return false;
+
+		const uint8_t* bytes = (const uint8_t*)data;
+		const SpriteSheetFileHeader* header = (const SpriteSheetFileHeader*)bytes;
+		uint64_t frameBytes = (uint64_t)header->frameCount * sizeof(SpriteSheetFileFrame);
+		uint64_t bucketBytes = (uint64_t)header->bucketCount * sizeof(uint32_t);
+
+		if (header->version != SpriteSheetFileVersion || header->fileSize != size ||
+			header->bucketCount == 0 || (header->bucketCount & (header->bucketCount - 1)) != 0 ||
+			header->bucketCount < header->frameCount ||
+			(header->framesOffset & 3) != 0 || (header->bucketsOffset & 3) != 0 ||
+			header->framesOffset + frameBytes > size ||
+			header->bucketsOffset + bucketBytes > size ||
+			header->namesOffset > size)
+			return false;
+
+		const SpriteSheetFileFrame* frames = (const SpriteSheetFileFrame*)(bytes + header->framesOffset);
+		const char* names = (const char*)(bytes + header->namesOffset);
+		uint64_t namesSize = size - header->namesOffset;
+
+		for (uint32_t i = 0; i < header->frameCount; i++)
+		{
+			if ((uint64_t)frames[i].nameOffset + frames[i].nameLength >= namesSize || names[frames[i].nameOffset + frames[i].nameLength] != 0 ||
+				frames[i].rotated > 1)
+				return false;
+		}
+
+		m_header = header;
+		m_frames = frames;
+		m_buckets = (const uint32_t*)(bytes + header->bucketsOffset);
+		m_names = names;
+		return true;
+	}
+
+	bool IsOpen() const								{ return m_header != nullptr; }
+	uint32_t GetFrameCount() const					{ return m_header ? m_header->frameCount : 0; }
+	const SpriteSheetFileFrame& GetFrame(uint32_t index) const	{ return m_frames[index]; }
+	const char* GetName(uint32_t index) const		{ return m_names + m_frames[index].nameOffset; }
+
+	// Index of the named frame, or SpriteSheetEmptyBucket.
+	uint32_t FindIndex(const char* name, size_t length) const
+	{
+		if (!m_header)
+			return SpriteSheetEmptyBucket;
+
+		uint32_t hash = SpriteSheetHash(name, length);
+		uint32_t mask = m_header->bucketCount - 1;
+
+		for (uint32_t probe = 0; probe <= mask; probe++)
+		{
+			uint32_t index = m_buckets[(hash + probe) & mask];
+			if (index >= m_header->frameCount)
+				return SpriteSheetEmptyBucket;
+
+			const SpriteSheetFileFrame& frame = m_frames[index];
+			if (frame.nameHash == hash && frame.nameLength == length && std::memcmp(m_names + frame.nameOffset, name, length) == 0)
+				return index;
+		}
+		return SpriteSheetEmptyBucket;
+	}
+
+	uint32_t FindIndex(const wchar_t* name) const
+	{
+		char utf8[256];
+		size_t length = SpriteSheetEncodeName(name, utf8, sizeof(utf8));
+		return length == (size_t)-1 ? SpriteSheetEmptyBucket : FindIndex(utf8, length);
+	}
+
+	const SpriteSheetFileFrame* Find(const char* name) const
+	{
+		uint32_t index = FindIndex(name, std::strlen(name));
+		return index == SpriteSheetEmptyBucket ? nullptr : &m_frames[index];
+	}
+
+	const SpriteSheetFileFrame* Find(const wchar_t* name) const
+	{
+		uint32_t index = FindIndex(name);
+		return index == SpriteSheetEmptyBucket ? nullptr : &m_frames[index];
+	}
+
+private:
+	const SpriteSheetFileHeader*	m_header;
+	const SpriteSheetFileFrame*		m_frames;
+	const uint32_t*					m_buckets;
+	const char*						m_names;
+};
+
+// One frame of a sheet being converted.
+struct SpriteSheetEntry
+{
+	std::string				name;
+	SpriteSheetFileFrame	frame;
+};
+
+// Parses TexturePacker 'MonoGame' data, one sprite a line:
+//   Name;rotatedInt;xInt;yInt;widthInt;heightInt;origWidthInt;origHeightInt;offsetXFloat;offsetYFloat
+// Only the first whitespace separated word of a line is read, and a line
+// whose first word is '#' is a comment. The original loader read the file
+// word by word with inFile >> strLine, so it also took the words of a
+// comment like "# Sprite sheet data" as sprites and rejected the file.
+inline bool ParseSpriteSheetText(const char* text, size_t size, std::vector<SpriteSheetEntry>& entries, std::string& error)
+{
+	entries.clear();
+	std::unordered_set<std::string> seen;
+	const char* end = text + size;
+	const char* line = text;
+	int lineNumber = 0;
+
+	while (line < end)
+	{
+		const char* lineEnd = (const char*)std::memchr(line, '\n', end - line);
+		if (!lineEnd)
+			lineEnd = end;
+		lineNumber++;
+
+		// The first whitespace separated word of the line.
+		const char* word = line;
+		while (word < lineEnd && (*word == ' ' || *word == '\t' || *word == '\r'))
+			word++;
+		const char* wordEnd = word;
+		while (wordEnd < lineEnd && *wordEnd != ' ' && *wordEnd != '\t' && *wordEnd != '\r')
+			wordEnd++;
+
+		if (word != wordEnd && !(wordEnd - word == 1 && *word == '#'))
+		{
+			std::string fields(word, wordEnd);
+			std::vector<std::string> parts;
+			for (size_t start = 0;;)
+			{
+				size_t semicolon = fields.find(';', start);
+				parts.push_back(fields.substr(start, semicolon - start));
+				if (semicolon == std::string::npos)
+					break;
+				start = semicolon + 1;
+			}
+
+			if (parts.size() < 10 || parts[0].empty())
+			{
+				error = "invalid sprite data on line " + std::to_string(lineNumber);
+				return false;
+			}
+
+			if (!seen.insert(parts[0]).second)
+			{
+				error = "duplicate sprite '" + parts[0] + "' on line " + std::to_string(lineNumber);
+				return false;
+			}
+
+			SpriteSheetEntry entry;
+			std::memset(&entry.frame, 0, sizeof(entry.frame));
+			entry.name = parts[0];
+
+			SpriteSheetFileFrame& frame = entry.frame;
+			frame.rotated = (std::atoi(parts[1].c_str()) == 1) ? 1 : 0;
+			frame.left = (int32_t)std::atol(parts[2].c_str());
+			frame.top = (int32_t)std::atol(parts[3].c_str());
+			int32_t dx = (int32_t)std::atol(parts[4].c_str());
+			int32_t dy = (int32_t)std::atol(parts[5].c_str());
+			frame.right = frame.left + dx;
+			frame.bottom = frame.top + dy;
+			frame.sizeX = (float)std::atof(parts[6].c_str());
+			frame.sizeY = (float)std::atof(parts[7].c_str());
+			float pivotX = (float)std::atof(parts[8].c_str());
+			float pivotY = (float)std::atof(parts[9].c_str());
+
+			if (frame.rotated)
+			{
+				frame.originX = dx * (1.f - pivotY);
+				frame.originY = dy * pivotX;
+			}
+			else
+			{
+				frame.originX = dx * pivotX;
+				frame.originY = dy * pivotY;
+			}
+
+			entries.push_back(entry);
+		}
+
+		line = lineEnd + 1;
+	}
+	return true;
+}
+
+// Lays entries out in the binary format.
+inline std::vector<uint8_t> BuildSpriteSheetFile(const std::vector<SpriteSheetEntry>& entries)
+{
+	uint32_t frameCount = (uint32_t)entries.size();
+	uint32_t bucketCount = 1;
+	while (bucketCount < frameCount * 2)
+	{
+		bucketCount *= 2;
+	}
+
+	std::vector<SpriteSheetFileFrame> frames(frameCount);
+	std::vector<uint32_t> buckets(bucketCount, SpriteSheetEmptyBucket);
+	std::string names;
+
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		const std::string& name = entries[i].name;
+		SpriteSheetFileFrame& frame = frames[i];
+		frame = entries[i].frame;
+		std::memset(frame.padding, 0, sizeof(frame.padding));
+		frame.nameOffset = (uint32_t)names.size();
+		frame.nameLength = (uint32_t)name.size();
+		frame.nameHash = SpriteSheetHash(name.data(), name.size());
+		names.append(name);
+		names.push_back('\0');
+
+		uint32_t bucket = frame.nameHash & (bucketCount - 1);
+		while (buckets[bucket] != SpriteSheetEmptyBucket)
+		{
+			bucket = (bucket + 1) & (bucketCount - 1);
+		}
+		buckets[bucket] = i;
+	}
+
+	SpriteSheetFileHeader header;
+	std::memcpy(header.magic, "PGSS", 4);
+	header.version = SpriteSheetFileVersion;
+	header.frameCount = frameCount;
+	header.bucketCount = bucketCount;
+	header.framesOffset = (uint32_t)sizeof(SpriteSheetFileHeader);
+	header.bucketsOffset = header.framesOffset + frameCount * (uint32_t)sizeof(SpriteSheetFileFrame);
+	header.namesOffset = header.bucketsOffset + bucketCount * (uint32_t)sizeof(uint32_t);
+	header.fileSize = header.namesOffset + (uint32_t)names.size();
+
+	std::vector<uint8_t> file(header.fileSize);
+	std::memcpy(file.data(), &header, sizeof(header));
+	if (frameCount)
+	{
+		std::memcpy(file.data() + header.framesOffset, frames.data(), frames.size() * sizeof(SpriteSheetFileFrame));
+	}
+	std::memcpy(file.data() + header.bucketsOffset, buckets.data(), buckets.size() * sizeof(uint32_t));
+	if (!names.empty())
+	{
+		std::memcpy(file.data() + header.namesOffset, names.data(), names.size());
+	}
+	return file;
+}
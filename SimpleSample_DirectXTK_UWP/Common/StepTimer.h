@@ -1,14 +1,118 @@
 ﻿#pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#if defined(_WIN32)
 #include <wrl.h>
+#endif
 
 namespace DX
 {
+	// Time source for StepTimer. GetTicks counts GetFrequency ticks per second.
+	class StepTimerClock
+	{
+	public:
+		virtual ~StepTimerClock() {}
+
+		virtual uint64_t GetFrequency() const = 0;
+		virtual uint64_t GetTicks() = 0;
+	};
+
+#if defined(_WIN32)
+	// QueryPerformanceCounter, the default on Windows.
+	class QpcClock : public StepTimerClock
+	{
+	public:
+		QpcClock()
+		{
+			if (!QueryPerformanceFrequency(&m_qpcFrequency))
+			{
+				throw ref new Platform::FailureException();
+			}
+		}
+
+		virtual uint64_t GetFrequency() const override	{ return m_qpcFrequency.QuadPart; }
+
+		virtual uint64_t GetTicks() override
+		{
+			LARGE_INTEGER currentTime;
+
+			if (!QueryPerformanceCounter(&currentTime))
+			{
+				throw ref new Platform::FailureException();
+			}
+
+			return currentTime.QuadPart;
+		}
+
+	private:
+		LARGE_INTEGER m_qpcFrequency;
+	};
+#endif
+
+	// std::chrono::steady_clock, the default everywhere else.
+	class SteadyClock : public StepTimerClock
+	{
+	public:
+		virtual uint64_t GetFrequency() const override
+		{
+			return std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num;
+		}
+
+		virtual uint64_t GetTicks() override
+		{
+			return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+		}
+	};
+
+	// Time only moves when told to, for tests that need exact control over every Tick.
+	class ManualClock : public StepTimerClock
+	{
+	public:
+		ManualClock() : m_ticks(0) {}
+
+		virtual uint64_t GetFrequency() const override	{ return TicksPerSecond; }
+		virtual uint64_t GetTicks() override			{ return m_ticks; }
+
+		void Advance(uint64_t ticks)					{ m_ticks += ticks; }
+		void AdvanceSeconds(double seconds)				{ m_ticks += static_cast<uint64_t>(seconds * TicksPerSecond); }
+
+		static const uint64_t TicksPerSecond = 10000000;
+
+	private:
+		uint64_t m_ticks;
+	};
+
+	// Moves a fixed step every time it is read, i.e. once per StepTimer::Tick. Paired with a fixed
+	// timestep of the same length, every Tick runs exactly one Update no matter how fast the loop
+	// spins, which fast-forwards a simulation while keeping the Tick semantics of real time.
+	class VirtualClock : public StepTimerClock
+	{
+	public:
+		explicit VirtualClock(uint64_t stepTicks) : m_ticks(0), m_stepTicks(stepTicks) {}
+
+		virtual uint64_t GetFrequency() const override	{ return ManualClock::TicksPerSecond; }
+
+		virtual uint64_t GetTicks() override
+		{
+			uint64_t ticks = m_ticks;
+			m_ticks += m_stepTicks;
+			return ticks;
+		}
+
+	private:
+		uint64_t m_ticks;
+		uint64_t m_stepTicks;
+	};
+
 	// Helper class for animation and simulation timing.
 	class StepTimer
 	{
 	public:
-		StepTimer() : 
+		explicit StepTimer(std::shared_ptr<StepTimerClock> clock = CreateDefaultClock()) :
+			m_clock(clock),
 			m_elapsedTicks(0),
 			m_totalTicks(0),
 			m_leftOverTicks(0),
@@ -17,48 +121,63 @@ namespace DX
 			m_framesThisSecond(0),
 			m_qpcSecondCounter(0),
 			m_isFixedTimeStep(false),
-			m_targetElapsedTicks(TicksPerSecond / 60)
+			m_targetElapsedTicks(TicksPerSecond / 60),
+			m_maxUpdatesPerTick(0)
 		{
-			if (!QueryPerformanceFrequency(&m_qpcFrequency))
-			{
-				throw ref new Platform::FailureException();
-			}
-
-			if (!QueryPerformanceCounter(&m_qpcLastTime))
-			{
-				throw ref new Platform::FailureException();
-			}
+			m_qpcFrequency = m_clock->GetFrequency();
+			m_qpcLastTime = m_clock->GetTicks();
 
 			// Initialize max delta to 1/10 of a second.
-			m_qpcMaxDelta = m_qpcFrequency.QuadPart / 10;
+			m_qpcMaxDelta = m_qpcFrequency / 10;
+		}
+
+		static std::shared_ptr<StepTimerClock> CreateDefaultClock()
+		{
+#if defined(_WIN32)
+			return std::make_shared<QpcClock>();
+#else
+			return std::make_shared<SteadyClock>();
+#endif
 		}
 
 		// Get elapsed time since the previous Update call.
-		uint64 GetElapsedTicks() const						{ return m_elapsedTicks; }
+		uint64_t GetElapsedTicks() const					{ return m_elapsedTicks; }
 		double GetElapsedSeconds() const					{ return TicksToSeconds(m_elapsedTicks); }
 
 		// Get total time since the start of the program.
-		uint64 GetTotalTicks() const						{ return m_totalTicks; }
+		uint64_t GetTotalTicks() const						{ return m_totalTicks; }
 		double GetTotalSeconds() const						{ return TicksToSeconds(m_totalTicks); }
 
 		// Get total number of updates since start of the program.
-		uint32 GetFrameCount() const						{ return m_frameCount; }
+		uint32_t GetFrameCount() const						{ return m_frameCount; }
 
 		// Get the current framerate.
-		uint32 GetFramesPerSecond() const					{ return m_framesPerSecond; }
+		uint32_t GetFramesPerSecond() const					{ return m_framesPerSecond; }
 
 		// Set whether to use fixed or variable timestep mode.
 		void SetFixedTimeStep(bool isFixedTimestep)			{ m_isFixedTimeStep = isFixedTimestep; }
 
 		// Set how often to call Update when in fixed timestep mode.
-		void SetTargetElapsedTicks(uint64 targetElapsed)	{ m_targetElapsedTicks = targetElapsed; }
+		void SetTargetElapsedTicks(uint64_t targetElapsed)	{ m_targetElapsedTicks = targetElapsed; }
 		void SetTargetElapsedSeconds(double targetElapsed)	{ m_targetElapsedTicks = SecondsToTicks(targetElapsed); }
+		uint64_t GetTargetElapsedTicks() const				{ return m_targetElapsedTicks; }
+
+		// Limit the number of fixed timestep Update calls made by a single Tick (0 means no limit).
+		// Time beyond the limit is dropped, so one slow frame can't make every following frame slower.
+		void SetMaxUpdatesPerTick(uint32_t maxUpdates)		{ m_maxUpdatesPerTick = maxUpdates; }
+
+		// Fraction of a fixed timestep accumulated but not simulated yet, in [0, 1).
+		// Rendering blends the last two updates by this amount. Always 1 in variable timestep mode.
+		double GetInterpolationAlpha() const
+		{
+			return m_isFixedTimeStep ? static_cast<double>(m_leftOverTicks) / m_targetElapsedTicks : 1.0;
+		}
 
 		// Integer format represents time using 10,000,000 ticks per second.
-		static const uint64 TicksPerSecond = 10000000;
+		static const uint64_t TicksPerSecond = 10000000;
 
-		static double TicksToSeconds(uint64 ticks)			{ return static_cast<double>(ticks) / TicksPerSecond; }
-		static uint64 SecondsToTicks(double seconds)		{ return static_cast<uint64>(seconds * TicksPerSecond); }
+		static double TicksToSeconds(uint64_t ticks)		{ return static_cast<double>(ticks) / TicksPerSecond; }
+		static uint64_t SecondsToTicks(double seconds)		{ return static_cast<uint64_t>(seconds * TicksPerSecond); }
 
 		// After an intentional timing discontinuity (for instance a blocking IO operation)
 		// call this to avoid having the fixed timestep logic attempt a set of catch-up 
@@ -66,10 +185,7 @@ namespace DX
 
 		void ResetElapsedTime()
 		{
-			if (!QueryPerformanceCounter(&m_qpcLastTime))
-			{
-				throw ref new Platform::FailureException();
-			}
+			m_qpcLastTime = m_clock->GetTicks();
 
 			m_leftOverTicks = 0;
 			m_framesPerSecond = 0;
@@ -82,14 +198,9 @@ namespace DX
 		void Tick(const TUpdate& update)
 		{
 			// Query the current time.
-			LARGE_INTEGER currentTime;
-
-			if (!QueryPerformanceCounter(&currentTime))
-			{
-				throw ref new Platform::FailureException();
-			}
+			uint64_t currentTime = m_clock->GetTicks();
 
-			uint64 timeDelta = currentTime.QuadPart - m_qpcLastTime.QuadPart;
+			uint64_t timeDelta = currentTime - m_qpcLastTime;
 
 			m_qpcLastTime = currentTime;
 			m_qpcSecondCounter += timeDelta;
@@ -100,11 +211,11 @@ namespace DX
 				timeDelta = m_qpcMaxDelta;
 			}
 
-			// Convert QPC units into a canonical tick format. This cannot overflow due to the previous clamp.
+			// Convert clock units into a canonical tick format. This cannot overflow due to the previous clamp.
 			timeDelta *= TicksPerSecond;
-			timeDelta /= m_qpcFrequency.QuadPart;
+			timeDelta /= m_qpcFrequency;
 
-			uint32 lastFrameCount = m_frameCount;
+			uint32_t lastFrameCount = m_frameCount;
 
 			if (m_isFixedTimeStep)
 			{
@@ -117,19 +228,30 @@ namespace DX
 				// accumulate enough tiny errors that it would drop a frame. It is better to just round 
 				// small deviations down to zero to leave things running smoothly.
 
-				if (abs(static_cast<int64>(timeDelta - m_targetElapsedTicks)) < TicksPerSecond / 4000)
+				int64_t deviation = static_cast<int64_t>(timeDelta - m_targetElapsedTicks);
+				if ((deviation < 0 ? -deviation : deviation) < static_cast<int64_t>(TicksPerSecond / 4000))
 				{
 					timeDelta = m_targetElapsedTicks;
 				}
 
 				m_leftOverTicks += timeDelta;
 
+				uint32_t updates = 0;
+
 				while (m_leftOverTicks >= m_targetElapsedTicks)
 				{
+					if (m_maxUpdatesPerTick != 0 && updates == m_maxUpdatesPerTick)
+					{
+						// Catch-up cap reached: drop the whole steps we are behind, keep the fraction.
+						m_leftOverTicks %= m_targetElapsedTicks;
+						break;
+					}
+
 					m_elapsedTicks = m_targetElapsedTicks;
 					m_totalTicks += m_targetElapsedTicks;
 					m_leftOverTicks -= m_targetElapsedTicks;
 					m_frameCount++;
+					updates++;
 
 					update();
 				}
@@ -151,33 +273,35 @@ namespace DX
 				m_framesThisSecond++;
 			}
 
-			if (m_qpcSecondCounter >= static_cast<uint64>(m_qpcFrequency.QuadPart))
+			if (m_qpcSecondCounter >= m_qpcFrequency)
 			{
 				m_framesPerSecond = m_framesThisSecond;
 				m_framesThisSecond = 0;
-				m_qpcSecondCounter %= m_qpcFrequency.QuadPart;
+				m_qpcSecondCounter %= m_qpcFrequency;
 			}
 		}
 
 	private:
-		// Source timing data uses QPC units.
-		LARGE_INTEGER m_qpcFrequency;
-		LARGE_INTEGER m_qpcLastTime;
-		uint64 m_qpcMaxDelta;
+		// Source timing data uses the clock's units (QPC units on Windows).
+		std::shared_ptr<StepTimerClock> m_clock;
+		uint64_t m_qpcFrequency;
+		uint64_t m_qpcLastTime;
+		uint64_t m_qpcMaxDelta;
 
 		// Derived timing data uses a canonical tick format.
-		uint64 m_elapsedTicks;
-		uint64 m_totalTicks;
-		uint64 m_leftOverTicks;
+		uint64_t m_elapsedTicks;
+		uint64_t m_totalTicks;
+		uint64_t m_leftOverTicks;
 
 		// Members for tracking the framerate.
-		uint32 m_frameCount;
-		uint32 m_framesPerSecond;
-		uint32 m_framesThisSecond;
-		uint64 m_qpcSecondCounter;
+		uint32_t m_frameCount;
+		uint32_t m_framesPerSecond;
+		uint32_t m_framesThisSecond;
+		uint64_t m_qpcSecondCounter;
 
 		// Members for configuring fixed timestep mode.
 		bool m_isFixedTimeStep;
-		uint64 m_targetElapsedTicks;
+		uint64_t m_targetElapsedTicks;
+		uint32_t m_maxUpdatesPerTick;
 	};
 }
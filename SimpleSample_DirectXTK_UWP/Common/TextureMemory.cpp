@@ -0,0 +1,221 @@
+﻿#include "pch.h"
+#include "TextureMemory.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace DX;
+
+namespace
+{
+	// {6E1D0C5A-2F64-4B8B-9A0E-3C1B7D52A9F4}
+	const GUID TextureMemoryTokenGuid = { 0x6e1d0c5a, 0x2f64, 0x4b8b, { 0x9a, 0x0e, 0x3c, 0x1b, 0x7d, 0x52, 0xa9, 0xf4 } };
+
+	// Set as private data of the texture, which releases it when the
+	// texture is destroyed; the last release gives the bytes back.
+	class TextureMemoryToken : public IUnknown
+	{
+	public:
+		TextureMemoryToken(Simulation::MemoryTag tag, uint64_t bytes) : m_references(1), m_tag(tag), m_bytes(bytes)
+		{
+			Simulation::MemoryTracker::Get().Add(m_tag, m_bytes);
+		}
+
+		STDMETHODIMP QueryInterface(REFIID iid, void** object) override
+		{
+			if (!object)
+				return E_POINTER;
+
+			if (iid != __uuidof(IUnknown))
+			{
+				*object = nullptr;
+				return E_NOINTERFACE;
+			}
+
+			*object = static_cast<IUnknown*>(this);
+			AddRef();
+			return S_OK;
+		}
+
+		STDMETHODIMP_(ULONG) AddRef() override
+		{
+			return ++m_references;
+		}
+
+		STDMETHODIMP_(ULONG) Release() override
+		{
+			ULONG references = --m_references;
+			if (references == 0)
+			{
+				delete this;
+			}
+			return references;
+		}
+
+	private:
+		~TextureMemoryToken()
+		{
+			Simulation::MemoryTracker::Get().Remove(m_tag, m_bytes);
+		}
+
+		std::atomic<ULONG>			m_references;
+		Simulation::MemoryTag		m_tag;
+		uint64_t					m_bytes;
+	};
+
+	// Bits per texel, or per texel of a 4x4 block for the block compressed formats.
+	uint32_t BitsPerPixel(DXGI_FORMAT format)
+	{
+		switch (format)
+		{
+		case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		case DXGI_FORMAT_R32G32B32A32_UINT:
+		case DXGI_FORMAT_R32G32B32A32_SINT:
+			return 128;
+
+		case DXGI_FORMAT_R32G32B32_TYPELESS:
+		case DXGI_FORMAT_R32G32B32_FLOAT:
+		case DXGI_FORMAT_R32G32B32_UINT:
+		case DXGI_FORMAT_R32G32B32_SINT:
+			return 96;
+
+		case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		case DXGI_FORMAT_R16G16B16A16_UNORM:
+		case DXGI_FORMAT_R16G16B16A16_UINT:
+		case DXGI_FORMAT_R16G16B16A16_SNORM:
+		case DXGI_FORMAT_R16G16B16A16_SINT:
+		case DXGI_FORMAT_R32G32_TYPELESS:
+		case DXGI_FORMAT_R32G32_FLOAT:
+		case DXGI_FORMAT_R32G32_UINT:
+		case DXGI_FORMAT_R32G32_SINT:
+		case DXGI_FORMAT_R32G8X24_TYPELESS:
+		case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+		case DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS:
+		case DXGI_FORMAT_X32_TYPELESS_G8X24_UINT:
+			return 64;
+
+		case DXGI_FORMAT_R8G8_TYPELESS:
+		case DXGI_FORMAT_R8G8_UNORM:
+		case DXGI_FORMAT_R8G8_UINT:
+		case DXGI_FORMAT_R8G8_SNORM:
+		case DXGI_FORMAT_R8G8_SINT:
+		case DXGI_FORMAT_R16_TYPELESS:
+		case DXGI_FORMAT_R16_FLOAT:
+		case DXGI_FORMAT_D16_UNORM:
+		case DXGI_FORMAT_R16_UNORM:
+		case DXGI_FORMAT_R16_UINT:
+		case DXGI_FORMAT_R16_SNORM:
+		case DXGI_FORMAT_R16_SINT:
+		case DXGI_FORMAT_B5G6R5_UNORM:
+		case DXGI_FORMAT_B5G5R5A1_UNORM:
+		case DXGI_FORMAT_B4G4R4A4_UNORM:
+			return 16;
+
+		case DXGI_FORMAT_R8_TYPELESS:
+		case DXGI_FORMAT_R8_UNORM:
+		case DXGI_FORMAT_R8_UINT:
+		case DXGI_FORMAT_R8_SNORM:
+		case DXGI_FORMAT_R8_SINT:
+		case DXGI_FORMAT_A8_UNORM:
+		case DXGI_FORMAT_BC2_TYPELESS:
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_TYPELESS:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC5_TYPELESS:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC5_SNORM:
+		case DXGI_FORMAT_BC6H_TYPELESS:
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+		case DXGI_FORMAT_BC7_TYPELESS:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return 8;
+
+		case DXGI_FORMAT_BC1_TYPELESS:
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_TYPELESS:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC4_SNORM:
+			return 4;
+
+		case DXGI_FORMAT_R1_UNORM:
+			return 1;
+
+		// The 32 bit formats (RGBA8, BGRA8, R10G10B10A2, R32, D24S8...)
+		// and anything newer are counted as 32 bits.
+		default:
+			return 32;
+		}
+	}
+
+	bool IsBlockCompressed(DXGI_FORMAT format)
+	{
+		return (format >= DXGI_FORMAT_BC1_TYPELESS && format <= DXGI_FORMAT_BC5_SNORM)
+			|| (format >= DXGI_FORMAT_BC6H_TYPELESS && format <= DXGI_FORMAT_BC7_UNORM_SRGB);
+	}
+}
+
+uint64_t DX::EstimateTextureBytes(const D3D11_TEXTURE2D_DESC& desc)
+{
+	uint32_t bits = BitsPerPixel(desc.Format);
+	bool blocks = IsBlockCompressed(desc.Format);
+
+	// MipLevels 0 asks for the full chain down to 1x1.
+	uint32_t mips = desc.MipLevels;
+	if (mips == 0)
+	{
+		for (uint32_t size = (std::max)(desc.Width, desc.Height); size; size >>= 1)
+			mips++;
+	}
+
+	uint64_t bytes = 0;
+	for (uint32_t mip = 0; mip < mips; mip++)
+	{
+		uint64_t width = (std::max)(desc.Width >> mip, 1u);
+		uint64_t height = (std::max)(desc.Height >> mip, 1u);
+		if (blocks)
+		{
+			// Compressed mips are stored in whole 4x4 blocks.
+			width = (width + 3) & ~3ull;
+			height = (height + 3) & ~3ull;
+		}
+		bytes += (width * height * bits + 7) / 8;
+	}
+
+	return bytes * desc.ArraySize * (std::max)(desc.SampleDesc.Count, 1u);
+}
+
+void DX::TrackTextureMemory(ID3D11Texture2D* texture, Simulation::MemoryTag tag)
+{
+	if (!texture)
+		return;
+
+	D3D11_TEXTURE2D_DESC desc;
+	texture->GetDesc(&desc);
+
+	// The texture holds the only reference once this one is dropped.
+	Microsoft::WRL::ComPtr<IUnknown> token;
+	token.Attach(new TextureMemoryToken(tag, EstimateTextureBytes(desc)));
+	texture->SetPrivateDataInterface(TextureMemoryTokenGuid, token.Get());
+}
+
+void DX::TrackTextureMemory(ID3D11ShaderResourceView* view, Simulation::MemoryTag tag)
+{
+	if (!view)
+		return;
+
+	Microsoft::WRL::ComPtr<ID3D11Resource> resource;
+	view->GetResource(resource.GetAddressOf());
+
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+	if (SUCCEEDED(resource.As(&texture)))
+	{
+		TrackTextureMemory(texture.Get(), tag);
+	}
+}
@@ -0,0 +1,18 @@
+﻿#pragma once
+
+#include "..\Simulation\MemoryTracker.hpp"
+
+namespace DX
+{
+	// Bytes of video memory a texture with this description takes: every
+	// mip of every array slice and sample, at the size of its format.
+	// Drivers pad and align on top of this, so it is a lower bound.
+	uint64_t EstimateTextureBytes(const D3D11_TEXTURE2D_DESC& desc);
+
+	// Charges the estimate of texture to tag in Simulation::MemoryTracker
+	// until the texture is destroyed, however many references it has.
+	void TrackTextureMemory(ID3D11Texture2D* texture, Simulation::MemoryTag tag = Simulation::MemoryTag_Textures);
+
+	// The same for the texture a shader resource view reads.
+	void TrackTextureMemory(ID3D11ShaderResourceView* view, Simulation::MemoryTag tag = Simulation::MemoryTag_Textures);
+}
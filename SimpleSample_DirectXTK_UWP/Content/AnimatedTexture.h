@@ -18,6 +18,8 @@
 #include <exception>
 #include <SpriteBatch.h>
 
+#include "Common/SpriteRenderer.hpp"
+
 class AnimatedTexture
 {
 public:
@@ -38,12 +40,15 @@ public:
     {
     }
 
-    void Load( ID3D11ShaderResourceView* texture, int frameCount, int framesPerSecond )
+    // region is the part of texture holding the frames side by side, e.g. a
+    // sprite in an atlas; nullptr uses the whole texture.
+    void Load( ID3D11ShaderResourceView* texture, int frameCount, int framesPerSecond, const RECT* region = nullptr )
     {
-        if ( frameCount < 0 || framesPerSecond <= 0 )
+        if ( frameCount <= 0 || framesPerSecond <= 0 )
             throw std::invalid_argument( "AnimatedTexture" );
 
         mPaused = false;
+        mFrame = 0;
         mFrameCount = frameCount;
         mTimePerFrame = 1.f / float(framesPerSecond);
         mTotalElapsed = 0.f;
@@ -66,8 +71,20 @@ public:
             D3D11_TEXTURE2D_DESC desc;
             tex2D->GetDesc( &desc );
 
-            mTextureWidth = int( desc.Width );
-            mTextureHeight = int( desc.Height );
+            if ( region )
+            {
+                mRegion = *region;
+            }
+            else
+            {
+                mRegion.left = 0;
+                mRegion.top = 0;
+                mRegion.right = LONG( desc.Width );
+                mRegion.bottom = LONG( desc.Height );
+            }
+
+            mTextureWidth = int( mRegion.right - mRegion.left );
+            mTextureHeight = int( mRegion.bottom - mRegion.top );
 
         }
     }
@@ -79,31 +96,35 @@ public:
 
         mTotalElapsed += elapsed;
 
-        if ( mTotalElapsed > mTimePerFrame )
+        // A long frame may cover several animation frames; skip all of them
+        // so the animation keeps its rate whatever the frame rate.
+        if ( mTotalElapsed >= mTimePerFrame && mFrameCount > 0 )
         {
-            ++mFrame;
-            mFrame = mFrame % mFrameCount;
-            mTotalElapsed -= mTimePerFrame;
+            int frames = int( mTotalElapsed / mTimePerFrame );
+            mFrame = ( mFrame + frames ) % mFrameCount;
+            mTotalElapsed -= float( frames ) * mTimePerFrame;
         }
     }
 
-    void Draw( DirectX::SpriteBatch* batch, const DirectX::XMFLOAT2& screenPos ) const
+    void Draw( SpriteRenderer* renderer, const DirectX::XMFLOAT2& screenPos ) const
     {
-        Draw( batch, mFrame, screenPos );
+        Draw( renderer, mFrame, screenPos );
     }
 
-    void Draw( DirectX::SpriteBatch* batch, int frame, const DirectX::XMFLOAT2& screenPos ) const
+    void Draw( SpriteRenderer* renderer, int frame, const DirectX::XMFLOAT2& screenPos ) const
     {
         int frameWidth = mTextureWidth / mFrameCount;
-
-        RECT sourceRect;
-        sourceRect.left = frameWidth * frame;
-        sourceRect.top = 0;
-        sourceRect.right = sourceRect.left + frameWidth;
-        sourceRect.bottom = mTextureHeight;
-
-        batch->Draw( mTexture.Get(), screenPos, &sourceRect, DirectX::Colors::White,
-                     mRotation, mOrigin, mScale, DirectX::SpriteEffects_None, mDepth );
+        int32_t left = int32_t( mRegion.left + frameWidth * frame );
+
+        SpriteDraw sprite( mTexture.Get(), SpriteRect( left, mRegion.top, left + frameWidth, mRegion.top + mTextureHeight ),
+                           screenPos.x, screenPos.y );
+        sprite.originX = mOrigin.x;
+        sprite.originY = mOrigin.y;
+        sprite.scaleX = mScale.x;
+        sprite.scaleY = mScale.y;
+        sprite.rotation = mRotation;
+        sprite.depth = mDepth;
+        renderer->Draw( sprite );
     }
 
     void Reset()
@@ -149,6 +170,7 @@ private:
     int                                                 mFrameCount;
     int                                                 mTextureWidth;
     int                                                 mTextureHeight;
+    RECT                                                mRegion;
 
 
 
@@ -8,128 +8,61 @@
 
 //#include "..\Common\DirectXHelper.h"	// For ThrowIfaFailed and ReadDataAsync
 
-#include <Content\AnimatedTexture.h>
 #include <SpriteBatch.h>
 
+#include "Common/SpriteRenderer.hpp"
+#include "Common/SpriteSheet.hpp"
+
 #include <DirectXMath.h>
 #include <SimpleMath.h>
 
-#include "Wall.hpp"
-
 
+// Draws enemies. One instance is shared by every enemy in Simulation::EnemyPool,
+// which owns the position, speed, visibility, collisions and each enemy's
+// animation playback; this holds the sheet the frames are cut from. The
+// frames come from the sheet's "enemy" clip (SpriteSheet::BuildClips).
 class Enemy
 {
 public:
-	Enemy(ID3D11ShaderResourceView* enemySpriteSheet) : framesOfAnimation{ 4 }, framesToBeShownPerSecond{ 4 }, visible{ true }, flightSpeed {0}
+	// sheet must outlive the enemy; frame is any of its frames and sizes the enemy.
+	Enemy(ID3D11ShaderResourceView* enemySpriteSheet, const SpriteSheet& sheet, SpriteSheet::SpriteId frame) : scale{ 3.f }
 	{
-		position = DirectX::XMFLOAT2(512, 512);
-
-		//Instantiate animation here
 		texture = enemySpriteSheet;
-		float rotation = 0.f;
-		float scale = 3.f;
-		animation.reset(new AnimatedTexture(DirectX::XMFLOAT2(0.f, 0.f), rotation, scale, 0.5f));
-		animation->Load(texture.Get(), framesOfAnimation, framesToBeShownPerSecond);
-
-		width = textureWidth = animation->getFrameWidth();
-		height = textureHeight = animation->getFrameHeight();
-
-		rectangle.X = position.x;
-		rectangle.Y = position.y;
-		rectangle.Height = height;
-		rectangle.Width = width;
-
-	}
-
-	void setPosition(DirectX::XMFLOAT2 newPosition)
-	{
-		//set the position
-		position = newPosition;
-		updateBoundingRect();
-	}
-
-	void setPosition(float posX, float posY)
-	{
-		position.x = posX;
-		position.y = posY;
-		updateBoundingRect();
-	}
-
-	DirectX::XMFLOAT2 getPosition()
-	{
-		return position;
-	}
-
-	bool isVisible()
-	{
-		return this->visible;
-	}
-	void setVisibility(bool visibility)
-	{
-		this->visible = visibility;
-	}
+		this->sheet = &sheet;
 
-	void setFlightSpeed(int speed)
-	{
-		this->flightSpeed = speed;
+		RECT source = sheet.GetFrame(frame).sourceRect;
+		width = (int)((source.right - source.left) * scale);
+		height = (int)((source.bottom - source.top) * scale);
 	}
 
-	int getFlightSpeed()
+	int getWidth() const
 	{
-		return this->flightSpeed;
+		return width;
 	}
 
-
-
-	bool isCollidingWith(Windows::Foundation::Rect rect)
+	int getHeight() const
 	{
-		if (rectangle.IntersectsWith(rect))
-		{
-			return true;
-		}
-
-		else
-		{
-			return false;
-		}
+		return height;
 	}
 
-	void Update(float elapsed)
+	// frame is a sheet frame id from Simulation::EvaluateAnimationFrames.
+	void Draw(SpriteRenderer* renderer, uint32_t frame, const DirectX::XMFLOAT2& position)
 	{
-		animation->Update(elapsed);
+		RECT source = sheet->GetFrame(frame).sourceRect;
+		SpriteDraw sprite(texture.Get(), SpriteRect(source.left, source.top, source.right, source.bottom), position.x, position.y);
+		sprite.scaleX = scale;
+		sprite.scaleY = scale;
+		sprite.depth = 0.5f;
+		renderer->Draw(sprite);
 	}
 
-	void Draw(DirectX::SpriteBatch* batch)
-	{
-		animation->Draw(batch, position);
-	}
-
-public:
-	Windows::Foundation::Rect							rectangle;
-
 private:
-	void updateBoundingRect()
-	{
-		//TODO: proper updating when rotating object
-		rectangle.X = position.x;
-		rectangle.Y = position.y;
-		rectangle.Height = height;
-		rectangle.Width = width;
-	}
-
-	DirectX::XMFLOAT2									position;
-
 	int													width;
 	int													height;
-	int													textureWidth;
-	int													textureHeight;
-	int													framesOfAnimation;
-	int													framesToBeShownPerSecond;
-	bool												visible;
-	int													flightSpeed;
-
-	//Texture and animation
+	float												scale;
+
+	//Texture and the sheet its frames are cut from
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>	texture;
-	std::shared_ptr<AnimatedTexture>					animation;
+	const SpriteSheet*									sheet;
 
-};
\ No newline at end of file
+};
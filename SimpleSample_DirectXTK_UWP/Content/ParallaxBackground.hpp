@@ -0,0 +1,88 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <vector>
+#include <wrl.h>
+#include <SpriteBatch.h>
+
+#include "Common/SpriteRenderer.hpp"
+#include "Simulation/Parallax.hpp"
+
+using namespace DirectX;
+
+// Draws the parallax layers of Simulation::ParallaxLayers, one wrapped quad
+// per layer. The sampler is chosen by SpriteRenderer::Begin, so the layers
+// of a plane get a batch of their own.
+class ParallaxBackground
+{
+public:
+	// texture must be a whole Texture2D; the sampler wraps at its edges.
+	void AddLayer(ID3D11ShaderResourceView* texture, const Simulation::ParallaxLayerDesc& desc)
+	{
+		Microsoft::WRL::ComPtr<ID3D11Resource> resource;
+		texture->GetResource(resource.GetAddressOf());
+
+		Microsoft::WRL::ComPtr<ID3D11Texture2D> tex2D;
+		if (FAILED(resource.As(&tex2D)))
+			throw std::exception("ParallaxBackground expects a Texture2D");
+
+		D3D11_TEXTURE2D_DESC textureDesc;
+		tex2D->GetDesc(&textureDesc);
+
+		m_textures.push_back(texture);
+		m_layers.Add(desc, textureDesc.Width, textureDesc.Height);
+	}
+
+	void Clear()
+	{
+		m_textures.clear();
+		m_layers.Clear();
+	}
+
+	void SetWindow(float screenWidth, float screenHeight)
+	{
+		m_layers.SetScreenSize(Simulation::Size(screenWidth, screenHeight));
+	}
+
+	void Update(float elapsedSeconds)
+	{
+		m_layers.Update(elapsedSeconds);
+	}
+
+	// Draws the layers of plane in a batch of their own, with a wrapping
+	// sampler; alpha blends them between their last two updates.
+	void Draw(SpriteRenderer* renderer, Simulation::ParallaxPlane plane, float alpha = 1.f)
+	{
+		bool begun = false;
+		for (size_t i = 0; i < m_layers.GetCount(); i++)
+		{
+			if (m_layers.GetDesc(i).plane != plane)
+				continue;
+
+			if (!begun)
+			{
+				renderer->Begin(SpriteSampler_Wrap);
+				begun = true;
+			}
+
+			Simulation::ParallaxQuad quad = m_layers.GetQuad(i, alpha);
+			SpriteDraw sprite(m_textures[i].Get(), SpriteRect(quad.left, quad.top, quad.right, quad.bottom), quad.position.x, quad.position.y);
+			sprite.scaleX = quad.scale.x;
+			sprite.scaleY = quad.scale.y;
+			renderer->Draw(sprite);
+		}
+
+		if (begun)
+		{
+			renderer->End();
+		}
+	}
+
+	const Simulation::ParallaxLayers& GetLayers() const		{ return m_layers; }
+
+private:
+	Simulation::ParallaxLayers									m_layers;
+	std::vector<Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>>	m_textures;
+};
@@ -15,47 +15,32 @@
 #include <SimpleMath.h>
 
 
+// Draws the player ship. Position and collisions are owned by Simulation::Player.
 class Player
 {
 public:
-	Player(ID3D11ShaderResourceView* playerSpriteSheet) : framesOfAnimation(4), framesToBeShownPerSecond(4)
+	// region selects the animation strip when the texture is an atlas.
+	Player(ID3D11ShaderResourceView* playerSpriteSheet, const RECT* region = nullptr) : framesOfAnimation(4), framesToBeShownPerSecond(4)
 	{
-		position = DirectX::XMFLOAT2(300, 512);
-		
 		//Instantiate animation here
 		texture = playerSpriteSheet;
 		float rotation = 0.f;
 		float scale = 3.f;
 		animation.reset(new AnimatedTexture(DirectX::XMFLOAT2(0.f, 0.f), rotation, scale, 0.5f));
-		animation->Load(texture.Get(), framesOfAnimation, framesToBeShownPerSecond);
+		animation->Load(texture.Get(), framesOfAnimation, framesToBeShownPerSecond, region);
 
-		width = textureWidth = animation->getFrameWidth();
-		height = textureHeight = animation->getFrameHeight();
-
-		rectangle.X = position.x;
-		rectangle.Y = position.y;
-		rectangle.Height = height;
-		rectangle.Width = width;
-		
-	}
-
-	void setPosition(DirectX::XMFLOAT2 newPosition)
-	{
-		//set the position
-		position = newPosition;
-		updateBoundingRect();
+		width = animation->getFrameWidth();
+		height = animation->getFrameHeight();
 	}
 
-	void setPosition(float posX, float posY)
+	int getWidth() const
 	{
-		position.x = posX;
-		position.y = posY;
-		updateBoundingRect();
+		return width;
 	}
 
-	DirectX::XMFLOAT2 getPosition()
+	int getHeight() const
 	{
-		return position; 
+		return height;
 	}
 
 	void Update(float elapsed)
@@ -65,36 +50,14 @@ public:
 		animation->Update(elapsed);
 	}
 
-	void Draw(DirectX::SpriteBatch* batch)
+	void Draw(SpriteRenderer* renderer, const DirectX::XMFLOAT2& position)
 	{
-		animation->Draw(batch, position);
+		animation->Draw(renderer, position);
 	}
 
-
-public:
-	Windows::Foundation::Rect							rectangle;
-
 private:
-	void updateBoundingRect()
-	{
-		//TODO: proper updating when rotating player object
-		rectangle.X = position.x;
-		rectangle.Y = position.y;
-		rectangle.Height = height;
-		rectangle.Width = width;
-	}
-
-	Windows::Foundation::Rect getBoundingRect()
-	{
-		return rectangle;
-	}
-
-	DirectX::XMFLOAT2									position;
-
 	int													width;
 	int													height;
-	int													textureWidth;
-	int													textureHeight;
 	int													framesOfAnimation;
 	int													framesToBeShownPerSecond;
 
@@ -102,4 +65,4 @@ private:
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>	texture;
 	std::unique_ptr<AnimatedTexture>					animation;
 
-};
\ No newline at end of file
+};
@@ -4,20 +4,75 @@
 
 
 #include "..\Common\DirectXHelper.h"
+#include "..\Common\TextureMemory.h"
+#include "Simulation/Profiler.hpp"
+#include "Simulation/AllocationCounter.hpp"
+
+#include <cassert>
+#include <fstream>
 
 using namespace SimpleSample_DirectXTK_UWP;
 
 using namespace DirectX;
 using namespace Windows::Foundation;
 
+namespace
+{
+	// Source rectangle of a sprite in the gameplay atlas.
+	RECT FindAtlasSprite(const SpriteSheet& sheet, const wchar_t* name)
+	{
+		SpriteSheet::SpriteFrame frame;
+		if (!sheet.Find(name, frame))
+			throw std::exception("Gameplay atlas is missing a sprite, rebuild it with the GameplayAtlas target");
+
+		return frame.sourceRect;
+	}
+
+	// Parallax layers, back to front. Speeds are screen pixels per second;
+	// the front plane is drawn over the gameplay sprites.
+	struct ParallaxLayerEntry
+	{
+		const wchar_t*					texture;
+		Simulation::ParallaxLayerDesc	desc;
+	};
+
+	const ParallaxLayerEntry ParallaxLayerTable[] =
+	{
+		{ L"Assets\\background.dds",	{ 100.f, 1.f, Simulation::ParallaxPlane_Back } },
+		{ L"Assets\\clouds.dds",		{ 300.f, 1.f, Simulation::ParallaxPlane_Back } },
+		{ L"Assets\\clouds2.dds",		{ 900.f, 1.f, Simulation::ParallaxPlane_Front } },
+	};
+
+	// Ticks the game needs to reach its steady state: pools and the course
+	// ring filled, arenas and logs grown to the size they keep.
+	const uint32_t SteadyTickWarmup = 600;
+
+	// Takes a texture that is not needed to start playing once it has loaded.
+	void TakeIfLoaded(std::shared_future<DX::AssetLoader::Texture>& load, Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>& texture)
+	{
+		if (load.valid() && load.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			texture = load.get();
+			load = std::shared_future<DX::AssetLoader::Texture>();
+		}
+	}
+}
+
 // Loads vertex and pixel shaders from files and instantiates the cube geometry.
 Sample3DSceneRenderer::Sample3DSceneRenderer(const std::shared_ptr<DX::DeviceResources>& deviceResources) :
 	m_loadingComplete(false),
+	m_inputLatency(nullptr),
+	m_lateLatch(false),
+	m_tickSeconds(0.f),
+	m_lastGamepadActions(0),
+	collisionString(L"There is no collision"),
+	m_steadyTicks(0),
 	//m_degreesPerSecond(45),
 	//m_indexCount(0),
 	//m_tracking(false),
 	m_deviceResources(deviceResources)
 {
+	m_assets.reset(new DX::AssetLoader(deviceResources));
 	CreateDeviceDependentResources();
 	CreateWindowSizeDependentResources();
 }
@@ -43,6 +98,17 @@ void Sample3DSceneRenderer::CreateWindowSizeDependentResources()
 	spriteBatchT1->SetRotation(m_deviceResources->ComputeDisplayRotation());
 	spriteBatchT2->SetRotation(m_deviceResources->ComputeDisplayRotation());
 
+	// Enemy spawns, new walls and the parallax quads follow the logical window size.
+	Size logicalSize = m_deviceResources->GetLogicalSize();
+	if (world)
+	{
+		world->SetScreenSize(Simulation::Size(logicalSize.Width, logicalSize.Height));
+	}
+	if (parallax)
+	{
+		parallax->SetWindow(logicalSize.Width, logicalSize.Height);
+	}
+	m_steadyTicks = 0;
 
 	// Note that the OrientationTransform3D matrix is post-multiplied here
 	//// in order to correctly orient the scene to match the display orientation.
@@ -79,6 +145,7 @@ void Sample3DSceneRenderer::CreateWindowSizeDependentResources()
 void Sample3DSceneRenderer::CreateAudioResources()
 {
 	// Create DirectXTK for Audio objects
+	Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Audio);
 	AUDIO_ENGINE_FLAGS eflags = AudioEngine_Default;
 #ifdef _DEBUG
 	eflags = eflags | AudioEngine_Debug;
@@ -141,226 +208,180 @@ void Sample3DSceneRenderer::Update(DX::StepTimer const& timer)
 	//	m_audioTimerAcc = 1.f;
 	//	m_retryDefault = true;
 	//}
-	auto windowSize = m_deviceResources->GetOutputSize(); // physical screen resolution
-	auto logicalSize = m_deviceResources->GetLogicalSize(); //DPI dependent resolution
-
-
 
-#pragma region Handling Adding Enemies
-
-	//Enemy enemyTemp(enemyTexture.Get());
-	//enemiesVector.push_back(enemyTemp);
-
-	if (enemiesVector.size() < 5)
-	{
-		std::random_device rd;
-		std::default_random_engine random(rd());
-
-		std::uniform_int_distribution<int> dist(0, (int)windowSize.Height); //Choose distribution of the result (inclusive,inclusive)
-		std::uniform_int_distribution<int> dist2(5, 25); //Choose distribution of the result (inclusive,inclusive)
-
-		Enemy enemyTemp(enemyTexture.Get());
-		XMFLOAT2 tempPos{ 0,0 };
-		tempPos.x = windowSize.Width;
-		tempPos.y = dist(random);
-		enemyTemp.setFlightSpeed(dist2(random));
-		enemyTemp.setPosition(tempPos);
-		enemiesVector.push_back(enemyTemp);
-	}
-
-#pragma endregion
-
-
-#pragma region Gamepad
-	//GamePad
-	auto statePlayerOne = gamePad->GetState(0);
-	if (statePlayerOne.IsConnected())
+	// Nothing to simulate until Render has created the game objects.
+	if (!m_loadingComplete)
 	{
-		XMFLOAT2 tempPos = player->getPosition();
-		if (statePlayerOne.IsDPadUpPressed()) {
-			tempPos.y -= 10; //CHANGE TO PROPER OFFSET CALCULATION - USING TIME 
-		}
-
-		if (statePlayerOne.IsDPadDownPressed()) {
-			tempPos.y += 10; ////CHANGE TO PROPER OFFSET CALCULATION - USING TIME 
-		}
-
-		if (statePlayerOne.IsDPadLeftPressed()) {
-			tempPos.x -= 10; //CHANGE TO PROPER OFFSET CALCULATION - USING TIME 
-		}
-		if (statePlayerOne.IsDPadRightPressed()) {
-			tempPos.x += 10; //CHANGE TO PROPER OFFSET CALCULATION - USING TIME 	
+		if (m_inputLatency)
+		{
+			m_inputLatency->Discard();
 		}
-		player->setPosition(tempPos);
+		return;
 	}
-#pragma endregion Handling the Gamepad Input
-
 
-#pragma region Keyboard
-	std::unique_ptr<Keyboard::KeyboardStateTracker> tracker(new Keyboard::KeyboardStateTracker);
+	auto windowSize = m_deviceResources->GetOutputSize(); // physical screen resolution
+	auto logicalSize = m_deviceResources->GetLogicalSize(); //DPI dependent resolution
 
 
 
-	auto keyboardState = Keyboard::Get().GetState();
+#ifdef _DEBUG
+	// Counts this thread only; the asset loader may still be allocating.
+	Simulation::AllocationScope allocations;
+#endif
 
-	tracker->Update(keyboardState);
-	XMFLOAT2 tempPos = player->getPosition();
-	if (tracker->pressed.S)
-	{
+	m_keyboardTracker.Update(Keyboard::Get().GetState());
+	Simulation::PlayerInput input = ReadPlayerInput(m_keyboardTracker.lastState);
+	Simulation::TickResult result;
+	m_tickInput = input;
+	m_tickSeconds = (float)timer.GetElapsedSeconds();
 
-		tempPos.y += 10;
-	}
 
-	if (tracker->pressed.W)
-	{
 
-		tempPos.y -= 10;
-	}
 
-	if (tracker->pressed.A)
-	{
-		tempPos.x -= 10;
-	}
-	if (tracker->pressed.D)
+#pragma region Paralaxing background
 	{
-		tempPos.x += 10;
+		PROFILE_ZONE("Parallax");
+		parallax->Update((float)timer.GetElapsedSeconds());
 	}
-
-
-	player->setPosition(tempPos);
-
-
-#pragma endregion Handling Keyboard input
-
-
-
-
-#pragma region Paralaxing background
-	//Update Background
-	background->Update((float)timer.GetElapsedSeconds() * 100);
-	clouds->Update((float)timer.GetElapsedSeconds() * 300);
-	clouds2->Update((float)timer.GetElapsedSeconds() * 900);
 #pragma endregion Handling the paralaxing backgrounds
 
-	//auto test = timer.GetElapsedSeconds();
-
-
-	//update the animation
-	//animation->Update((float)timer.GetElapsedSeconds());
-	player->Update((float)timer.GetElapsedSeconds());
-
 
 
-#pragma	region Updating Enemies without AI
-	for (auto & enemy : enemiesVector)
+#pragma region Simulation
 	{
-		
-		XMFLOAT2 tempPos = enemy.getPosition();
-		tempPos.x -= enemy.getFlightSpeed(); //CHANGE TO PROPER POSITIONING USING TIME
-		enemy.setPosition(tempPos);
-		if (tempPos.x < 0)
+		PROFILE_ZONE("Simulation");
+		// Every tick's input is logged so the session can be replayed with Tools\ReplayRunner.
+		// The log never grows past what Begin reserves; a full one stops recording.
 		{
-			enemy.setVisibility(false);
+			Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Input);
+			if (inputLog.GetTickCount() == 0)
+			{
+				inputLog.Begin(world->GetConfig(), world->GetSeed(), (float)timer.GetElapsedSeconds());
+			}
+			inputLog.Record(input);
 		}
 
-	}
-
-#pragma endregion
-
+		// Spawning, movement, collisions and cleanup of enemies and walls (see Simulation\World.hpp).
+		Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Entities);
+		result = world->Tick((float)timer.GetElapsedSeconds(), input);
 
-
-#pragma region Updating Enemies with AI
-	// TODO: handle enemy AI using promises and Lambdas
-	std::vector<std::future<DirectX::XMFLOAT2>> futures;
-
-	for (auto& enemy : enemiesVector)
-	{
-		futures.push_back(std::async(std::launch::async,
-			[&]()
-		{
-			
-			Enemy & currentEnemy = enemy;
-			DirectX::XMFLOAT2 enemyPos{ 0,0 };
-			DirectX::XMFLOAT2 playerPos = player->getPosition();
-			//TODO: Write code for very complicated AI here
-
-			return enemyPos;
-
-		}));
-	}
-
-	for (auto &future : futures)
-	{
-		//TODO:get results
-
-		auto enemiesIterator = enemiesVector.begin();
-
-		DirectX::XMFLOAT2 tempPos;
-		tempPos = future.get();
-		//(*enemiesIterator).setPosition(tempPos);
-		//enemiesIterator++;
+		//update the animation of the player; enemy frames are evaluated from the world's clock when drawn
+		player->Update((float)timer.GetElapsedSeconds());
 	}
-
-#pragma endregion Handling Enemy AI using std::async and std::Future. Also using C++11 Lambdas
-
+#pragma endregion Game logic shared with the headless tools
 
 
 
 #pragma region Collisions
-	collisionString = L"There is no collision";
-	gamePad->SetVibration(0, 0.f, 0.f);
-	
-	// Collisions of Player with walls
-	for (auto wallsIterator = wallsVector.begin(); wallsIterator < wallsVector.end(); wallsIterator++)
 	{
+		PROFILE_ZONE("Collision feedback");
+		collisionString = L"There is no collision";
+		gamePad->SetVibration(0, 0.f, 0.f);
 
-		(*wallsIterator).Update((float)timer.GetElapsedSeconds());
-		if ((*wallsIterator).isCollidingWith(player->rectangle)) {
+		if (result.playerHitWall)
+		{
 			collisionString = L"There is a collision with the wall";
 
 			gamePad->SetVibration(0, 0.75f, 0.75f);
 		}
 	}
+#pragma endregion Simple GamePad rumble on crash
 
-	//Collisions of Enemies with Player
+	// An allocation after warm-up is a hitch waiting to happen; give the
+	// code that made it scratch memory from a FrameArena or reserve up front.
+	// The input log is inside the check: it reserves on the first tick and
+	// stops recording rather than grow.
+	if (m_steadyTicks < SteadyTickWarmup)
+	{
+		m_steadyTicks++;
+	}
+#ifdef _DEBUG
+	else
+	{
+		assert(allocations.GetCount() == 0);
+	}
+#endif
+}
+
+// Reads the gamepad and the keyboard into the player's input. Update reads
+// it every tick; with late latching Render reads it again. Movement follows
+// the keys held down in keys.
+Simulation::PlayerInput Sample3DSceneRenderer::ReadPlayerInput(const Keyboard::State& keys)
+{
+	Simulation::PlayerInput input;
 
-	for (auto &enemy : enemiesVector)
+#pragma region Gamepad
 	{
-		if (enemy.isCollidingWith(player->rectangle))
+		PROFILE_ZONE("Gamepad");
+		//GamePad
+		auto statePlayerOne = gamePad->GetState(0);
+		if (statePlayerOne.IsConnected())
 		{
-			enemy.setVisibility (false);
+			if (statePlayerOne.IsDPadUpPressed()) {
+				input.Actions |= Simulation::InputAction_Up;
+				input.MoveY -= 1;
+			}
+
+			if (statePlayerOne.IsDPadDownPressed()) {
+				input.Actions |= Simulation::InputAction_Down;
+				input.MoveY += 1;
+			}
+
+			if (statePlayerOne.IsDPadLeftPressed()) {
+				input.Actions |= Simulation::InputAction_Left;
+				input.MoveX -= 1;
+			}
+			if (statePlayerOne.IsDPadRightPressed()) {
+				input.Actions |= Simulation::InputAction_Right;
+				input.MoveX += 1;
+			}
 		}
-
 	}
+#pragma endregion Handling the Gamepad Input
+	uint32_t gamepadActions = input.Actions;
 
 
-	//Collisions with Enemies with Walls
-
-
-
-
-#pragma endregion Handling collision detection + simple GamePad rumble on crash
-	
-#pragma region	Final update for enemies
-
-	for (auto it = enemiesVector.begin(); it < enemiesVector.end();)
+#pragma region Keyboard
 	{
-		if (it->isVisible() == false)
+		PROFILE_ZONE("Keyboard");
+		if (keys.S)
 		{
-			it = enemiesVector.erase(it);
+			input.Actions |= Simulation::InputAction_Down;
+			input.MoveY += 1;
 		}
-		else
+
+		if (keys.W)
 		{
-			it->Update((float)timer.GetElapsedSeconds());
-			it++;
+			input.Actions |= Simulation::InputAction_Up;
+			input.MoveY -= 1;
 		}
 
+		if (keys.A)
+		{
+			input.Actions |= Simulation::InputAction_Left;
+			input.MoveX -= 1;
+		}
+		if (keys.D)
+		{
+			input.Actions |= Simulation::InputAction_Right;
+			input.MoveX += 1;
+		}
 	}
-#pragma endregion
-
-
+#pragma endregion Handling Keyboard input
 
+	if (m_inputLatency)
+	{
+		// XInput is polled rather than sending events, so a gamepad change
+		// is seen, and timed, from the read that finds it.
+		if (gamepadActions != m_lastGamepadActions)
+		{
+			m_inputLatency->OnInput(Simulation::FrameTimings::Now());
+			m_lastGamepadActions = gamepadActions;
+		}
+		m_inputLatency->Consume();
+	}
 
+	return input;
 }
 
 void Sample3DSceneRenderer::NewAudioDevice()
@@ -373,13 +394,35 @@ void Sample3DSceneRenderer::NewAudioDevice()
 	}
 }
 
-void Sample3DSceneRenderer::Render()
+bool Sample3DSceneRenderer::SaveInputLog(const std::wstring& path) const
 {
+	if (inputLog.GetTickCount() == 0)
+		return false;
+
+	std::ofstream file(path, std::ios::binary);
+	return file && inputLog.Write(file);
+}
+
+void Sample3DSceneRenderer::Render(float interpolation)
+{
+	PROFILE_ZONE("Scene");
+	m_frameArena.Reset();
+
 	// Loading is asynchronous. Only draw geometry after it's loaded.
-	//if (!m_loadingComplete)
-	//{
-	//	return;
-	//}
+	m_assets->Update();
+	if (!m_loadingComplete)
+	{
+		if (!m_assets->IsRequiredSetResident())
+		{
+			RenderLoadingScreen();
+			return;
+		}
+		FinishLoading();
+	}
+
+	TakeIfLoaded(ships1Load, ships1Texture);
+	TakeIfLoaded(ships2Load, ships2Texture);
+	TakeIfLoaded(nebulasLoad, nebulasTexture);
 
 	auto context = m_deviceResources->GetD3DDeviceContext();
 
@@ -406,113 +449,260 @@ void Sample3DSceneRenderer::Render()
 	auto logicalSize = m_deviceResources->GetLogicalSize(); //DPI dependent resolution
 
 															// Draw sprites
-	m_sprites->Begin();
+	DrawStats::Get().BeginFrame();
+
+	{
+		PROFILE_ZONE("Background");
+		parallax->Draw(m_spriteRenderer.get(), Simulation::ParallaxPlane_Back, interpolation);
+	}
 
-	background->Draw(m_sprites.get());
-	clouds->Draw(m_sprites.get());
+	m_spriteRenderer->Begin();
 
 	//Drawing walls
 
-	for (auto& wall : wallsVector)
+	// The simulation runs at a fixed rate; draw everything between its last two updates.
 	{
-		wall.Draw(m_sprites.get());
+		PROFILE_ZONE("Walls");
+		// Walls generated ahead of the screen are not drawn.
+		auto& course = world->GetCourse();
+		size_t walls = course.GetVisibleCount();
+		for (size_t i = 0; i < walls; i++)
+		{
+			wallSprite->Draw(m_spriteRenderer.get(), course, i, interpolation);
+		}
 	}
 
 	//wall->Draw(m_sprites.get());
 	//wall2->Draw(m_sprites.get());
-	player->Draw(m_sprites.get());
+	auto playerPos = world->GetPlayer().getInterpolatedPosition(interpolation);
+	if (m_lateLatch)
+	{
+		// The last tick moved the player by its input; replace that move
+		// with the input of right now. Only the drawing changes, so the
+		// simulation, and its replay, do not depend on when frames render.
+		PROFILE_ZONE("Late latch");
+		// Read straight from the keyboard; m_keyboardTracker belongs to Update.
+		Simulation::PlayerInput latched = ReadPlayerInput(Keyboard::Get().GetState());
+		float reach = world->GetConfig().playerSpeed * m_tickSeconds * interpolation;
+		playerPos.x += (latched.MoveX - m_tickInput.MoveX) * reach;
+		playerPos.y += (latched.MoveY - m_tickInput.MoveY) * reach;
+	}
+	player->Draw(m_spriteRenderer.get(), XMFLOAT2(playerPos.x, playerPos.y));
 
-	for (auto& enemy : enemiesVector)
 	{
-		enemy.Draw(m_sprites.get());
+		PROFILE_ZONE("Enemies");
+		auto& enemies = world->GetEnemies();
+
+		// Every enemy's frame in one pass, at the time the positions are interpolated to.
+		double time = world->GetTime() - m_tickSeconds * (1.f - interpolation);
+		uint32_t* enemyFrames = m_frameArena.Allocate<uint32_t>(enemies.Size());
+		Simulation::EvaluateAnimationFrames(animationClips, enemies.Animation(), enemies.Size(), time, enemyFrames);
 
+		for (size_t i = 0; i < enemies.Size(); i++)
+		{
+			float x = Simulation::Lerp(enemies.PrevX()[i], enemies.X()[i], interpolation);
+			float y = Simulation::Lerp(enemies.PrevY()[i], enemies.Y()[i], interpolation);
+			enemySprite->Draw(m_spriteRenderer.get(), enemyFrames[i], XMFLOAT2(x, y));
+		}
 	}
 
 
-	clouds2->Draw(m_sprites.get());
+	{
+		// The batch is sorted and submitted here.
+		PROFILE_ZONE("SpriteBatch::End");
+		m_spriteRenderer->End();
+	}
+
+	{
+		PROFILE_ZONE("Foreground");
+		parallax->Draw(m_spriteRenderer.get(), Simulation::ParallaxPlane_Front, interpolation);
+	}
 
-	m_font->DrawString(m_sprites.get(), collisionString.c_str(), XMFLOAT2(100, 10), Colors::Yellow);
+	m_sprites->Begin();
+	m_font->DrawString(m_sprites.get(), collisionString, XMFLOAT2(100, 10), Colors::Yellow);
+
+	// Batching of the previous frame; text is not counted.
+	const DrawStatsFrame& drawStats = DrawStats::Get().GetLastFrame();
+	wchar_t drawStatsText[128];
+	swprintf_s(drawStatsText, L"%u sprites, %u draw calls, %u texture switches", drawStats.sprites, drawStats.drawCalls, drawStats.textureSwitches);
+	m_font->DrawString(m_sprites.get(), drawStatsText, XMFLOAT2(100, 50), Colors::Yellow);
+
+	// Memory per subsystem is in the report F7 writes; budgets are set in SimpleSample_DirectXTK_UWPMain.
+	Simulation::MemorySnapshot memory = Simulation::MemoryTracker::Get().Snapshot();
+	wchar_t memoryText[128];
+	if (memory.heapTracked)
+	{
+		swprintf_s(memoryText, L"%.1f MB heap, %.1f MB textures%s", memory.GetHeapBytes() / 1048576.0,
+			memory.tags[Simulation::MemoryTag_Textures].liveBytes / 1048576.0, memory.IsOverBudget() ? L", over budget" : L"");
+	}
+	else
+	{
+		swprintf_s(memoryText, L"%.1f MB textures%s", memory.tags[Simulation::MemoryTag_Textures].liveBytes / 1048576.0,
+			memory.IsOverBudget() ? L", over budget" : L"");
+	}
+	m_font->DrawString(m_sprites.get(), memoryText, XMFLOAT2(100, 90), memory.IsOverBudget() ? Colors::Red : Colors::Yellow);
 	m_sprites->End();
+	DrawStats::Get().EndFrame();
 
 
 }
 
-void Sample3DSceneRenderer::CreateDeviceDependentResources()
+void Sample3DSceneRenderer::RenderLoadingScreen()
 {
-	// Create DirectXTK objects
-	auto device = m_deviceResources->GetD3DDevice();
+	auto logicalSize = m_deviceResources->GetLogicalSize();
 
-	auto context = m_deviceResources->GetD3DDeviceContext();
+	const float barWidth = logicalSize.Width * 0.5f;
+	const float barHeight = 20.f;
+	RECT frame;
+	frame.left = (LONG)((logicalSize.Width - barWidth) * 0.5f);
+	frame.top = (LONG)((logicalSize.Height - barHeight) * 0.5f);
+	frame.right = frame.left + (LONG)barWidth;
+	frame.bottom = frame.top + (LONG)barHeight;
+	RECT filled = frame;
+	filled.right = frame.left + (LONG)(barWidth * m_assets->GetProgress());
 
+	wchar_t text[64];
+	swprintf_s(text, L"Loading %u/%u", m_assets->GetLoadedCount(), m_assets->GetTotalCount());
 
-	auto windowSize = m_deviceResources->GetOutputSize(); // physical screen resolution
-	auto logicalSize = m_deviceResources->GetLogicalSize(); //DPI dependent resolution
+	m_sprites->Begin();
+	m_sprites->Draw(m_placeholderTexture.Get(), frame, Colors::DarkSlateGray);
+	m_sprites->Draw(m_placeholderTexture.Get(), filled, Colors::Yellow);
+	m_font->DrawString(m_sprites.get(), text, XMFLOAT2((float)frame.left, (float)frame.bottom + 10.f), Colors::Yellow);
+	m_sprites->End();
+}
 
+// Creates the game objects once the required textures are resident; runs on the rendering thread.
+void Sample3DSceneRenderer::FinishLoading()
+{
+	auto logicalSize = m_deviceResources->GetLogicalSize();
 
-	m_sprites.reset(new SpriteBatch(context));
-	spriteBatchT1.reset(new SpriteBatch(context));
-	spriteBatchT2.reset(new SpriteBatch(context));
+	// get() rethrows if an asset failed to load, as the synchronous loaders did.
+	m_texture = m_textureLoad.get();
+	{
+		Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Assets);
+		gameplaySprites.Load(m_texture.Get(), L"Assets\\gameplay.pgss");
+	}
 
-	m_font.reset(new SpriteFont(device, L"Assets\\italic.spritefont"));
+	// The game objects, their layers and the simulation.
+	Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Entities);
+	RECT playerRect = FindAtlasSprite(gameplaySprites, L"player");
+	RECT pipeRect = FindAtlasSprite(gameplaySprites, L"pipe");
+	player.reset(new Player(m_texture.Get(), &playerRect));
+	wallSprite.reset(new Wall(m_texture.Get(), &pipeRect));
+
+	// The sheet names the clips and their frames; enemies play "enemy".
+	animationClips.Clear();
+	gameplaySprites.BuildClips(4.f, animationClips);
+	uint32_t enemyClip = animationClips.Find("enemy");
+	if (enemyClip == Simulation::InvalidAnimationClip)
+		throw std::exception("Gameplay atlas is missing the enemy clip, rebuild it with the GameplayAtlas target");
+
+	const Simulation::AnimationClip& clip = animationClips.Get(enemyClip);
+	enemySprite.reset(new Enemy(m_texture.Get(), gameplaySprites, animationClips.GetFrame(clip, 0)));
+
+	parallax.reset(new ParallaxBackground);
+	for (size_t i = 0; i < parallaxLoads.size(); i++)
+	{
+		parallax->AddLayer(parallaxLoads[i].get().Get(), ParallaxLayerTable[i].desc);
+	}
+
+	// The simulation survives a device loss; only create it the first time round.
+	if (!world)
+	{
+		Simulation::WorldConfig config;
+		config.screenSize = Simulation::Size(logicalSize.Width, logicalSize.Height);
+		config.playerWidth = player->getWidth();
+		config.playerHeight = player->getHeight();
+		config.enemyWidth = enemySprite->getWidth();
+		config.enemyHeight = enemySprite->getHeight();
+		config.wallWidth = wallSprite->getTextureWidth();
+		world.reset(new Simulation::World(config));
+
+		// Created once for the lifetime of the game; no threads are started per frame.
+		jobSystem.reset(new Simulation::JobSystem());
+		world->SetJobSystem(jobSystem.get());
+	}
 
+	// Clip ids are renumbered on every load, so point a surviving world at the new one.
+	world->SetEnemyClip(enemyClip);
 
-	DX::ThrowIfFailed(
-		CreateDDSTextureFromFile(device, L"Assets\\shipanimated.dds", nullptr, m_texture.ReleaseAndGetAddressOf())
-		);
-	player.reset(new Player(m_texture.Get()));
+	//set windows size for drawing the background
+	parallax->SetWindow(logicalSize.Width, logicalSize.Height);
+
+	wchar_t message[160];
+	const Simulation::ParallaxLayers& layers = parallax->GetLayers();
+	for (size_t i = 0; i < layers.GetCount(); i++)
+	{
+		Simulation::ParallaxFillCost cost = layers.GetFillCost(i);
+		swprintf_s(message, L"Parallax layer %u (%s): %u pixels, %.2f texels per pixel\n",
+			(unsigned int)i, ParallaxLayerTable[i].texture, cost.pixels, cost.texelsPerPixel);
+		OutputDebugStringW(message);
+	}
 
-	DX::ThrowIfFailed(
-		CreateDDSTextureFromFile(device, L"Assets\\background.dds", nullptr, backgroundTexture.ReleaseAndGetAddressOf())
-		);
-	background.reset(new ScrollingBackground);
-	background->Load(backgroundTexture.Get());
+	swprintf_s(message, L"Required assets resident after %.1f ms\n", m_assets->GetRequiredLoadSeconds() * 1000.0);
+	OutputDebugStringW(message);
 
+	m_loadingComplete = true;
+}
 
-	DX::ThrowIfFailed(
-		CreateDDSTextureFromFile(device, L"Assets\\clouds.dds", nullptr, cloudsTexture.ReleaseAndGetAddressOf())
-		);
-	clouds.reset(new ScrollingBackground);
-	clouds->Load(cloudsTexture.Get());
+void Sample3DSceneRenderer::CreateDeviceDependentResources()
+{
+	// Create DirectXTK objects
+	auto device = m_deviceResources->GetD3DDevice();
 
-	DX::ThrowIfFailed(
-		CreateDDSTextureFromFile(device, L"Assets\\clouds2.dds", nullptr, cloudsTexture2.ReleaseAndGetAddressOf())
-		);
-	clouds2.reset(new ScrollingBackground);
-	clouds2->Load(cloudsTexture2.Get());
+	auto context = m_deviceResources->GetD3DDeviceContext();
 
-	DX::ThrowIfFailed(
-		CreateDDSTextureFromFile(device, L"Assets\\enemyanimated.dds", nullptr, enemyTexture.ReleaseAndGetAddressOf())
-		);
-	
-	DX::ThrowIfFailed(
-		CreateWICTextureFromFile(device, L"Assets\\ships-0.png", nullptr, ships1Texture.ReleaseAndGetAddressOf())
-		);
-	DX::ThrowIfFailed(
-		CreateWICTextureFromFile(device, L"Assets\\ships-1.png", nullptr, ships2Texture.ReleaseAndGetAddressOf())
-		);
-	DX::ThrowIfFailed(
-		CreateWICTextureFromFile(device, L"Assets\\nebulas.png", nullptr, nebulasTexture.ReleaseAndGetAddressOf())
-		);
-	
+
+	auto windowSize = m_deviceResources->GetOutputSize(); // physical screen resolution
+	auto logicalSize = m_deviceResources->GetLogicalSize(); //DPI dependent resolution
 
 
-	DX::ThrowIfFailed(
-		CreateDDSTextureFromFile(device, L"Assets\\pipe.dds", nullptr, pipeTexture.ReleaseAndGetAddressOf())
-		);
+	m_sprites.reset(new SpriteBatch(context));
+	m_states.reset(new CommonStates(device));
+	m_spriteRenderer.reset(new SpriteBatchRenderer(m_sprites.get(), m_states.get()));
+	spriteBatchT1.reset(new SpriteBatch(context));
+	spriteBatchT2.reset(new SpriteBatch(context));
 
-	//Adding walls to vector
-	//wallsVector.push_back(Wall(logicalSize, XMFLOAT2(300, 0), pipeTexture.Get()));
-	wallsVector.emplace_back(Wall(logicalSize, XMFLOAT2(logicalSize.Width, 0), pipeTexture.Get()));
+	m_font.reset(new SpriteFont(device, L"Assets\\italic.spritefont"));
 
+	// The loading screen is drawn with the font and a white pixel, both ready before the first frame.
+	static const uint32_t white = 0xffffffff;
+	D3D11_TEXTURE2D_DESC placeholderDesc = {};
+	placeholderDesc.Width = 1;
+	placeholderDesc.Height = 1;
+	placeholderDesc.MipLevels = 1;
+	placeholderDesc.ArraySize = 1;
+	placeholderDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	placeholderDesc.SampleDesc.Count = 1;
+	placeholderDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	placeholderDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	D3D11_SUBRESOURCE_DATA placeholderData = { &white, sizeof(white), 0 };
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> placeholder;
+	DX::ThrowIfFailed(device->CreateTexture2D(&placeholderDesc, &placeholderData, placeholder.GetAddressOf()));
+	DX::TrackTextureMemory(placeholder.Get());
+	DX::ThrowIfFailed(device->CreateShaderResourceView(placeholder.Get(), nullptr, m_placeholderTexture.ReleaseAndGetAddressOf()));
+
+	// Every file is read and decoded in parallel; Render creates the game
+	// objects when the required ones are in. The sprite sheets are not
+	// drawn yet, so they finish loading behind gameplay.
+	m_loadingComplete = false;
+	m_textureLoad = m_assets->LoadTexture(L"Assets\\gameplay.dds");
+	parallaxLoads.clear();
+	for (const auto& layer : ParallaxLayerTable)
+	{
+		parallaxLoads.push_back(m_assets->LoadTexture(layer.texture));
+	}
+	ships1Load = m_assets->LoadTexture(L"Assets\\ships-0.png", false);
+	ships2Load = m_assets->LoadTexture(L"Assets\\ships-1.png", false);
+	nebulasLoad = m_assets->LoadTexture(L"Assets\\nebulas.png", false);
 
-	//set windows size for drawing the background
-	background->SetWindow(logicalSize.Width, logicalSize.Height);
-	clouds->SetWindow(logicalSize.Width, logicalSize.Height);
-	clouds2->SetWindow(logicalSize.Width, logicalSize.Height);
 
 
 	//Gamepad
-	gamePad.reset(new GamePad);
+	{
+		Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Input);
+		gamePad.reset(new GamePad);
+	}
 	
 	// Load shaders asynchronously.
 	//auto loadVSTask = DX::ReadDataAsync(L"SampleVertexShader.cso");
@@ -559,14 +749,22 @@ void Sample3DSceneRenderer::ReleaseDeviceDependentResources()
 
 
 	//TODO:
+	m_spriteRenderer.reset();
 	m_sprites.reset();
 	m_font.reset();
 	m_texture.Reset();
-	backgroundTexture.Reset();
-	cloudsTexture.Reset();
-	cloudsTexture2.Reset();
-	pipeTexture.Reset();
-	enemyTexture.Reset();
+	gameplaySprites.Load(nullptr, nullptr);
+	m_states.reset();
+	parallax.reset();
+	parallaxLoads.clear();
+	ships1Texture.Reset();
+	ships2Texture.Reset();
+	nebulasTexture.Reset();
+	m_placeholderTexture.Reset();
+
+	// Loads still in flight belong to the lost device.
+	m_assets->Reset();
+	m_loadingComplete = false;
 
 
 }
\ No newline at end of file
@@ -3,12 +3,17 @@
 #include "SpriteBatch.h"
 #include "SpriteFont.h"
 #include "AnimatedTexture.h"
-#include "ScrollingBackground.hpp"
+#include "ParallaxBackground.hpp"
+#include "SpriteBatchRenderer.hpp"
 #include "Player.hpp"
 #include "Wall.hpp"
 #include "Enemy.hpp"
+#include "Simulation/World.hpp"
+#include "Simulation/InputLog.hpp"
+#include "Simulation/InputLatency.hpp"
 
 #include "SimpleMath.h"
+#include "CommonStates.h"
 #include "Audio.h"
 #include "GamePad.h"
 #include "Keyboard.h"
@@ -18,6 +23,8 @@
 #include "..\Common\DeviceResources.h"
 //#include "ShaderStructures.h"
 #include "..\Common\StepTimer.h"
+#include "..\Common\SpriteSheet.hpp"
+#include "..\Common\AssetLoader.h"
 
 #include "DDSTextureLoader.h"
 #include "WICTextureLoader.h"
@@ -35,7 +42,7 @@ namespace SimpleSample_DirectXTK_UWP
 
 		void ReleaseDeviceDependentResources();
 		void Update(DX::StepTimer const& timer);
-		void Render();
+		void Render(float interpolation);
 		
 		//void StartTracking();
 		//void TrackingUpdate(float positionX);
@@ -45,8 +52,23 @@ namespace SimpleSample_DirectXTK_UWP
 		// Signals a new audio device is available
 		void NewAudioDevice();
 
+		// Writes the input of this session, for replaying with Tools\ReplayRunner.
+		bool SaveInputLog(const std::wstring& path) const;
+
+		// Not owned; told when the player's input is read, null stops measuring.
+		void SetInputLatency(Simulation::InputLatency* latency)	{ m_inputLatency = latency; }
+
+		// Late latching reads the movement input again right before the
+		// player is drawn and draws the player where it would be had the
+		// last tick used it. The simulation still sees the input of Update.
+		void SetLateLatch(bool enabled)							{ m_lateLatch = enabled; }
+		bool IsLateLatchEnabled() const							{ return m_lateLatch; }
+
 	private:
 		//void Rotate(float radians);
+		void FinishLoading();
+		void RenderLoadingScreen();
+		Simulation::PlayerInput ReadPlayerInput(const DirectX::Keyboard::State& keys);
 
 	private:
 		// Cached pointer to device resources.
@@ -75,6 +97,16 @@ namespace SimpleSample_DirectXTK_UWP
 
 		std::unique_ptr<DirectX::SpriteFont>                                    m_font;
 
+		// Textures are read and decoded in the background; until the required
+		// ones are resident Render draws a progress bar with this white pixel.
+		std::unique_ptr<DX::AssetLoader>										m_assets;
+		std::shared_future<DX::AssetLoader::Texture>							m_textureLoad;
+		std::vector<std::shared_future<DX::AssetLoader::Texture>>				parallaxLoads;
+		std::shared_future<DX::AssetLoader::Texture>							ships1Load;
+		std::shared_future<DX::AssetLoader::Texture>							ships2Load;
+		std::shared_future<DX::AssetLoader::Texture>							nebulasLoad;
+		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>						m_placeholderTexture;
+
 		//Sound
 		std::unique_ptr<DirectX::AudioEngine>                                   m_audEngine;
 		std::unique_ptr<DirectX::WaveBank>                                      m_waveBank;
@@ -82,19 +114,19 @@ namespace SimpleSample_DirectXTK_UWP
 		std::unique_ptr<DirectX::SoundEffectInstance>                           m_effect1;
 		std::unique_ptr<DirectX::SoundEffectInstance>                           m_effect2;
 
+		// Atlas holding the player, enemy and pipe sprites (Assets\gameplay.dds,
+		// built by AtlasPacker), so the gameplay layer is drawn with one texture.
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>                        m_texture;
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>						enemyTexture;
+		SpriteSheet																gameplaySprites;
 		std::unique_ptr<AnimatedTexture>										animation;
 
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>                        pipeTexture;
-
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>						backgroundTexture;
-		std::unique_ptr<ScrollingBackground>									background;
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>						cloudsTexture;
-		std::unique_ptr<ScrollingBackground>									clouds;
+		// Background and foreground layers from the table in Sample3DSceneRenderer.cpp,
+		// drawn with the wrapping sampler of m_states.
+		std::unique_ptr<ParallaxBackground>										parallax;
+		std::unique_ptr<DirectX::CommonStates>									m_states;
 
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>						cloudsTexture2;
-		std::unique_ptr<ScrollingBackground>									clouds2;
+		// The gameplay sprites and layers go through this, over m_sprites and m_states.
+		std::unique_ptr<SpriteBatchRenderer>									m_spriteRenderer;
 		std::unique_ptr<Player>													player;
 
 		//SpriteSheets
@@ -103,10 +135,33 @@ namespace SimpleSample_DirectXTK_UWP
 		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>						nebulasTexture;
 
 		std::unique_ptr<GamePad>												gamePad;
-		std::vector<Wall>														wallsVector;
-		std::vector<Enemy>														enemiesVector;
+		std::unique_ptr<Wall>													wallSprite;
+		std::unique_ptr<Enemy>													enemySprite;
+
+		// Animations shared by the enemies.
+		Simulation::AnimationClips												animationClips;
+
+		// Scratch memory of one Render call, such as each enemy's frame.
+		Simulation::FrameArena													m_frameArena;
+
+		// Gameplay state, independent of the device, and the worker threads it runs on.
+		std::unique_ptr<Simulation::JobSystem>									jobSystem;
+		std::unique_ptr<Simulation::World>										world;
+		Simulation::InputLog													inputLog;
+
+		Simulation::InputLatency*												m_inputLatency;
+		bool																	m_lateLatch;
+		Simulation::PlayerInput													m_tickInput;		// Read by the last Update.
+		float																	m_tickSeconds;
+		uint32_t																m_lastGamepadActions;
+		DirectX::Keyboard::KeyboardStateTracker									m_keyboardTracker;
+
+		// Points at a string literal, so the tick does not allocate for it.
+		const wchar_t*															collisionString;
 
-		std::wstring															collisionString;
+		// Ticks since loading or a resize; debug builds check that the ticks
+		// after the first SteadyTickWarmup do not allocate.
+		uint32_t																m_steadyTicks;
 
 		// Variables used with the rendering loop.
 		uint32_t                                                                m_audioEvent;
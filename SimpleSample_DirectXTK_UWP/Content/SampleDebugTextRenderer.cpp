@@ -75,7 +75,17 @@ void SampleDebugTextRenderer::Update(DX::StepTimer const& timer)
     // Update display text.
     uint32 fps = timer.GetFramesPerSecond();
 
-    m_textFPS = (fps > 0) ? std::to_wstring(fps) + L" FPS" : L" - FPS";
+    wchar_t text[32];
+    if (fps > 0)
+        swprintf_s(text, L"%u FPS", fps);
+    else
+        wcscpy_s(text, L" - FPS");
+
+    // The count changes about once a second; keep the layout until then.
+    if (m_textLayoutFPS && m_textFPS == text)
+        return;
+
+    m_textFPS = text;
 
     DX::ThrowIfFailed(
         m_deviceResources->GetDWriteFactory()->CreateTextLayout(
@@ -94,7 +104,7 @@ void SampleDebugTextRenderer::Update(DX::StepTimer const& timer)
 }
 
 // Updates the text to be displayed.
-void SampleDebugTextRenderer::Update(std::vector<PlayerInputData>* playerInputs, unsigned int playersAttached)
+void SampleDebugTextRenderer::Update(const PlayerActions& playerActions, unsigned int playersAttached)
 {
     m_playersAttached = playersAttached;
 
@@ -107,12 +117,8 @@ void SampleDebugTextRenderer::Update(std::vector<PlayerInputData>* playerInputs,
         if (!playerAttached)
             continue;
 
-        for (unsigned int j = 0; j < playerInputs->size(); j++)
+        for (const PlayerInputData& playerAction : playerActions.ForPlayer(i))
         {
-            PlayerInputData playerAction = (*playerInputs)[j];
-
-            if (playerAction.ID != i) continue;
-
             switch (playerAction.PlayerAction)
             {
             case PLAYER_ACTION_TYPES::INPUT_FIRE_PRESSED:
@@ -23,7 +23,7 @@ namespace SimpleSample_DirectXTK_UWP
         void CreateDeviceDependentResources();
         void ReleaseDeviceDependentResources();
         void Update(DX::StepTimer const& timer);
-        void Update(std::vector<PlayerInputData>* playerInput, unsigned int playersAttached);
+        void Update(const PlayerActions& playerActions, unsigned int playersAttached);
         void Render();
 
     private:
@@ -2,6 +2,7 @@
 #include "SampleFpsTextRenderer.h"
 
 #include "Common/DirectXHelper.h"
+#include "Simulation/Profiler.hpp"
 
 using namespace SimpleSample_DirectXTK_UWP;
 using namespace Microsoft::WRL;
@@ -9,6 +10,7 @@ using namespace Microsoft::WRL;
 // Initializes D2D resources used for text rendering.
 SampleFpsTextRenderer::SampleFpsTextRenderer(const std::shared_ptr<DX::DeviceResources>& deviceResources) : 
 	m_text(L""),
+	m_refreshSeconds(0.0),
 	m_deviceResources(deviceResources)
 {
 	ZeroMemory(&m_textMetrics, sizeof(DWRITE_TEXT_METRICS));
@@ -22,7 +24,7 @@ SampleFpsTextRenderer::SampleFpsTextRenderer(const std::shared_ptr<DX::DeviceRes
 			DWRITE_FONT_WEIGHT_LIGHT,
 			DWRITE_FONT_STYLE_NORMAL,
 			DWRITE_FONT_STRETCH_NORMAL,
-			32.0f,
+			20.0f,
 			L"en-US",
 			&textFormat
 			)
@@ -44,12 +46,39 @@ SampleFpsTextRenderer::SampleFpsTextRenderer(const std::shared_ptr<DX::DeviceRes
 }
 
 // Updates the text to be displayed.
-void SampleFpsTextRenderer::Update(DX::StepTimer const& timer)
+void SampleFpsTextRenderer::Update(DX::StepTimer const& timer, const Simulation::FrameTimings& timings, const Simulation::InputLatency& latency)
 {
-	// Update display text.
+	PROFILE_ZONE("FPS text update");
+
+	// The percentiles cover the last few seconds; sample them twice a
+	// second so they can be read, and only lay the text out again when
+	// what is shown has changed.
+	m_refreshSeconds -= timer.GetElapsedSeconds();
+	if (m_textLayout && m_refreshSeconds > 0.0)
+	{
+		return;
+	}
+	m_refreshSeconds = 0.5;
+
+	wchar_t text[320];
 	uint32 fps = timer.GetFramesPerSecond();
+	int length = (fps > 0) ? swprintf_s(text, L"%u FPS", fps) : swprintf_s(text, L" - FPS");
+	length += swprintf_s(text + length, _countof(text) - length, L"\nms  p50 / p95 / p99 / max");
+	for (int phase = 0; phase < Simulation::FramePhase_Count; phase++)
+	{
+		Simulation::FrameTimeStats stats = timings.GetStats((Simulation::FramePhase)phase);
+		length += swprintf_s(text + length, _countof(text) - length, L"\n%S  %.2f / %.2f / %.2f / %.2f",
+			Simulation::GetFramePhaseName((Simulation::FramePhase)phase), stats.p50, stats.p95, stats.p99, stats.max);
+	}
+	Simulation::FrameTimeStats input = latency.GetStats();
+	length += swprintf_s(text + length, _countof(text) - length, L"\ninput to present  %.2f / %.2f / %.2f / %.2f",
+		input.p50, input.p95, input.p99, input.max);
 
-	m_text = (fps > 0) ? std::to_wstring(fps) + L" FPS" : L" - FPS";
+	if (m_textLayout && m_text == text)
+	{
+		return;
+	}
+	m_text = text;
 
 	ComPtr<IDWriteTextLayout> textLayout;
 	DX::ThrowIfFailed(
@@ -57,8 +86,8 @@ void SampleFpsTextRenderer::Update(DX::StepTimer const& timer)
 			m_text.c_str(),
 			(uint32) m_text.length(),
 			m_textFormat.Get(),
-			240.0f, // Max width of the input text.
-			50.0f, // Max height of the input text.
+			400.0f, // Max width of the input text.
+			150.0f, // Max height of the input text.
 			&textLayout
 			)
 		);
@@ -75,6 +104,8 @@ void SampleFpsTextRenderer::Update(DX::StepTimer const& timer)
 // Renders a frame to the screen.
 void SampleFpsTextRenderer::Render()
 {
+	PROFILE_ZONE("FPS text (D2D)");
+
 	ID2D1DeviceContext* context = m_deviceResources->GetD2DDeviceContext();
 	Windows::Foundation::Size logicalSize = m_deviceResources->GetLogicalSize();
 
@@ -3,17 +3,19 @@
 #include <string>
 #include "..\Common\DeviceResources.h"
 #include "..\Common\StepTimer.h"
+#include "..\Simulation\FrameTimings.hpp"
+#include "..\Simulation\InputLatency.hpp"
 
 namespace SimpleSample_DirectXTK_UWP
 {
-	// Renders the current FPS value in the bottom right corner of the screen using Direct2D and DirectWrite.
+	// Renders the current FPS value, frame time and input latency percentiles in the bottom right corner of the screen using Direct2D and DirectWrite.
 	class SampleFpsTextRenderer
 	{
 	public:
 		SampleFpsTextRenderer(const std::shared_ptr<DX::DeviceResources>& deviceResources);
 		void CreateDeviceDependentResources();
 		void ReleaseDeviceDependentResources();
-		void Update(DX::StepTimer const& timer);
+		void Update(DX::StepTimer const& timer, const Simulation::FrameTimings& timings, const Simulation::InputLatency& latency);
 		void Render();
 
 	private:
@@ -22,6 +24,7 @@ namespace SimpleSample_DirectXTK_UWP
 
 		// Resources related to text rendering.
 		std::wstring                                    m_text;
+		double                                          m_refreshSeconds;
 		DWRITE_TEXT_METRICS	                            m_textMetrics;
 		Microsoft::WRL::ComPtr<ID2D1SolidColorBrush>    m_whiteBrush;
 		Microsoft::WRL::ComPtr<ID2D1DrawingStateBlock1> m_stateBlock;
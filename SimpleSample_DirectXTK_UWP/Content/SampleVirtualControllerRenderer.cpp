@@ -54,16 +54,15 @@ void SampleVirtualControllerRenderer::Update(DX::StepTimer const& timer)
 
 // Updates the display based on this frame's input.
 // This method is not called by the OverlayManager class.
-void SampleVirtualControllerRenderer::Update(std::vector<PlayerInputData>* playerInput)
+void SampleVirtualControllerRenderer::Update(const PlayerActions& playerActions)
 {
     m_touchControls[PLAYER_ACTION_TYPES::INPUT_MOVE].PointerRawX = -1;
     m_touchControls[PLAYER_ACTION_TYPES::INPUT_FIRE_DOWN].ButtonPressed = false;
     m_touchControls[PLAYER_ACTION_TYPES::INPUT_JUMP_DOWN].ButtonPressed = false;
 
-    for (unsigned int i = 0; i < playerInput->size(); i++)
+    // Touch input is always reported for the pointer player.
+    for (const PlayerInputData& playerAction : playerActions.ForPlayer(DEFAULT_POINTER_PLAYER_ID))
     {
-        PlayerInputData playerAction = (*playerInput)[i];
-
         if (!playerAction.IsTouchAction)
             continue;
 
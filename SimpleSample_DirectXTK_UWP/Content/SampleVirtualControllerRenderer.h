@@ -24,7 +24,7 @@ namespace SimpleSample_DirectXTK_UWP
         void CreateDeviceDependentResources();
         void ReleaseDeviceDependentResources();
         void Update(DX::StepTimer const& timer);
-        void Update(std::vector<PlayerInputData>* playerInput);
+        void Update(const PlayerActions& playerActions);
         void Render();
 
         HRESULT AddTouchControlRegion(TouchControlRegion& touchControlRegion);
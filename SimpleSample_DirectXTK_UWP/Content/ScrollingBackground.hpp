@@ -21,8 +21,13 @@
 #include <thread>
 #include <wrl.h>
 
+#include "Common/SpriteRenderer.hpp"
+
 using namespace DirectX;
 
+// Tiles a layer by drawing it twice side by side. Layers that are a whole
+// texture go through ParallaxBackground, which needs one wrapped quad; this
+// is for a layer that is a region of an atlas, where wrapping cannot work.
 class ScrollingBackground
 {
 public:
@@ -37,7 +42,8 @@ public:
     {
     }
 
-    void Load( ID3D11ShaderResourceView* texture )
+    // region is the layer's rectangle when texture is an atlas; nullptr uses the whole texture.
+    void Load( ID3D11ShaderResourceView* texture, const RECT* region = nullptr )
     {
         mTexture = texture;
 
@@ -58,12 +64,23 @@ public:
             D3D11_TEXTURE2D_DESC desc;
             tex2D->GetDesc( &desc );
 
-            mTextureWidth = desc.Width;
-            mTextureHeight = desc.Height;
+            if ( region )
+            {
+                mSourceRect = *region;
+            }
+            else
+            {
+                mSourceRect.left = 0;
+                mSourceRect.top = 0;
+                mSourceRect.right = LONG( desc.Width );
+                mSourceRect.bottom = LONG( desc.Height );
+            }
+
+            mTextureWidth = int( mSourceRect.right - mSourceRect.left );
+            mTextureHeight = int( mSourceRect.bottom - mSourceRect.top );
 
-            mTextureSize.x = float( desc.Width );
-            //mTextureSize.y = float( desc.Height );
-			mTextureSize.y = 0.f; //Wrong - loss of usefull data
+            mTextureSize.x = float( mTextureWidth );
+            mTextureSize.y = float( mTextureHeight );
 
             //mOrigin.x = desc.Width / 2.f;
 			mOrigin.x = 0.f;
@@ -92,23 +109,20 @@ public:
 		mScreenPos.x = fmodf(mScreenPos.x, float(mTextureWidth*scalingFactor.x));
     }
 
-    void Draw( DirectX::SpriteBatch* batch )
+    void Draw( SpriteRenderer* renderer )
     {
-        
-        XMVECTOR screenPos = XMLoadFloat2( &mScreenPos );
-        XMVECTOR origin = XMLoadFloat2( &mOrigin );
-		XMVECTOR scale = XMLoadFloat2(&scalingFactor);
-
-
-            batch->Draw( mTexture.Get(), screenPos, nullptr,
-                         Colors::White, 0.f, origin, scale, SpriteEffects_None, 0.f );
-
-
-        XMVECTOR textureSize = XMLoadFloat2( &mTextureSize ); //TODO:edit the vector to zero one dimmension, but not lose data
-		
-        batch->Draw( mTexture.Get(), XMLoadFloat2(&XMFLOAT2(mScreenPos.x+((float)mTextureWidth*scalingFactor.x),0)), nullptr,
-                     Colors::White, 0.f, origin, scale, SpriteEffects_None, 0.f );
-
+        SpriteRect source( mSourceRect.left, mSourceRect.top, mSourceRect.right, mSourceRect.bottom );
+
+        SpriteDraw sprite( mTexture.Get(), source, mScreenPos.x, mScreenPos.y );
+        sprite.originX = mOrigin.x;
+        sprite.originY = mOrigin.y;
+        sprite.scaleX = scalingFactor.x;
+        sprite.scaleY = scalingFactor.y;
+        renderer->Draw( sprite );
+
+        // The second copy follows the first along x only.
+        sprite.x = mScreenPos.x + mTextureSize.x * scalingFactor.x;
+        renderer->Draw( sprite );
     }
 
 private:
@@ -116,6 +130,7 @@ private:
 	int													mScreenWidth;
     int                                                 mTextureWidth;
     int                                                 mTextureHeight;
+    RECT                                                mSourceRect;
     DirectX::XMFLOAT2                                   mScreenPos;
     DirectX::XMFLOAT2                                   mTextureSize;
     DirectX::XMFLOAT2                                   mOrigin;
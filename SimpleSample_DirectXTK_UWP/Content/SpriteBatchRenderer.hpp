@@ -0,0 +1,51 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <CommonStates.h>
+#include <SpriteBatch.h>
+
+#include "Common/DrawStats.hpp"
+#include "Common/SpriteRenderer.hpp"
+
+using namespace DirectX;
+
+// SpriteRenderer on the GPU: hands sprites to SpriteBatch in its deferred
+// sort mode and reports them to DrawStats. Textures are shader resource
+// views. Neither the batch nor the states are owned; text is still drawn
+// on the batch directly, outside Begin and End.
+class SpriteBatchRenderer : public SpriteRenderer
+{
+public:
+	SpriteBatchRenderer(SpriteBatch* batch, CommonStates* states) : m_batch(batch), m_states(states)
+	{
+	}
+
+	void Begin(SpriteSampler sampler = SpriteSampler_Clamp) override
+	{
+		// nullptr is SpriteBatch's default, linear clamp.
+		m_batch->Begin(SpriteSortMode_Deferred, nullptr, sampler == SpriteSampler_Wrap ? m_states->LinearWrap() : nullptr);
+	}
+
+	void Draw(const SpriteDraw& sprite) override
+	{
+		auto texture = static_cast<ID3D11ShaderResourceView*>(sprite.texture);
+		RECT source = { sprite.source.left, sprite.source.top, sprite.source.right, sprite.source.bottom };
+		XMVECTORF32 color = { sprite.color.r, sprite.color.g, sprite.color.b, sprite.color.a };
+
+		DrawStats::Get().Note(texture);
+		m_batch->Draw(texture, XMFLOAT2(sprite.x, sprite.y), &source, color, sprite.rotation,
+			XMFLOAT2(sprite.originX, sprite.originY), XMFLOAT2(sprite.scaleX, sprite.scaleY), SpriteEffects_None, sprite.depth);
+	}
+
+	void End() override
+	{
+		m_batch->End();
+		DrawStats::Get().EndBatch();
+	}
+
+private:
+	SpriteBatch*								m_batch;
+	CommonStates*								m_states;
+};
@@ -1,4 +1,4 @@
-//For educational use only
+﻿//For educational use only
 //NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
 
 #pragma once
@@ -9,20 +9,22 @@
 #include <DirectXMath.h>
 #include <SimpleMath.h>
 
-#include <random>
+#include "Common/SpriteRenderer.hpp"
+#include "Simulation/Course.hpp"
 
 using namespace DirectX;
 
+// Draws the walls of a Simulation::Course by stretching the pipe texture
+// over their upper and lower rectangles. Movement and gap placement live in
+// the simulation.
 class Wall
 {
 
 public:
 
-	Wall(Windows::Foundation::Size screenResolution, XMFLOAT2 position, ID3D11ShaderResourceView* pipeTexture)
-		: screenSize(screenResolution),
-		m_origin(0, 0),
-		gapMinHeight(256),
-		moveSpeed(10)
+	// region is the pipe's rectangle when pipeTexture is an atlas; nullptr uses the whole texture.
+	Wall(ID3D11ShaderResourceView* pipeTexture, const RECT* region = nullptr)
+		: m_origin(0, 0)
 	{
 
 		m_mainTexture = pipeTexture;
@@ -31,130 +33,63 @@ public:
 
 		pipeTexture->GetResource(res.GetAddressOf());
 		Microsoft::WRL::ComPtr<ID3D11Texture2D> text2D;
-		
+
 		res.As(&text2D);
 		text2D->GetDesc(&mainTextureDescription);
 
-		//set up the main rectangle
-		wallRect.X = position.x;
-		wallRect.Y = position.y;
-		wallRect.Width = mainTextureDescription.Width;
-		wallRect.Height = screenSize.Height;
-
-		//Initialize randomness
-		randomizeGap();
-
-	}
-
-
-	void Update(float elapsedTime)
-	{
-		wallRect.X -= moveSpeed;
-		upper.X = lower.X = gap.X = wallRect.X;
-		if (wallRect.X + wallRect.Width < 0)
+		if (region)
 		{
-			randomizeGap();
-			wallRect.X = screenSize.Width;
+			m_sourceRect = *region;
 		}
-
-	}
-
-	void Draw(DirectX::SpriteBatch *batch)
-	{
-
-		XMVECTOR origin = XMLoadFloat2(&m_origin);
-
-		//Draw upper part of the wall
-		batch->Draw(m_mainTexture.Get(), XMLoadFloat2(&XMFLOAT2(upper.X, upper.Y)), nullptr,
-			Colors::White, 0.f, origin, XMLoadFloat2(&upperScalingFactor), SpriteEffects_None, 0.f);
-
-		//Draw lower part of the wall
-		batch->Draw(m_mainTexture.Get(), XMLoadFloat2(&XMFLOAT2(lower.X, lower.Y)), nullptr,
-		Colors::White, 0.f, origin, XMLoadFloat2(&lowerScalingFactor), SpriteEffects_None, 0.f);
-
-	}
-
-	bool isCollidingWith(Windows::Foundation::Rect rect)
-	{
-		if (upper.IntersectsWith(rect))
-		{
-			return true;
-		}
-
-		else if (lower.IntersectsWith(rect))
-		{
-			return true;
-		}
-
 		else
 		{
-			return false;
+			m_sourceRect.left = 0;
+			m_sourceRect.top = 0;
+			m_sourceRect.right = (LONG)mainTextureDescription.Width;
+			m_sourceRect.bottom = (LONG)mainTextureDescription.Height;
 		}
 	}
 
-private:
-	//functions
-	void randomizeGap()
+	int getTextureWidth() const
 	{
-		//set up the rectangle for gap
-		//RANDOMIZE, DO NOT USE rand() !!!!!!!!!
-		
-		
-		std::random_device rd;
-		std::mt19937 mt;
-		mt.seed(rd());
-
-		std::uniform_int_distribution<int> dist(0, (int)screenSize.Height - gapMinHeight); //Choose distribution of the result (inclusive,inclusive)
-
-		gap.X = wallRect.X;
-		gap.Y = dist(mt);
-		gap.Height = gapMinHeight;
-		gap.Width = mainTextureDescription.Width;
-
-		//set up rectangle for textures
-		upper.X = wallRect.X;
-		upper.Y = 0;
-		upper.Width = mainTextureDescription.Width;
-		upper.Height = gap.Y;
-		upperScalingFactor.x = 1;
-		upperScalingFactor.y = upper.Height / mainTextureDescription.Height;
-
-		lower.X = wallRect.X;
-		lower.Y = gap.Y + gap.Height;
-		lower.Width = mainTextureDescription.Width;
-		lower.Height = screenSize.Height - (upper.Height + gap.Height);
-		lowerScalingFactor.x = 1;
-		lowerScalingFactor.y = lower.Height / mainTextureDescription.Height;
-
-
-
+		return (int)(m_sourceRect.right - m_sourceRect.left);
 	}
 
+	int getTextureHeight() const
+	{
+		return (int)(m_sourceRect.bottom - m_sourceRect.top);
+	}
 
-	//bounding box of the Wall
-	Windows::Foundation::Rect							wallRect;
-	Windows::Foundation::Rect							gap;
-	Windows::Foundation::Rect							upper;
-	XMFLOAT2											upperScalingFactor;
-
-	Windows::Foundation::Rect							lower;
-	XMFLOAT2											lowerScalingFactor;
+	// Draws wall number index of course; alpha blends it between its
+	// previous and current tick position.
+	void Draw(SpriteRenderer* renderer, const Simulation::Course& course, size_t index, float alpha = 1.f)
+	{
+		Simulation::Rect upper = course.GetUpperRect(index);
+		Simulation::Rect lower = course.GetLowerRect(index);
+		upper.X = lower.X = course.GetInterpolatedX(index, alpha);
 
-	Windows::Foundation::Size							screenSize;
+		SpriteRect source(m_sourceRect.left, m_sourceRect.top, m_sourceRect.right, m_sourceRect.bottom);
 
-	int													gapMinHeight;
+		//Draw upper part of the wall
+		SpriteDraw sprite(m_mainTexture.Get(), source, upper.X, upper.Y);
+		sprite.originX = m_origin.x;
+		sprite.originY = m_origin.y;
+		sprite.scaleY = upper.Height / getTextureHeight();
+		renderer->Draw(sprite);
 
+		//Draw lower part of the wall
+		sprite.y = lower.Y;
+		sprite.scaleY = lower.Height / getTextureHeight();
+		renderer->Draw(sprite);
 
-	float												moveSpeed;
+	}
 
+private:
 	//texture of the wall
 	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>	m_mainTexture;
 	D3D11_TEXTURE2D_DESC								mainTextureDescription;
+	RECT												m_sourceRect;
 
 	XMFLOAT2											m_origin;
 
-	//Randomizer
-	//std::random_device rd; // create random device - will generate random number
-	//std::mt19937 mt; // use random number to seed Mersenne Twister 19937 generator
-
-};
\ No newline at end of file
+};
@@ -1,12 +1,38 @@
 ﻿#include "pch.h"
 #include "SimpleSample_DirectXTK_UWPMain.h"
 #include "Common\DirectXHelper.h"
+#include "Simulation\Profiler.hpp"
+#include "Simulation\MemoryTracker.hpp"
+
+#include <fstream>
 
 using namespace SimpleSample_DirectXTK_UWP;
 using namespace Windows::Foundation;
 using namespace Windows::System::Threading;
 using namespace Concurrency;
 
+namespace
+{
+	// What the game may use on the smallest device it targets, 1 GB phones.
+	// The memory report marks the subsystems over their budget, and so does
+	// the memory line of the scene.
+	struct MemoryBudgetEntry
+	{
+		Simulation::MemoryTag	tag;
+		uint64_t				bytes;
+	};
+
+	const MemoryBudgetEntry MemoryBudgetTable[] =
+	{
+		{ Simulation::MemoryTag_Input,		2ull << 20 },
+		{ Simulation::MemoryTag_Entities,	16ull << 20 },
+		{ Simulation::MemoryTag_Assets,		32ull << 20 },
+		{ Simulation::MemoryTag_Audio,		16ull << 20 },
+		{ Simulation::MemoryTag_Overlays,	4ull << 20 },
+		{ Simulation::MemoryTag_Textures,	96ull << 20 },
+	};
+}
+
 // Loads and initializes application assets when the application is loaded.
 SimpleSample_DirectXTK_UWPMain::SimpleSample_DirectXTK_UWPMain(const std::shared_ptr<DX::DeviceResources>& deviceResources) :
 	m_deviceResources(deviceResources)
@@ -14,17 +40,25 @@ SimpleSample_DirectXTK_UWPMain::SimpleSample_DirectXTK_UWPMain(const std::shared
 	// Register to be notified if the Device is lost or recreated
 	m_deviceResources->RegisterDeviceNotify(this);
 
+	for (const auto& budget : MemoryBudgetTable)
+	{
+		Simulation::MemoryTracker::Get().SetBudget(budget.tag, budget.bytes);
+	}
+
 	// TODO: Replace this with your app's content initialization.
 	m_sceneRenderer = std::unique_ptr<Sample3DSceneRenderer>(new Sample3DSceneRenderer(m_deviceResources));
+	m_sceneRenderer->SetInputLatency(&m_inputLatency);
 
-	m_fpsTextRenderer = std::unique_ptr<SampleFpsTextRenderer>(new SampleFpsTextRenderer(m_deviceResources));
+	{
+		Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Overlays);
+		m_fpsTextRenderer = std::unique_ptr<SampleFpsTextRenderer>(new SampleFpsTextRenderer(m_deviceResources));
+	}
 
-	// TODO: Change the timer settings if you want something other than the default variable timestep mode.
-	// e.g. for 60 FPS fixed timestep update logic, call:
-	/*
+	// The simulation runs at a fixed rate and rendering interpolates between updates,
+	// so weak devices can lower SimulationRate without changing the game speed.
 	m_timer.SetFixedTimeStep(true);
-	m_timer.SetTargetElapsedSeconds(1.0 / 60);
-	*/
+	m_timer.SetTargetElapsedSeconds(1.0 / SimulationRate);
+	m_timer.SetMaxUpdatesPerTick(MaxCatchUpUpdates);
 }
 
 SimpleSample_DirectXTK_UWPMain::~SimpleSample_DirectXTK_UWPMain()
@@ -43,19 +77,28 @@ void SimpleSample_DirectXTK_UWPMain::CreateWindowSizeDependentResources()
 // Updates the application state once per frame.
 void SimpleSample_DirectXTK_UWPMain::Update() 
 {
+	PROFILE_ZONE("Update");
+	uint64_t start = Simulation::FrameTimings::Now();
+
 	// Update scene objects.
 	m_timer.Tick([&]()
 	{
 		// TODO: Replace this with your app's content update functions.
 		m_sceneRenderer->Update(m_timer);
-		m_fpsTextRenderer->Update(m_timer);
+
+		Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Overlays);
+		m_fpsTextRenderer->Update(m_timer, m_frameTimings, m_inputLatency);
 	});
+
+	m_frameTimings.Record(Simulation::FramePhase_Update, Simulation::FrameTimings::Now() - start);
 }
 
 // Renders the current frame according to the current application state.
 // Returns true if the frame was rendered and is ready to be displayed.
 bool SimpleSample_DirectXTK_UWPMain::Render() 
 {
+	PROFILE_ZONE("Render");
+
 	// Don't try to render anything before the first Update.
 	if (m_timer.GetFrameCount() == 0)
 	{
@@ -76,14 +119,69 @@ bool SimpleSample_DirectXTK_UWPMain::Render()
 	context->ClearRenderTargetView(m_deviceResources->GetBackBufferRenderTargetView(), DirectX::Colors::CornflowerBlue);
 	context->ClearDepthStencilView(m_deviceResources->GetDepthStencilView(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 
+	uint64_t start = Simulation::FrameTimings::Now();
+
 	// Render the scene objects.
 	// TODO: Replace this with your app's content rendering functions.
-	m_sceneRenderer->Render();
-	m_fpsTextRenderer->Render();
+	m_sceneRenderer->Render((float)m_timer.GetInterpolationAlpha());
+	{
+		Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Overlays);
+		m_fpsTextRenderer->Render();
+	}
+
+	m_frameTimings.Record(Simulation::FramePhase_Render, Simulation::FrameTimings::Now() - start);
+	return true;
+}
+
+// Presents the rendered frame; the wait for vsync is counted as present time.
+void SimpleSample_DirectXTK_UWPMain::Present()
+{
+	uint64_t start = Simulation::FrameTimings::Now();
+	m_deviceResources->Present();
+	uint64_t presented = Simulation::FrameTimings::Now();
+	m_frameTimings.Record(Simulation::FramePhase_Present, presented - start);
+	m_inputLatency.OnPresent(presented);
+
+	m_frameTimings.EndFrame();
+}
+
+// Saves the input of the running session so it can be replayed offline.
+bool SimpleSample_DirectXTK_UWPMain::SaveInputLog(const std::wstring& path) const
+{
+	return m_sceneRenderer->SaveInputLog(path);
+}
+
+// Writes the memory used per subsystem right now, with the budgets.
+bool SimpleSample_DirectXTK_UWPMain::SaveMemoryReport(const std::wstring& path) const
+{
+	std::ofstream file(path);
+	return file && Simulation::WriteMemoryReport(file, Simulation::MemoryTracker::Get().Snapshot());
+}
+
+bool SimpleSample_DirectXTK_UWPMain::OpenFrameLog(const std::wstring& path)
+{
+	if (!m_frameLog.Open(path.c_str()))
+		return false;
 
+	m_frameTimings.SetLog(&m_frameLog);
 	return true;
 }
 
+void SimpleSample_DirectXTK_UWPMain::OnInput()
+{
+	m_inputLatency.OnInput(Simulation::FrameTimings::Now());
+}
+
+void SimpleSample_DirectXTK_UWPMain::SetLateLatch(bool enabled)
+{
+	m_sceneRenderer->SetLateLatch(enabled);
+}
+
+bool SimpleSample_DirectXTK_UWPMain::IsLateLatchEnabled() const
+{
+	return m_sceneRenderer->IsLateLatchEnabled();
+}
+
 // Notifies renderers that device resources need to be released.
 void SimpleSample_DirectXTK_UWPMain::OnDeviceLost()
 {
@@ -95,6 +193,9 @@ void SimpleSample_DirectXTK_UWPMain::OnDeviceLost()
 void SimpleSample_DirectXTK_UWPMain::OnDeviceRestored()
 {
 	m_sceneRenderer->CreateDeviceDependentResources();
-	m_fpsTextRenderer->CreateDeviceDependentResources();
+	{
+		Simulation::MemoryTagScope memoryTag(Simulation::MemoryTag_Overlays);
+		m_fpsTextRenderer->CreateDeviceDependentResources();
+	}
 	CreateWindowSizeDependentResources();
 }
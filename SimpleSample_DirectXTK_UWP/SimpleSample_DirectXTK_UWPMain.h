@@ -4,6 +4,8 @@
 #include "Common\DeviceResources.h"
 #include "Content\Sample3DSceneRenderer.h"
 #include "Content\SampleFpsTextRenderer.h"
+#include "Simulation\FrameTimings.hpp"
+#include "Simulation\InputLatency.hpp"
 
 // Renders Direct2D and 3D content on the screen.
 namespace SimpleSample_DirectXTK_UWP
@@ -16,6 +18,19 @@ namespace SimpleSample_DirectXTK_UWP
 		void CreateWindowSizeDependentResources();
 		void Update();
 		bool Render();
+		void Present();
+		bool SaveInputLog(const std::wstring& path) const;
+		bool SaveMemoryReport(const std::wstring& path) const;
+
+		// Streams the update, render and present time of every frame to path, for Tools\FrameLogReport.
+		bool OpenFrameLog(const std::wstring& path);
+
+		// Input the game reads arrived; called from the CoreWindow event handlers.
+		void OnInput();
+
+		// Redraws the player with its movement input read just before drawing.
+		void SetLateLatch(bool enabled);
+		bool IsLateLatchEnabled() const;
 
 		// IDeviceNotify
 		virtual void OnDeviceLost();
@@ -31,5 +46,16 @@ namespace SimpleSample_DirectXTK_UWP
 
 		// Rendering loop timer.
 		DX::StepTimer m_timer;
+
+		// Frame time percentiles shown by the FPS overlay, and their log.
+		Simulation::FrameTimings m_frameTimings;
+		Simulation::FrameLogWriter m_frameLog;
+
+		// Time from input arriving to the frame that read it being presented.
+		Simulation::InputLatency m_inputLatency;
+
+		// Simulation updates per second, and how many of them one frame may run to catch up.
+		static const int SimulationRate = 60;
+		static const uint32 MaxCatchUpUpdates = 4;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,265 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Simd.hpp"
+#include "SimTypes.hpp"
+
+// Packed axis aligned boxes and a batched overlap kernel. Boxes are kept as
+// four parallel float arrays (min x, min y, max x, max y), so one box is
+// tested against 8 (AVX2) or 4 (SSE2) stored boxes with a few compares and
+// a movemask. Builds without either instruction set use the scalar loop.
+//
+// Overlap follows Rect::IntersectsWith: touching edges count. Empty boxes
+// are not filtered by the kernel, callers simply do not store them.
+
+namespace Simulation
+{
+	struct Aabb
+	{
+		float minX;
+		float minY;
+		float maxX;
+		float maxY;
+
+		Aabb() : minX(0.f), minY(0.f), maxX(0.f), maxY(0.f) {}
+		Aabb(float _minX, float _minY, float _maxX, float _maxY) : minX(_minX), minY(_minY), maxX(_maxX), maxY(_maxY) {}
+
+		static Aabb FromRect(const Rect& rect)
+		{
+			return Aabb(rect.Left(), rect.Top(), rect.Right(), rect.Bottom());
+		}
+
+		Rect ToRect() const
+		{
+			return Rect(minX, minY, maxX - minX, maxY - minY);
+		}
+
+		bool Overlaps(const Aabb& other) const
+		{
+			return other.minX <= maxX && other.maxX >= minX && other.minY <= maxY && other.maxY >= minY;
+		}
+	};
+
+	// Indices of two overlapping boxes, one from each array of an N-vs-M test.
+	struct AabbPair
+	{
+		uint32_t	a;
+		uint32_t	b;
+	};
+
+	class AabbArray
+	{
+	public:
+		void Clear()
+		{
+			m_minX.clear();
+			m_minY.clear();
+			m_maxX.clear();
+			m_maxY.clear();
+		}
+
+		void Reserve(size_t capacity)
+		{
+			m_minX.reserve(capacity);
+			m_minY.reserve(capacity);
+			m_maxX.reserve(capacity);
+			m_maxY.reserve(capacity);
+		}
+
+		void Resize(size_t count)
+		{
+			m_minX.resize(count);
+			m_minY.resize(count);
+			m_maxX.resize(count);
+			m_maxY.resize(count);
+		}
+
+		void Add(const Aabb& box)
+		{
+			m_minX.push_back(box.minX);
+			m_minY.push_back(box.minY);
+			m_maxX.push_back(box.maxX);
+			m_maxY.push_back(box.maxY);
+		}
+
+		void Set(size_t index, const Aabb& box)
+		{
+			m_minX[index] = box.minX;
+			m_minY[index] = box.minY;
+			m_maxX[index] = box.maxX;
+			m_maxY[index] = box.maxY;
+		}
+
+		Aabb Get(size_t index) const
+		{
+			return Aabb(m_minX[index], m_minY[index], m_maxX[index], m_maxY[index]);
+		}
+
+		size_t Size() const							{ return m_minX.size(); }
+		bool Empty() const							{ return m_minX.empty(); }
+
+		const float* MinX() const					{ return m_minX.data(); }
+		const float* MinY() const					{ return m_minY.data(); }
+		const float* MaxX() const					{ return m_maxX.data(); }
+		const float* MaxY() const					{ return m_maxY.data(); }
+
+	private:
+		std::vector<float>							m_minX;
+		std::vector<float>							m_minY;
+		std::vector<float>							m_maxX;
+		std::vector<float>							m_maxY;
+	};
+
+	// Widest block AabbForEachOverlap visits: 8 lanes with AVX2, 4 with SSE2.
+#if SIMULATION_USE_AVX2
+	const size_t AabbBlockLanes = 8;
+#elif SIMULATION_USE_SSE2
+	const size_t AabbBlockLanes = 4;
+#else
+	const size_t AabbBlockLanes = 1;
+#endif
+
+	// Tests box against boxes[first, last) and calls visit(index, bits) for
+	// every block with at least one hit: bit n set means boxes[index + n]
+	// overlaps. Blocks are visited in ascending index order.
+	template<typename Visitor>
+	inline void AabbForEachOverlap(const Aabb& box, const AabbArray& boxes, size_t first, size_t last, Visitor&& visit)
+	{
+		const float* minX = boxes.MinX();
+		const float* minY = boxes.MinY();
+		const float* maxX = boxes.MaxX();
+		const float* maxY = boxes.MaxY();
+		size_t i = first;
+
+#if SIMULATION_USE_AVX2
+		{
+			__m256 boxMinX = _mm256_set1_ps(box.minX);
+			__m256 boxMinY = _mm256_set1_ps(box.minY);
+			__m256 boxMaxX = _mm256_set1_ps(box.maxX);
+			__m256 boxMaxY = _mm256_set1_ps(box.maxY);
+			for (; i + 8 <= last; i += 8)
+			{
+				__m256 hitX = _mm256_and_ps(
+					_mm256_cmp_ps(_mm256_loadu_ps(minX + i), boxMaxX, _CMP_LE_OQ),
+					_mm256_cmp_ps(_mm256_loadu_ps(maxX + i), boxMinX, _CMP_GE_OQ));
+				__m256 hitY = _mm256_and_ps(
+					_mm256_cmp_ps(_mm256_loadu_ps(minY + i), boxMaxY, _CMP_LE_OQ),
+					_mm256_cmp_ps(_mm256_loadu_ps(maxY + i), boxMinY, _CMP_GE_OQ));
+
+				uint32_t bits = (uint32_t)_mm256_movemask_ps(_mm256_and_ps(hitX, hitY));
+				if (bits)
+				{
+					visit(i, bits);
+				}
+			}
+		}
+#endif
+#if SIMULATION_USE_SSE2
+		{
+			__m128 boxMinX = _mm_set1_ps(box.minX);
+			__m128 boxMinY = _mm_set1_ps(box.minY);
+			__m128 boxMaxX = _mm_set1_ps(box.maxX);
+			__m128 boxMaxY = _mm_set1_ps(box.maxY);
+			for (; i + 4 <= last; i += 4)
+			{
+				__m128 hitX = _mm_and_ps(
+					_mm_cmple_ps(_mm_loadu_ps(minX + i), boxMaxX),
+					_mm_cmpge_ps(_mm_loadu_ps(maxX + i), boxMinX));
+				__m128 hitY = _mm_and_ps(
+					_mm_cmple_ps(_mm_loadu_ps(minY + i), boxMaxY),
+					_mm_cmpge_ps(_mm_loadu_ps(maxY + i), boxMinY));
+
+				uint32_t bits = (uint32_t)_mm_movemask_ps(_mm_and_ps(hitX, hitY));
+				if (bits)
+				{
+					visit(i, bits);
+				}
+			}
+		}
+#endif
+		for (; i < last; i++)
+		{
+			if (minX[i] <= box.maxX && maxX[i] >= box.minX && minY[i] <= box.maxY && maxY[i] >= box.minY)
+			{
+				visit(i, 1u);
+			}
+		}
+	}
+
+	// Sets bit (i - first) of mask for every boxes[i] overlapping box; mask
+	// needs (last - first + 31) / 32 words and is cleared first. Returns the hit count.
+	inline size_t AabbOverlapMask(const Aabb& box, const AabbArray& boxes, size_t first, size_t last, uint32_t* mask)
+	{
+		size_t words = (last - first + 31) / 32;
+		for (size_t w = 0; w < words; w++)
+		{
+			mask[w] = 0;
+		}
+
+		size_t hits = 0;
+		AabbForEachOverlap(box, boxes, first, last, [&](size_t index, uint32_t bits)
+		{
+			size_t offset = index - first;
+			size_t shift = offset & 31;
+
+			mask[offset >> 5] |= bits << shift;
+			if (shift + AabbBlockLanes > 32 && (bits >> (32 - shift)) != 0)
+			{
+				// The block straddles two words and has hits in the second,
+				// which therefore lies inside the range.
+				mask[(offset >> 5) + 1] |= bits >> (32 - shift);
+			}
+
+			for (; bits; bits &= bits - 1)
+			{
+				hits++;
+			}
+		});
+		return hits;
+	}
+
+	// Appends the index of every boxes[i] in [first, last) overlapping box, in
+	// ascending order. Returns the number of indices appended.
+	inline size_t AabbOverlapIndices(const Aabb& box, const AabbArray& boxes, size_t first, size_t last, std::vector<uint32_t>& hits)
+	{
+		size_t count = hits.size();
+		AabbForEachOverlap(box, boxes, first, last, [&](size_t index, uint32_t bits)
+		{
+			for (uint32_t lane = 0; bits; lane++, bits >>= 1)
+			{
+				if (bits & 1)
+				{
+					hits.push_back((uint32_t)(index + lane));
+				}
+			}
+		});
+		return hits.size() - count;
+	}
+
+	// Every overlapping pair between two arrays, ordered by a then b.
+	inline size_t AabbOverlapPairs(const AabbArray& a, const AabbArray& b, std::vector<AabbPair>& pairs)
+	{
+		size_t count = pairs.size();
+		for (size_t i = 0; i < a.Size(); i++)
+		{
+			AabbForEachOverlap(a.Get(i), b, 0, b.Size(), [&](size_t index, uint32_t bits)
+			{
+				for (uint32_t lane = 0; bits; lane++, bits >>= 1)
+				{
+					if (bits & 1)
+					{
+						AabbPair pair = { (uint32_t)i, (uint32_t)(index + lane) };
+						pairs.push_back(pair);
+					}
+				}
+			});
+		}
+		return pairs.size() - count;
+	}
+}
@@ -0,0 +1,87 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Counts heap allocations made through operator new, so a test can check
+// that a stretch of code does not allocate: after warm-up a game tick
+// should not, as allocator locks and page faults show up as frame time
+// spikes. Counting only happens in a program that replaces the global
+// operator new with SIMULATION_DEFINE_ALLOCATION_COUNTER, or with
+// SIMULATION_DEFINE_MEMORY_TRACKER of MemoryTracker.hpp, in exactly one
+// source file; everywhere else the counts stay 0.
+//
+// Counts are kept per thread only, so a check on the game loop thread is
+// not tripped by the asset loader or the audio thread, and counting takes
+// no shared cache line.
+
+namespace Simulation
+{
+	class AllocationCounter
+	{
+	public:
+		// Called by the replaced operator new.
+		static void Note()
+		{
+			ThisThread()++;
+		}
+
+		static uint64_t GetThisThread()				{ return ThisThread(); }
+
+	private:
+		static uint64_t& ThisThread()
+		{
+			static thread_local uint64_t count = 0;
+			return count;
+		}
+	};
+
+	// Allocations made by the calling thread since construction.
+	class AllocationScope
+	{
+	public:
+		AllocationScope() : m_start(AllocationCounter::GetThisThread()) {}
+
+		uint64_t GetCount() const					{ return AllocationCounter::GetThisThread() - m_start; }
+
+	private:
+		uint64_t									m_start;
+	};
+}
+
+// GCC pairs new expressions it can see inlined into these with the free
+// below and warns; they are a matching pair here.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#define SIMULATION_ALLOCATION_COUNTER_PRAGMA _Pragma("GCC diagnostic ignored \"-Wmismatched-new-delete\"")
+#else
+#define SIMULATION_ALLOCATION_COUNTER_PRAGMA
+#endif
+
+// Replaces the global operator new and delete with counting versions on top
+// of malloc. Use at namespace scope in one source file of the program.
+#define SIMULATION_DEFINE_ALLOCATION_COUNTER \
+	SIMULATION_ALLOCATION_COUNTER_PRAGMA \
+	void* operator new(std::size_t size) \
+	{ \
+		Simulation::AllocationCounter::Note(); \
+		if (void* memory = std::malloc(size ? size : 1)) \
+			return memory; \
+		throw std::bad_alloc(); \
+	} \
+	void* operator new[](std::size_t size)						{ return operator new(size); } \
+	void* operator new(std::size_t size, const std::nothrow_t&) noexcept \
+	{ \
+		Simulation::AllocationCounter::Note(); \
+		return std::malloc(size ? size : 1); \
+	} \
+	void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept	{ return operator new(size, tag); } \
+	void operator delete(void* memory) noexcept					{ std::free(memory); } \
+	void operator delete[](void* memory) noexcept					{ std::free(memory); } \
+	void operator delete(void* memory, std::size_t) noexcept		{ std::free(memory); } \
+	void operator delete[](void* memory, std::size_t) noexcept		{ std::free(memory); } \
+	void operator delete(void* memory, const std::nothrow_t&) noexcept		{ std::free(memory); } \
+	void operator delete[](void* memory, const std::nothrow_t&) noexcept	{ std::free(memory); }
@@ -0,0 +1,124 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Sprite animation split into what every sprite of a kind shares and what
+// each one owns. A clip (frames, rate, looping) is defined once in an
+// AnimationClips table; a sprite only keeps a 12 byte AnimationPlayback of
+// which clip it plays, when it started and how fast. Playbacks are stored
+// contiguously by their owner, e.g. next to the enemies in EnemyPool.
+//
+// Nothing advances per tick: the frame of a playback is a function of the
+// time, evaluated for all of them in one pass by EvaluateAnimationFrames.
+// A long frame, or a paused game, can neither slow an animation down nor
+// let two sprites that share a clip step each other's frame.
+//
+// A clip's frames are ids of frames in a sprite sheet, so they need not be
+// contiguous or in sheet order. Sheets name their clips by frame name (see
+// BuildSpriteClips in Common/SpriteClips.hpp), and code looks a clip up by
+// that name once, when it is set up.
+
+namespace Simulation
+{
+	const uint32_t InvalidAnimationClip = 0xffffffffu;
+
+	struct AnimationClip
+	{
+		uint32_t	firstFrame;			// Index of the first frame id in the table's frame list.
+		uint32_t	frameCount;
+		float		framesPerSecond;
+		bool		loop;				// Otherwise the last frame is held.
+	};
+
+	struct AnimationPlayback
+	{
+		uint32_t	clip;				// Id returned by AnimationClips::Add.
+		float		startTime;			// Seconds, on the clock passed to EvaluateAnimationFrames.
+		float		speed;				// 1 plays the clip at its own rate.
+
+		AnimationPlayback() : clip(0), startTime(0.f), speed(1.f) {}
+		AnimationPlayback(uint32_t _clip, float _startTime, float _speed = 1.f) :
+			clip(_clip), startTime(_startTime), speed(_speed)
+		{
+		}
+	};
+
+	// Clips are never changed once added, so one table serves any number of sprites.
+	class AnimationClips
+	{
+	public:
+		// Copies frameCount frame ids, at least one; returns the id of the clip.
+		uint32_t Add(const char* name, const uint32_t* frames, uint32_t frameCount, float framesPerSecond, bool loop = true)
+		{
+			AnimationClip clip;
+			clip.firstFrame = (uint32_t)m_frames.size();
+			clip.frameCount = frameCount;
+			clip.framesPerSecond = framesPerSecond;
+			clip.loop = loop;
+
+			m_frames.insert(m_frames.end(), frames, frames + frameCount);
+			m_clips.push_back(clip);
+			m_names.push_back(name);
+			return (uint32_t)(m_clips.size() - 1);
+		}
+
+		void Clear()
+		{
+			m_clips.clear();
+			m_frames.clear();
+			m_names.clear();
+		}
+
+		// Id of the named clip, or InvalidAnimationClip.
+		uint32_t Find(const char* name) const
+		{
+			for (size_t i = 0; i < m_names.size(); i++)
+			{
+				if (m_names[i] == name)
+					return (uint32_t)i;
+			}
+			return InvalidAnimationClip;
+		}
+
+		size_t Size() const							{ return m_clips.size(); }
+		const AnimationClip& Get(uint32_t clip) const	{ return m_clips[clip]; }
+		const char* GetName(uint32_t clip) const	{ return m_names[clip].c_str(); }
+
+		// Frame id of the index-th frame of clip.
+		uint32_t GetFrame(const AnimationClip& clip, uint32_t index) const	{ return m_frames[clip.firstFrame + index]; }
+
+	private:
+		std::vector<AnimationClip>					m_clips;
+		std::vector<uint32_t>						m_frames;
+		std::vector<std::string>					m_names;
+	};
+
+	// Frame id of clip seconds after it started; before the start it shows the first frame.
+	inline uint32_t AnimationFrameAt(const AnimationClips& clips, const AnimationClip& clip, float seconds)
+	{
+		float position = seconds * clip.framesPerSecond;
+		uint32_t index = position > 0.f ? (uint32_t)position : 0;
+		index = clip.loop ? index % clip.frameCount : (std::min)(index, clip.frameCount - 1);
+		return clips.GetFrame(clip, index);
+	}
+
+	// Writes the frame of playbacks[i] at time to frames[i], for count
+	// playbacks. time is a double so that it can be a session clock; the
+	// difference to the start time is small and taken in float.
+	inline void EvaluateAnimationFrames(const AnimationClips& clips, const AnimationPlayback* playbacks, size_t count,
+		double time, uint32_t* frames)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			const AnimationPlayback& playback = playbacks[i];
+			float seconds = (float)(time - playback.startTime) * playback.speed;
+			frames[i] = AnimationFrameAt(clips, clips.Get(playback.clip), seconds);
+		}
+	}
+}
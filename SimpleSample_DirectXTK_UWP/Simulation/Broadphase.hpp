@@ -0,0 +1,275 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "SimTypes.hpp"
+#include "Aabb.hpp"
+
+// Sweep-and-prune broadphase along x, which suits the side-scrolling layout:
+// objects are spread horizontally and only a few overlap on any x interval.
+// It is rebuilt from scratch every tick (Clear, Add..., Build), after which
+// box queries and layer-vs-layer pair queries run in O(n log n + k).
+//
+// Every layer is sorted on its own into a packed AabbArray, so a query
+// between two layers only walks the other layer's boxes (enemy-vs-wall
+// costs one binary search per enemy no matter how many enemies crowd the
+// same strip of screen), and the candidate window is a contiguous run that
+// the SIMD kernel in Aabb.hpp tests 4 or 8 boxes at a time.
+//
+// Results are deterministic: box queries are reported in insertion order,
+// pairs grouped by layer combination (lowest layer bits first) and in sweep
+// order (ascending min x, ties by insertion order) within each group.
+
+namespace Simulation
+{
+	enum BroadphaseLayer : uint8_t
+	{
+		BroadphaseLayer_Player	= 0x01,
+		BroadphaseLayer_Wall	= 0x02,
+		BroadphaseLayer_Enemy	= 0x04,
+		BroadphaseLayer_All		= 0xff
+	};
+
+	// Two overlapping proxies. For a query between layer masks A and B, 'a'
+	// always belongs to A and 'b' to B.
+	typedef AabbPair BroadphasePair;
+
+	class Broadphase
+	{
+	public:
+		Broadphase()
+		{
+			Clear();
+		}
+
+		void Clear()
+		{
+			m_boxes.Clear();
+			m_layer.clear();
+			m_userId.clear();
+
+			for (int layer = 0; layer < LayerCount; layer++)
+			{
+				m_layerOrder[layer].clear();
+				m_layerMaxWidth[layer] = 0.f;
+			}
+		}
+
+		void Reserve(size_t capacity)
+		{
+			m_boxes.Reserve(capacity);
+			m_layer.reserve(capacity);
+			m_userId.reserve(capacity);
+		}
+
+		// Room for capacity boxes in one layer, kept across Clear.
+		void ReserveLayer(BroadphaseLayer layer, size_t capacity)
+		{
+			int bit = LayerBit((uint8_t)layer);
+			m_layerOrder[bit].reserve(capacity);
+			m_layerBoxes[bit].Reserve(capacity);
+			m_layerProxy[bit].reserve(capacity);
+		}
+
+		// Adds a box and returns its proxy index. Empty boxes never intersect
+		// anything and are not stored; InvalidProxy is returned for them.
+		// A proxy belongs to exactly one layer.
+		uint32_t Add(const Rect& rect, BroadphaseLayer layer, uint32_t userId)
+		{
+			if (rect.IsEmpty())
+				return InvalidProxy;
+
+			uint32_t proxy = (uint32_t)m_boxes.Size();
+			int bit = LayerBit((uint8_t)layer);
+
+			m_boxes.Add(Aabb::FromRect(rect));
+			m_layer.push_back((uint8_t)layer);
+			m_userId.push_back(userId);
+
+			SortKey key = { rect.Left(), proxy };
+			m_layerOrder[bit].push_back(key);
+			m_layerMaxWidth[bit] = (std::max)(m_layerMaxWidth[bit], rect.Width);
+
+			return proxy;
+		}
+
+		// Sorts every layer along x into its packed box array. Must be called
+		// after the last Add and before any query.
+		void Build()
+		{
+			for (int layer = 0; layer < LayerCount; layer++)
+			{
+				auto& order = m_layerOrder[layer];
+				std::sort(order.begin(), order.end(), [](const SortKey& lhs, const SortKey& rhs)
+				{
+					return lhs.minX < rhs.minX || (lhs.minX == rhs.minX && lhs.proxy < rhs.proxy);
+				});
+
+				m_layerBoxes[layer].Resize(order.size());
+				m_layerProxy[layer].resize(order.size());
+				for (size_t i = 0; i < order.size(); i++)
+				{
+					m_layerBoxes[layer].Set(i, m_boxes.Get(order[i].proxy));
+					m_layerProxy[layer][i] = order[i].proxy;
+				}
+			}
+		}
+
+		// Appends every proxy in layerMask overlapping rect to results, in insertion order.
+		void Query(const Rect& rect, uint8_t layerMask, std::vector<uint32_t>& results) const
+		{
+			if (rect.IsEmpty())
+				return;
+
+			Aabb box = Aabb::FromRect(rect);
+			size_t first = results.size();
+
+			for (int layer = 0; layer < LayerCount; layer++)
+			{
+				if (!(layerMask & (1 << layer)))
+					continue;
+
+				const uint32_t* proxies = m_layerProxy[layer].data();
+				size_t begin, end;
+				Window(layer, box, begin, end);
+
+				AabbForEachOverlap(box, m_layerBoxes[layer], begin, end, [&](size_t index, uint32_t bits)
+				{
+					for (uint32_t lane = 0; bits; lane++, bits >>= 1)
+					{
+						if (bits & 1)
+						{
+							results.push_back(proxies[index + lane]);
+						}
+					}
+				});
+			}
+
+			std::sort(results.begin() + first, results.end());
+		}
+
+		// Appends every overlapping pair with one proxy in layersA and the other
+		// in layersB. Each pair is reported once, also when the masks overlap.
+		void FindPairs(uint8_t layersA, uint8_t layersB, std::vector<BroadphasePair>& pairs) const
+		{
+			for (int a = 0; a < LayerCount; a++)
+			{
+				if (!(layersA & (1 << a)))
+					continue;
+
+				for (int b = 0; b < LayerCount; b++)
+				{
+					if (!(layersB & (1 << b)))
+						continue;
+
+					// Both combinations are requested when the masks overlap; take only one.
+					if (a == b || !((layersB & (1 << a)) && (layersA & (1 << b)) && b < a))
+					{
+						SweepPairs(a, b, pairs);
+					}
+				}
+			}
+		}
+
+		size_t Size() const								{ return m_boxes.Size(); }
+		uint32_t GetUserId(uint32_t proxy) const		{ return m_userId[proxy]; }
+		BroadphaseLayer GetLayer(uint32_t proxy) const	{ return (BroadphaseLayer)m_layer[proxy]; }
+		Rect GetRect(uint32_t proxy) const				{ return m_boxes.Get(proxy).ToRect(); }
+
+		// Boxes of one layer bit in sweep order, valid after Build.
+		const AabbArray& GetLayerBoxes(int layerBit) const	{ return m_layerBoxes[layerBit]; }
+
+		static const uint32_t InvalidProxy = 0xffffffffu;
+
+	private:
+		static const int LayerCount = 8;
+
+		struct SortKey
+		{
+			float		minX;
+			uint32_t	proxy;
+		};
+
+		static int LayerBit(uint8_t layer)
+		{
+			int bit = 0;
+			while (bit < LayerCount - 1 && !(layer & (1 << bit)))
+				bit++;
+			return bit;
+		}
+
+		// Range [begin, end) of a layer that can overlap box along x. Anything
+		// starting before box.minX - widest box ends before box starts.
+		void Window(int layer, const Aabb& box, size_t& begin, size_t& end) const
+		{
+			const float* minX = m_layerBoxes[layer].MinX();
+			const float* last = minX + m_layerBoxes[layer].Size();
+
+			begin = (size_t)(std::lower_bound(minX, last, box.minX - m_layerMaxWidth[layer]) - minX);
+			end = (size_t)(std::upper_bound(minX + begin, last, box.maxX) - minX);
+		}
+
+		// Every box of layer a against the x-window of layer b it can touch.
+		// Within one layer only the boxes after the current one are tested.
+		void SweepPairs(int a, int b, std::vector<BroadphasePair>& pairs) const
+		{
+			const AabbArray& boxesA = m_layerBoxes[a];
+			const AabbArray& boxesB = m_layerBoxes[b];
+			const uint32_t* proxiesA = m_layerProxy[a].data();
+			const uint32_t* proxiesB = m_layerProxy[b].data();
+			const float* minXB = boxesB.MinX();
+			size_t countB = boxesB.Size();
+			float widthB = m_layerMaxWidth[b];
+			size_t begin = 0;
+
+			for (size_t i = 0; i < boxesA.Size(); i++)
+			{
+				Aabb box = boxesA.Get(i);
+
+				// Layer a ascends in min x, so the window start only moves
+				// forward; windows are short, so the end is found by scanning.
+				if (a == b)
+				{
+					begin = i + 1;
+				}
+				else
+				{
+					while (begin < countB && minXB[begin] < box.minX - widthB)
+						begin++;
+				}
+
+				size_t end = begin;
+				while (end < countB && minXB[end] <= box.maxX)
+					end++;
+
+				uint32_t p = proxiesA[i];
+				AabbForEachOverlap(box, boxesB, begin, end, [&](size_t index, uint32_t bits)
+				{
+					for (uint32_t lane = 0; bits; lane++, bits >>= 1)
+					{
+						if (bits & 1)
+						{
+							BroadphasePair pair = { p, proxiesB[index + lane] };
+							pairs.push_back(pair);
+						}
+					}
+				});
+			}
+		}
+
+		AabbArray										m_boxes;
+		std::vector<uint8_t>							m_layer;
+		std::vector<uint32_t>							m_userId;
+
+		// Per layer bit: sort keys, boxes in sweep order and their proxies, widest box.
+		std::vector<SortKey>							m_layerOrder[LayerCount];
+		AabbArray										m_layerBoxes[LayerCount];
+		std::vector<uint32_t>							m_layerProxy[LayerCount];
+		float											m_layerMaxWidth[LayerCount];
+	};
+}
@@ -0,0 +1,261 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "SimTypes.hpp"
+#include "Random.hpp"
+
+// The walls the player flies through, generated as a course. Walls are
+// placed at a fixed spacing up to a lookahead distance past the right edge
+// of the screen, into a ring that is sized once by Reset; walls that scroll
+// off the left edge free their slot for the next one, so a running course
+// never allocates.
+//
+// Positions are kept along the course rather than on screen: moving every
+// wall is one change of the scroll position, whatever the number of walls.
+// Course positions are doubles, so they stay exact for any session length.
+//
+// Gap heights follow a difficulty curve from startGap down to minGap over
+// difficultyDistance pixels of course. Gap positions are drawn from the
+// walls random stream in batches, so the course is reproduced by the seed;
+// maxGapShift limits how far a gap moves from the previous one, which with
+// a small spacing turns the walls into a winding tunnel.
+
+namespace Simulation
+{
+	struct CourseConfig
+	{
+		float			scrollSpeed;		// pixels per second the walls move left
+		float			spacing;			// pixels between the left edges of two walls; 0 puts one wall on a screen
+		float			lookahead;			// screens past the right edge that are generated in advance
+		float			startGap;			// gap height of the first wall
+		float			minGap;				// gap height the difficulty curve ends at
+		float			difficultyDistance;	// pixels of course over which the gap narrows to minGap
+		float			maxGapShift;		// pixels a gap's centre may move from the previous one; 0 is anywhere
+		uint32_t		batchSize;			// gap positions drawn at once
+
+		// The game's course: one wall a screen at 600 pixels per second (the old 10 a frame), with a 256 pixel gap anywhere.
+		CourseConfig() :
+			scrollSpeed(600.f),
+			spacing(0.f),
+			lookahead(1.f),
+			startGap(256.f),
+			minGap(256.f),
+			difficultyDistance(1.f),
+			maxGapShift(0.f),
+			batchSize(64)
+		{
+		}
+
+		// A fast tunnel of a few hundred walls on screen, narrowing over the first 60000 pixels.
+		static CourseConfig Hard()
+		{
+			CourseConfig config;
+			config.scrollSpeed = 400.f;
+			config.spacing = 8.f;
+			config.lookahead = 1.f;
+			config.startGap = 420.f;
+			config.minGap = 200.f;
+			config.difficultyDistance = 60000.f;
+			config.maxGapShift = 6.f;
+			config.batchSize = 256;
+			return config;
+		}
+	};
+
+	class Course
+	{
+	public:
+		Course() : m_wallWidth(0.f), m_spacing(0.f), m_head(0), m_count(0), m_scroll(0.0), m_previousScroll(0.0),
+			m_startPosition(0.0), m_nextPosition(0.0), m_lastGapCentre(-1.f), m_nextRandom(0)
+		{
+		}
+
+		// Starts the course over. The first wall enters at the right edge of
+		// the screen; the ring is sized for every wall within the lookahead.
+		void Reset(const CourseConfig& config, Simulation::Size screenSize, float wallWidth, Pcg32& random)
+		{
+			m_config = config;
+			m_screenSize = screenSize;
+			m_wallWidth = wallWidth;
+			m_spacing = config.spacing > 0.f ? config.spacing : screenSize.Width + wallWidth;
+
+			float reach = screenSize.Width * (1.f + config.lookahead) + wallWidth;
+			size_t capacity = (size_t)std::ceil(reach / m_spacing) + 2;
+			m_position.assign(capacity, 0.0);
+			m_gapY.assign(capacity, 0.f);
+			m_gapHeight.assign(capacity, 0.f);
+			m_random.assign((std::max)(config.batchSize, 1u), 0.f);
+			m_nextRandom = m_random.size();
+
+			m_head = 0;
+			m_count = 0;
+			m_scroll = m_previousScroll = 0.0;
+			m_startPosition = m_nextPosition = screenSize.Width;
+			m_lastGapCentre = -1.f;
+
+			Generate(random);
+		}
+
+		// Walls placed from now on use the new size; those in the ring keep their gaps.
+		void SetScreenSize(Simulation::Size screenSize)			{ m_screenSize = screenSize; }
+
+		void Update(float elapsedSeconds, Pcg32& random)
+		{
+			m_previousScroll = m_scroll;
+			m_scroll += m_config.scrollSpeed * elapsedSeconds;
+
+			// Walls are in course order, so the ones off the left edge are at the front.
+			while (m_count != 0 && m_position[m_head] + m_wallWidth < m_scroll)
+			{
+				m_head = Slot(1);
+				m_count--;
+			}
+
+			Generate(random);
+		}
+
+		// Walls in the ring, on screen or ahead of it, leftmost first.
+		size_t Size() const							{ return m_count; }
+
+		// Walls up to the right edge of the screen; the rest are lookahead.
+		// Walls are evenly spaced, so this is counted rather than searched.
+		size_t GetVisibleCount() const
+		{
+			if (m_count == 0 || GetX(0) > m_screenSize.Width)
+				return 0;
+
+			size_t visible = (size_t)((m_screenSize.Width - GetX(0)) / m_spacing) + 1;
+			return (std::min)(visible, m_count);
+		}
+
+		size_t GetCapacity() const					{ return m_position.size(); }
+
+		float GetX(size_t wall) const				{ return (float)(m_position[Slot(wall)] - m_scroll); }
+		float GetWallWidth() const					{ return m_wallWidth; }
+
+		// Pixels between the left edges of two walls.
+		float GetSpacing() const					{ return m_spacing; }
+
+		// Left edge between the previous and the current tick, alpha in [0, 1].
+		float GetInterpolatedX(size_t wall, float alpha) const
+		{
+			double scroll = m_previousScroll + (m_scroll - m_previousScroll) * alpha;
+			return (float)(m_position[Slot(wall)] - scroll);
+		}
+
+		Rect GetUpperRect(size_t wall) const
+		{
+			size_t slot = Slot(wall);
+			return Rect(GetX(wall), 0.f, m_wallWidth, m_gapY[slot]);
+		}
+
+		Rect GetLowerRect(size_t wall) const
+		{
+			size_t slot = Slot(wall);
+			float bottom = m_gapY[slot] + m_gapHeight[slot];
+			return Rect(GetX(wall), bottom, m_wallWidth, m_screenSize.Height - bottom);
+		}
+
+		Rect GetGapRect(size_t wall) const
+		{
+			size_t slot = Slot(wall);
+			return Rect(GetX(wall), m_gapY[slot], m_wallWidth, m_gapHeight[slot]);
+		}
+
+		bool IsCollidingWith(size_t wall, const Rect& rect) const
+		{
+			return GetUpperRect(wall).IntersectsWith(rect) || GetLowerRect(wall).IntersectsWith(rect);
+		}
+
+		// Pixels of course scrolled past the left edge of the screen.
+		double GetDistance() const					{ return m_scroll; }
+
+	private:
+		size_t Slot(size_t wall) const
+		{
+			size_t slot = m_head + wall;
+			return slot < m_position.size() ? slot : slot - m_position.size();
+		}
+
+		void Generate(Pcg32& random)
+		{
+			double end = m_scroll + m_screenSize.Width * (1.0 + m_config.lookahead);
+			while (m_count < m_position.size() && m_nextPosition <= end)
+			{
+				size_t slot = Slot(m_count);
+				m_position[slot] = m_nextPosition;
+				PlaceGap(slot, NextRandom(random));
+				m_count++;
+				m_nextPosition += m_spacing;
+			}
+		}
+
+		// Narrows linearly with the distance of the wall from the start of the course.
+		float GapHeightAt(double position) const
+		{
+			double travelled = position - m_startPosition;
+			float t = (float)(std::min)(1.0, (std::max)(0.0, travelled / m_config.difficultyDistance));
+			return m_config.startGap + (m_config.minGap - m_config.startGap) * t;
+		}
+
+		void PlaceGap(size_t slot, float random)
+		{
+			float height = (std::min)(GapHeightAt(m_position[slot]), m_screenSize.Height);
+			float low = height / 2;
+			float high = m_screenSize.Height - height / 2;
+			if (m_config.maxGapShift > 0.f && m_lastGapCentre >= 0.f)
+			{
+				low = (std::max)(low, m_lastGapCentre - m_config.maxGapShift);
+				high = (std::min)(high, m_lastGapCentre + m_config.maxGapShift);
+				if (low > high)
+				{
+					// The screen shrank below the previous gap.
+					low = high = (std::max)(height / 2, (std::min)(m_lastGapCentre, m_screenSize.Height - height / 2));
+				}
+			}
+
+			float centre = low + (high - low) * random;
+			m_gapY[slot] = std::floor(centre - height / 2);
+			m_gapHeight[slot] = height;
+			m_lastGapCentre = centre;
+		}
+
+		float NextRandom(Pcg32& random)
+		{
+			if (m_nextRandom == m_random.size())
+			{
+				random.FillFloat(m_random.data(), m_random.size(), 0.f, 1.f);
+				m_nextRandom = 0;
+			}
+			return m_random[m_nextRandom++];
+		}
+
+		CourseConfig								m_config;
+		Simulation::Size							m_screenSize;
+		float										m_wallWidth;
+		float										m_spacing;
+
+		// The ring: course position (left edge) and gap of every wall, m_count from m_head on.
+		std::vector<double>							m_position;
+		std::vector<float>							m_gapY;
+		std::vector<float>							m_gapHeight;
+		size_t										m_head;
+		size_t										m_count;
+
+		double										m_scroll;				// course position of the left edge of the screen
+		double										m_previousScroll;
+		double										m_startPosition;		// of the first wall
+		double										m_nextPosition;			// where the next wall goes
+		float										m_lastGapCentre;		// -1 before the first wall
+
+		std::vector<float>							m_random;				// the current batch of gap positions
+		size_t										m_nextRandom;
+	};
+}
@@ -0,0 +1,284 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Animation.hpp"
+#include "Simd.hpp"
+#include "SimTypes.hpp"
+
+// Structure-of-arrays store for enemies. Live enemies are packed densely in
+// index order [0, Size()), so per-tick passes are linear sweeps over plain
+// float arrays. Removal swaps the last enemy into the hole, which makes it
+// O(1) but reorders the dense arrays; code that has to follow one enemy
+// across ticks keeps an EnemyHandle instead of an index.
+//
+// Positions of the previous tick are kept next to the current ones so the
+// renderer can interpolate between fixed simulation steps. Each enemy also
+// carries its animation playback, so enemies keep their own phase.
+
+namespace Simulation
+{
+	// Stable reference to an enemy. A handle goes stale when its enemy is
+	// despawned, even if the slot is later reused by a new enemy.
+	struct EnemyHandle
+	{
+		uint32_t	slot;
+		uint32_t	generation;
+
+		EnemyHandle() : slot(InvalidSlot), generation(0) {}
+		EnemyHandle(uint32_t _slot, uint32_t _generation) : slot(_slot), generation(_generation) {}
+
+		bool operator==(const EnemyHandle& other) const { return slot == other.slot && generation == other.generation; }
+		bool operator!=(const EnemyHandle& other) const { return !(*this == other); }
+
+		static const uint32_t InvalidSlot = 0xffffffffu;
+	};
+
+	class EnemyPool
+	{
+	public:
+		EnemyPool() : m_width(0.f), m_height(0.f) {}
+
+		// All enemies share one sprite, hence one bounding box size.
+		void SetSize(float width, float height)
+		{
+			m_width = width;
+			m_height = height;
+		}
+
+		void Reserve(size_t capacity)
+		{
+			m_x.reserve(capacity);
+			m_y.reserve(capacity);
+			m_prevX.reserve(capacity);
+			m_prevY.reserve(capacity);
+			m_speed.reserve(capacity);
+			m_visible.reserve(capacity);
+			m_animation.reserve(capacity);
+			m_denseToSlot.reserve(capacity);
+			m_slotToDense.reserve(capacity);
+			m_slotGeneration.reserve(capacity);
+			m_freeSlots.reserve(capacity);
+		}
+
+		EnemyHandle Spawn(float x, float y, float speed, const AnimationPlayback& animation = AnimationPlayback())
+		{
+			uint32_t slot;
+			if (!m_freeSlots.empty())
+			{
+				slot = m_freeSlots.back();
+				m_freeSlots.pop_back();
+			}
+			else
+			{
+				slot = (uint32_t)m_slotGeneration.size();
+				m_slotGeneration.push_back(0);
+				m_slotToDense.push_back(0);
+			}
+
+			m_slotToDense[slot] = (uint32_t)m_x.size();
+			m_denseToSlot.push_back(slot);
+			m_x.push_back(x);
+			m_y.push_back(y);
+			m_prevX.push_back(x);
+			m_prevY.push_back(y);
+			m_speed.push_back(speed);
+			m_visible.push_back(1);
+			m_animation.push_back(animation);
+
+			return EnemyHandle(slot, m_slotGeneration[slot]);
+		}
+
+		bool IsAlive(EnemyHandle handle) const
+		{
+			// Despawning bumps the slot generation, so a matching generation means alive.
+			return handle.slot < m_slotGeneration.size() && m_slotGeneration[handle.slot] == handle.generation;
+		}
+
+		// Dense index of a live enemy; only valid until the next despawn.
+		size_t IndexOf(EnemyHandle handle) const
+		{
+			return m_slotToDense[handle.slot];
+		}
+
+		EnemyHandle HandleAt(size_t index) const
+		{
+			uint32_t slot = m_denseToSlot[index];
+			return EnemyHandle(slot, m_slotGeneration[slot]);
+		}
+
+		void Despawn(EnemyHandle handle)
+		{
+			if (IsAlive(handle))
+			{
+				RemoveAt(m_slotToDense[handle.slot]);
+			}
+		}
+
+		// Removes the enemy at a dense index by moving the last enemy into its place.
+		void RemoveAt(size_t index)
+		{
+			size_t last = m_x.size() - 1;
+			uint32_t slot = m_denseToSlot[index];
+
+			if (index != last)
+			{
+				m_x[index] = m_x[last];
+				m_y[index] = m_y[last];
+				m_prevX[index] = m_prevX[last];
+				m_prevY[index] = m_prevY[last];
+				m_speed[index] = m_speed[last];
+				m_visible[index] = m_visible[last];
+				m_animation[index] = m_animation[last];
+				m_denseToSlot[index] = m_denseToSlot[last];
+				m_slotToDense[m_denseToSlot[index]] = (uint32_t)index;
+			}
+
+			m_x.pop_back();
+			m_y.pop_back();
+			m_prevX.pop_back();
+			m_prevY.pop_back();
+			m_speed.pop_back();
+			m_visible.pop_back();
+			m_animation.pop_back();
+			m_denseToSlot.pop_back();
+
+			m_slotGeneration[slot]++;
+			m_freeSlots.push_back(slot);
+		}
+
+		// Drops every enemy flagged invisible. Walks backwards so each swap
+		// brings in an enemy that has already been checked.
+		size_t RemoveInvisible()
+		{
+			size_t removed = 0;
+			for (size_t i = m_x.size(); i-- > 0;)
+			{
+				if (!m_visible[i])
+				{
+					RemoveAt(i);
+					removed++;
+				}
+			}
+			return removed;
+		}
+
+		void Clear()
+		{
+			while (!m_x.empty())
+			{
+				RemoveAt(m_x.size() - 1);
+			}
+		}
+
+		// Remembers the current positions as the previous tick's, before a tick moves anything.
+		void StorePreviousState()
+		{
+			m_prevX = m_x;
+			m_prevY = m_y;
+		}
+
+		// Moves every enemy left by speed * scale (speed in pixels per second,
+		// scale the step length in seconds) and hides the ones that left the
+		// screen. Four enemies per iteration with SSE2, scalar tail.
+		void Integrate(float scale)
+		{
+			size_t count = m_x.size();
+			size_t i = 0;
+			float* x = m_x.data();
+			const float* speed = m_speed.data();
+			uint8_t* visible = m_visible.data();
+
+#if SIMULATION_USE_SSE2
+			__m128 vscale = _mm_set1_ps(scale);
+			__m128 zero = _mm_setzero_ps();
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 vx = _mm_sub_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(speed + i), vscale));
+				_mm_storeu_ps(x + i, vx);
+
+				int offscreen = _mm_movemask_ps(_mm_cmplt_ps(vx, zero));
+				if (offscreen)
+				{
+					if (offscreen & 1) visible[i + 0] = 0;
+					if (offscreen & 2) visible[i + 1] = 0;
+					if (offscreen & 4) visible[i + 2] = 0;
+					if (offscreen & 8) visible[i + 3] = 0;
+				}
+			}
+#endif
+			for (; i < count; i++)
+			{
+				x[i] -= speed[i] * scale;
+				if (x[i] < 0)
+				{
+					visible[i] = 0;
+				}
+			}
+		}
+
+		// Enemy AI: enemies in [begin, end) still in front of targetX turn
+		// towards targetY by at most maxStep pixels, staying within [0, maxY].
+		// Each enemy only touches its own data, so disjoint ranges may run
+		// on different threads.
+		void Steer(size_t begin, size_t end, float targetX, float targetY, float maxStep, float maxY)
+		{
+			float* x = m_x.data();
+			float* y = m_y.data();
+
+			for (size_t i = begin; i < end; i++)
+			{
+				float step = (std::min)((std::max)(targetY - y[i], -maxStep), maxStep);
+				float newY = (std::min)((std::max)(y[i] + step, 0.f), maxY);
+				y[i] = x[i] > targetX ? newY : y[i];
+			}
+		}
+
+		Rect GetRect(size_t index) const
+		{
+			return Rect(m_x[index], m_y[index], m_width, m_height);
+		}
+
+		size_t Size() const							{ return m_x.size(); }
+		bool Empty() const							{ return m_x.empty(); }
+		float GetWidth() const						{ return m_width; }
+		float GetHeight() const						{ return m_height; }
+
+		// Dense arrays, Size() elements each.
+		float* X()									{ return m_x.data(); }
+		float* Y()									{ return m_y.data(); }
+		float* Speed()								{ return m_speed.data(); }
+		uint8_t* Visible()							{ return m_visible.data(); }
+		const float* X() const						{ return m_x.data(); }
+		const float* PrevX() const					{ return m_prevX.data(); }
+		const float* PrevY() const					{ return m_prevY.data(); }
+		const float* Y() const						{ return m_y.data(); }
+		const float* Speed() const					{ return m_speed.data(); }
+		const uint8_t* Visible() const				{ return m_visible.data(); }
+		const AnimationPlayback* Animation() const	{ return m_animation.data(); }
+
+	private:
+		float										m_width;
+		float										m_height;
+
+		// Dense, index-aligned enemy data.
+		std::vector<float>							m_x;
+		std::vector<float>							m_y;
+		std::vector<float>							m_prevX;
+		std::vector<float>							m_prevY;
+		std::vector<float>							m_speed;
+		std::vector<uint8_t>						m_visible;
+		std::vector<AnimationPlayback>				m_animation;
+		std::vector<uint32_t>						m_denseToSlot;
+
+		// Sparse handle slots.
+		std::vector<uint32_t>						m_slotToDense;
+		std::vector<uint32_t>						m_slotGeneration;
+		std::vector<uint32_t>						m_freeSlots;
+	};
+}
@@ -0,0 +1,99 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Linear allocator for data that lives for one tick or one frame. Allocate
+// bumps a pointer through one block; Reset at the start of the next frame
+// hands the whole block back at once. Nothing is freed on its own and no
+// destructors run, so only trivially destructible types go in.
+//
+// A frame that needs more than the block gets overflow blocks from the
+// heap, which the allocation counter reports. Reset then grows the block
+// to the most the frame used, so after the first few frames the arena
+// settles at the size the game needs and stops allocating.
+
+namespace Simulation
+{
+	class FrameArena
+	{
+	public:
+		explicit FrameArena(size_t capacity = 64 * 1024) :
+			m_capacity(0),
+			m_used(0),
+			m_overflowBytes(0),
+			m_highWater(0)
+		{
+			Grow(capacity);
+		}
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		// Uninitialized room for count objects of T, valid until the next Reset.
+		template<typename T>
+		T* Allocate(size_t count)
+		{
+			static_assert(std::is_trivially_destructible<T>::value, "FrameArena runs no destructors");
+			return static_cast<T*>(AllocateBytes(count * sizeof(T), alignof(T)));
+		}
+
+		void* AllocateBytes(size_t size, size_t alignment = alignof(std::max_align_t))
+		{
+			size_t offset = (m_used + alignment - 1) & ~(alignment - 1);
+			if (offset + size <= m_capacity)
+			{
+				m_used = offset + size;
+				m_highWater = (std::max)(m_highWater, m_used + m_overflowBytes);
+				return m_block.get() + offset;
+			}
+
+			// Does not fit: a block of its own until Reset.
+			m_overflow.emplace_back(new uint8_t[size + alignment]);
+			m_overflowBytes += size + alignment;
+			m_highWater = (std::max)(m_highWater, m_used + m_overflowBytes);
+			uintptr_t address = (uintptr_t)m_overflow.back().get();
+			return (void*)((address + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		}
+
+		// Frees everything allocated since the last Reset.
+		void Reset()
+		{
+			if (!m_overflow.empty())
+			{
+				m_overflow.clear();
+				m_overflowBytes = 0;
+				Grow(m_highWater + m_highWater / 2);
+			}
+			m_used = 0;
+		}
+
+		size_t GetCapacity() const					{ return m_capacity; }
+		size_t GetUsed() const						{ return m_used + m_overflowBytes; }
+
+		// Most bytes any frame has used.
+		size_t GetHighWater() const					{ return m_highWater; }
+
+	private:
+		void Grow(size_t capacity)
+		{
+			m_block.reset(new uint8_t[capacity]);
+			m_capacity = capacity;
+		}
+
+		std::unique_ptr<uint8_t[]>					m_block;
+		size_t										m_capacity;
+		size_t										m_used;
+		std::vector<std::unique_ptr<uint8_t[]>>		m_overflow;
+		size_t										m_overflowBytes;
+		size_t										m_highWater;
+	};
+}
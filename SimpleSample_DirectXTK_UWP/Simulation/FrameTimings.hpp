@@ -0,0 +1,384 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+// Frame time telemetry. Every frame records how long update, render and
+// present took; FrameTimings keeps a rolling window of each in a
+// histogram and reports p50/p95/p99/max, so a hitch shows up as a tail
+// percentile instead of vanishing into an average FPS. Frames can also be
+// streamed to a binary log (FrameLogWriter) for offline analysis with
+// Tools\FrameLogReport.
+//
+// Log layout, all little endian:
+//   header   "PGFT", version, phase count
+//   frames   frame index (64 bit), then nanoseconds (32 bit) per phase
+
+namespace Simulation
+{
+	enum FramePhase
+	{
+		FramePhase_Update,
+		FramePhase_Render,
+		FramePhase_Present,
+		FramePhase_Count
+	};
+
+	inline const char* GetFramePhaseName(FramePhase phase)
+	{
+		static const char* names[FramePhase_Count] = { "update", "render", "present" };
+		return names[phase];
+	}
+
+	struct FrameSample
+	{
+		uint64_t		frame;
+		uint32_t		nanoseconds[FramePhase_Count];
+	};
+
+	// Log-linear histogram of nanosecond values in the style of
+	// HdrHistogram: every power of two is split into 32 buckets, so any
+	// value is known to within 1/32 (about 3%) over the whole 32 bit range
+	// in 896 counters, and adding or removing a value is O(1).
+	class FrameHistogram
+	{
+	public:
+		static const uint32_t SubBucketBits = 5;
+		static const uint32_t SubBuckets = 1u << SubBucketBits;
+		static const uint32_t BucketCount = (32 - SubBucketBits + 1) * SubBuckets;
+
+		FrameHistogram()							{ Clear(); }
+
+		void Clear()
+		{
+			std::memset(m_counts, 0, sizeof(m_counts));
+			m_total = 0;
+		}
+
+		void Add(uint32_t value)					{ m_counts[IndexOf(value)]++; m_total++; }
+		void Remove(uint32_t value)					{ m_counts[IndexOf(value)]--; m_total--; }
+		uint32_t GetCount() const					{ return m_total; }
+
+		// Smallest bucket bound that at least fraction of the values are below or equal to.
+		uint32_t ValueAt(double fraction) const
+		{
+			if (m_total == 0)
+				return 0;
+
+			uint64_t rank = (std::max)((uint64_t)1, (uint64_t)(fraction * m_total + 0.999999));
+			uint64_t seen = 0;
+			for (uint32_t i = 0; i < BucketCount; i++)
+			{
+				seen += m_counts[i];
+				if (seen >= rank)
+					return UpperBound(i);
+			}
+			return UpperBound(BucketCount - 1);
+		}
+
+		static uint32_t IndexOf(uint32_t value)
+		{
+			if (value < SubBuckets)
+				return value;
+
+			uint32_t top = 31;
+			while (!(value >> top))
+				top--;
+
+			uint32_t shift = top - SubBucketBits;
+			return (shift + 1) * SubBuckets + ((value >> shift) & (SubBuckets - 1));
+		}
+
+		static uint32_t UpperBound(uint32_t index)
+		{
+			if (index < SubBuckets)
+				return index;
+
+			uint32_t shift = index / SubBuckets - 1;
+			uint64_t lower = (uint64_t)(SubBuckets + index % SubBuckets) << shift;
+			return (uint32_t)(lower + (1ull << shift) - 1);
+		}
+
+	private:
+		uint32_t		m_counts[BucketCount];
+		uint32_t		m_total;
+	};
+
+	struct FrameTimeStats
+	{
+		uint32_t		samples;
+		float			p50;		// milliseconds
+		float			p95;
+		float			p99;
+		float			max;
+	};
+
+	// Histogram of the last windowSize values; older ones fall out as new ones come in.
+	class FrameTimeWindow
+	{
+	public:
+		explicit FrameTimeWindow(uint32_t windowSize) : m_values(windowSize), m_next(0), m_count(0) {}
+
+		void Add(uint32_t nanoseconds)
+		{
+			if (m_count == m_values.size())
+			{
+				m_histogram.Remove(m_values[m_next]);
+			}
+			else
+			{
+				m_count++;
+			}
+
+			m_values[m_next] = nanoseconds;
+			m_histogram.Add(nanoseconds);
+			m_next = (m_next + 1) % (uint32_t)m_values.size();
+		}
+
+		// Percentiles are bucket bounds, capped at the maximum, which is exact.
+		FrameTimeStats GetStats() const
+		{
+			uint32_t max = m_count ? *std::max_element(m_values.begin(), m_values.begin() + m_count) : 0;
+
+			FrameTimeStats stats;
+			stats.samples = m_count;
+			stats.p50 = ToMilliseconds((std::min)(m_histogram.ValueAt(0.50), max));
+			stats.p95 = ToMilliseconds((std::min)(m_histogram.ValueAt(0.95), max));
+			stats.p99 = ToMilliseconds((std::min)(m_histogram.ValueAt(0.99), max));
+			stats.max = ToMilliseconds(max);
+			return stats;
+		}
+
+	private:
+		static float ToMilliseconds(uint32_t nanoseconds)	{ return nanoseconds * 1e-6f; }
+
+		FrameHistogram				m_histogram;
+		std::vector<uint32_t>		m_values;
+		uint32_t					m_next;
+		uint32_t					m_count;
+	};
+
+	// Streams frame samples to a file. Push is wait free and never
+	// allocates: samples go into a fixed single producer, single consumer
+	// ring that a background thread drains to disk. When the disk falls
+	// behind, samples are dropped and counted rather than stalling a frame.
+	class FrameLogWriter
+	{
+	public:
+		static const uint32_t Version = 1;
+		static const uint32_t Capacity = 1024;
+
+		FrameLogWriter() : m_head(0), m_tail(0), m_dropped(0), m_quit(false) {}
+		~FrameLogWriter()							{ Close(); }
+
+		FrameLogWriter(const FrameLogWriter&) = delete;
+		FrameLogWriter& operator=(const FrameLogWriter&) = delete;
+
+		// path is a narrow or, with MSVC, wide file name.
+		template<typename Char>
+		bool Open(const Char* path)
+		{
+			Close();
+
+			m_file.open(path, std::ios::binary | std::ios::trunc);
+			if (!m_file)
+				return false;
+
+			std::vector<uint8_t> header(Magic(), Magic() + 4);
+			Put32(header, Version);
+			Put32(header, FramePhase_Count);
+			m_file.write((const char*)header.data(), header.size());
+
+			m_quit.store(false);
+			m_thread = std::thread(&FrameLogWriter::WriterMain, this);
+			return true;
+		}
+
+		// Writes what is queued and stops the writer thread.
+		void Close()
+		{
+			if (m_thread.joinable())
+			{
+				m_quit.store(true);
+				m_thread.join();
+			}
+			if (m_file.is_open())
+			{
+				m_file.close();
+			}
+		}
+
+		bool IsOpen() const							{ return m_thread.joinable(); }
+
+		// Called by the one thread producing frames.
+		bool Push(const FrameSample& sample)
+		{
+			uint32_t tail = m_tail.load(std::memory_order_relaxed);
+			if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+			{
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+
+			m_samples[tail % Capacity] = sample;
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		uint64_t GetDroppedCount() const			{ return m_dropped.load(std::memory_order_relaxed); }
+
+		// Reads a whole log; returns false if the stream is not one.
+		static bool Read(std::istream& stream, std::vector<FrameSample>& samples)
+		{
+			samples.clear();
+
+			std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+			const size_t headerSize = 12;
+			const size_t sampleSize = 8 + 4 * FramePhase_Count;
+			if (bytes.size() < headerSize || std::memcmp(bytes.data(), Magic(), 4) != 0 ||
+				Get32(&bytes[4]) != Version || Get32(&bytes[8]) != FramePhase_Count)
+				return false;
+
+			for (size_t offset = headerSize; offset + sampleSize <= bytes.size(); offset += sampleSize)
+			{
+				FrameSample sample;
+				sample.frame = Get32(&bytes[offset]) | ((uint64_t)Get32(&bytes[offset + 4]) << 32);
+				for (int phase = 0; phase < FramePhase_Count; phase++)
+				{
+					sample.nanoseconds[phase] = Get32(&bytes[offset + 8 + 4 * phase]);
+				}
+				samples.push_back(sample);
+			}
+			return true;
+		}
+
+	private:
+		static const uint8_t* Magic()				{ return (const uint8_t*)"PGFT"; }
+
+		static void Put32(std::vector<uint8_t>& bytes, uint32_t value)
+		{
+			for (int i = 0; i < 4; i++)
+				bytes.push_back((uint8_t)(value >> (i * 8)));
+		}
+
+		static uint32_t Get32(const uint8_t* bytes)
+		{
+			return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+		}
+
+		void WriterMain()
+		{
+			std::vector<uint8_t> bytes;
+			bytes.reserve(Capacity * (8 + 4 * FramePhase_Count));
+
+			for (;;)
+			{
+				// Read quit first so the final drain sees every sample pushed before Close.
+				bool quit = m_quit.load();
+
+				bytes.clear();
+				uint32_t head = m_head.load(std::memory_order_relaxed);
+				uint32_t tail = m_tail.load(std::memory_order_acquire);
+				for (; head != tail; head++)
+				{
+					const FrameSample& sample = m_samples[head % Capacity];
+					Put32(bytes, (uint32_t)sample.frame);
+					Put32(bytes, (uint32_t)(sample.frame >> 32));
+					for (int phase = 0; phase < FramePhase_Count; phase++)
+					{
+						Put32(bytes, sample.nanoseconds[phase]);
+					}
+				}
+				m_head.store(head, std::memory_order_release);
+
+				if (!bytes.empty())
+				{
+					m_file.write((const char*)bytes.data(), bytes.size());
+					m_file.flush();
+				}
+
+				if (quit)
+					return;
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			}
+		}
+
+		FrameSample					m_samples[Capacity];
+		std::atomic<uint32_t>		m_head;
+		std::atomic<uint32_t>		m_tail;
+		std::atomic<uint64_t>		m_dropped;
+		std::atomic<bool>			m_quit;
+		std::ofstream				m_file;
+		std::thread					m_thread;
+	};
+
+	// Collects the phases of the current frame and, at EndFrame, adds them
+	// to the rolling windows and the log. Called from the game loop thread.
+	class FrameTimings
+	{
+	public:
+		// 240 frames: the last four seconds at 60 Hz.
+		explicit FrameTimings(uint32_t windowSize = 240) :
+			m_frame(0),
+			m_log(nullptr)
+		{
+			for (int phase = 0; phase < FramePhase_Count; phase++)
+			{
+				m_windows.emplace_back(windowSize);
+			}
+			std::memset(m_current, 0, sizeof(m_current));
+		}
+
+		static uint64_t Now()
+		{
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Not owned; null stops logging.
+		void SetLog(FrameLogWriter* log)			{ m_log = log; }
+
+		// Adds to the phase, which may run several times in one frame (catch-up updates).
+		void Record(FramePhase phase, uint64_t nanoseconds)
+		{
+			m_current[phase] += nanoseconds;
+		}
+
+		void EndFrame()
+		{
+			FrameSample sample;
+			sample.frame = m_frame++;
+			for (int phase = 0; phase < FramePhase_Count; phase++)
+			{
+				sample.nanoseconds[phase] = (uint32_t)(std::min)(m_current[phase], (uint64_t)UINT32_MAX);
+				m_windows[phase].Add(sample.nanoseconds[phase]);
+				m_current[phase] = 0;
+			}
+
+			if (m_log)
+			{
+				m_log->Push(sample);
+			}
+		}
+
+		FrameTimeStats GetStats(FramePhase phase) const	{ return m_windows[phase].GetStats(); }
+		uint64_t GetFrameCount() const					{ return m_frame; }
+
+	private:
+		std::vector<FrameTimeWindow>	m_windows;
+		uint64_t						m_current[FramePhase_Count];
+		uint64_t						m_frame;
+		FrameLogWriter*					m_log;
+	};
+}
@@ -0,0 +1,77 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <cstdint>
+
+#include "FrameTimings.hpp"
+
+// Input to present latency. Input is stamped with FrameTimings::Now() when
+// it reaches the game, the frame that reads it takes the stamps over, and
+// when that frame has been presented the time since the oldest of them is
+// added to a rolling window. Frames that read no new input add nothing, so
+// the percentiles are those of frames the player could see react.
+//
+// Present returning is the closest the game gets to the photons: with a
+// vsync interval of 1 the frame is scanned out at the next vblank, so the
+// real figure is higher by up to a refresh plus the display's own delay.
+// Everything is called from the game loop thread; CoreWindow events are
+// dispatched by ProcessEvents on it too.
+
+namespace Simulation
+{
+	class InputLatency
+	{
+	public:
+		// 240 frames with input: a few seconds of play.
+		explicit InputLatency(uint32_t windowSize = 240) :
+			m_window(windowSize),
+			m_pending(0),
+			m_frame(0)
+		{
+		}
+
+		// Input arrived at timestamp; the earliest not yet read is kept.
+		void OnInput(uint64_t timestamp)
+		{
+			if (m_pending == 0 || timestamp < m_pending)
+			{
+				m_pending = timestamp;
+			}
+		}
+
+		// The frame being built read the input that has arrived so far.
+		// May be called more than once a frame, e.g. by catch-up updates or
+		// a late latch; the frame keeps the oldest input it read.
+		void Consume()
+		{
+			if (m_pending != 0 && (m_frame == 0 || m_pending < m_frame))
+			{
+				m_frame = m_pending;
+			}
+			m_pending = 0;
+		}
+
+		// Forgets input nothing is going to read, e.g. while loading.
+		void Discard()								{ m_pending = 0; }
+
+		// The frame that consumed the input has been presented at now.
+		void OnPresent(uint64_t now)
+		{
+			if (m_frame != 0)
+			{
+				uint64_t latency = now > m_frame ? now - m_frame : 0;
+				m_window.Add((uint32_t)(std::min)(latency, (uint64_t)UINT32_MAX));
+				m_frame = 0;
+			}
+		}
+
+		FrameTimeStats GetStats() const				{ return m_window.GetStats(); }
+
+	private:
+		FrameTimeWindow		m_window;
+		uint64_t			m_pending;		// Oldest input not read yet, 0 if none.
+		uint64_t			m_frame;		// Oldest input read by the frame being built, 0 if none.
+	};
+}
@@ -0,0 +1,317 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <vector>
+
+#include "World.hpp"
+
+// Binary log of the input fed to the simulation, one entry per tick, plus
+// everything needed to rebuild the world it was fed to (config, seed and
+// step length). Replaying a log through a World created from it repeats
+// the session exactly, which turns a play session into a repeatable
+// performance test.
+//
+// Layout, all little endian:
+//   header   "PGIL", version, seed, step seconds, tick count, world config
+//            including its course config
+//   runs     tick count, action bits, MoveX, MoveY
+// Consecutive identical ticks are stored as one run, so holding a key or
+// idling costs 16 bytes however long it lasts.
+//
+// A recording log holds at most the number of runs Begin reserves, so
+// Record never allocates; once it is full the log keeps the session up to
+// that tick, which still replays.
+
+namespace Simulation
+{
+	class InputLog
+	{
+	public:
+		InputLog() : m_seed(0), m_stepSeconds(0.f), m_tickCount(0), m_maxRuns(0) {}
+
+		// Starts a new log for a world created with config and running on
+		// seed, with room for maxRuns runs. Runs only start when the input
+		// changes, so the default lasts hours of play.
+		void Begin(const WorldConfig& config, uint64_t seed, float stepSeconds, size_t maxRuns = DefaultMaxRuns)
+		{
+			m_config = config;
+			m_config.seed = seed;
+			m_seed = seed;
+			m_stepSeconds = stepSeconds;
+			m_tickCount = 0;
+			m_maxRuns = maxRuns;
+			m_runs.clear();
+			m_runs.reserve(maxRuns);
+		}
+
+		// Appends the input of one tick. Returns false, recording nothing,
+		// once the tick would need a run past the ones Begin made room for.
+		bool Record(const PlayerInput& input)
+		{
+			if (!m_runs.empty() && SameInput(m_runs.back().input, input) && m_runs.back().ticks != 0xffffffffu)
+			{
+				m_runs.back().ticks++;
+			}
+			else
+			{
+				if (m_runs.size() >= m_maxRuns)
+					return false;
+
+				Run run;
+				run.ticks = 1;
+				run.input = input;
+				m_runs.push_back(run);
+			}
+			m_tickCount++;
+			return true;
+		}
+
+		const WorldConfig& GetConfig() const		{ return m_config; }
+		uint64_t GetSeed() const					{ return m_seed; }
+		float GetStepSeconds() const				{ return m_stepSeconds; }
+		uint64_t GetTickCount() const				{ return m_tickCount; }
+		size_t GetRunCount() const					{ return m_runs.size(); }
+
+		// Walks the log tick by tick.
+		class Cursor
+		{
+		public:
+			explicit Cursor(const InputLog& log) : m_log(&log), m_run(0), m_tickInRun(0) {}
+
+			// Returns false once every tick has been read.
+			bool Next(PlayerInput& input)
+			{
+				if (m_run == m_log->m_runs.size())
+					return false;
+
+				const Run& run = m_log->m_runs[m_run];
+				input = run.input;
+				if (++m_tickInRun == run.ticks)
+				{
+					m_run++;
+					m_tickInRun = 0;
+				}
+				return true;
+			}
+
+		private:
+			const InputLog*		m_log;
+			size_t				m_run;
+			uint32_t			m_tickInRun;
+		};
+
+		bool Write(std::ostream& stream) const
+		{
+			std::vector<uint8_t> bytes;
+			bytes.insert(bytes.end(), Magic(), Magic() + 4);
+			Put32(bytes, Version);
+			Put64(bytes, m_seed);
+			PutFloat(bytes, m_stepSeconds);
+			Put64(bytes, m_tickCount);
+
+			PutFloat(bytes, m_config.screenSize.Width);
+			PutFloat(bytes, m_config.screenSize.Height);
+			Put32(bytes, (uint32_t)m_config.playerWidth);
+			Put32(bytes, (uint32_t)m_config.playerHeight);
+			Put32(bytes, (uint32_t)m_config.enemyWidth);
+			Put32(bytes, (uint32_t)m_config.enemyHeight);
+			Put32(bytes, (uint32_t)m_config.wallWidth);
+			PutFloat(bytes, m_config.playerSpeed);
+			Put32(bytes, m_config.maxEnemies);
+			Put32(bytes, m_config.spawnPerTick);
+			Put32(bytes, (uint32_t)m_config.enemyMinSpeed);
+			Put32(bytes, (uint32_t)m_config.enemyMaxSpeed);
+			PutFloat(bytes, m_config.enemySteer);
+
+			const CourseConfig& course = m_config.course;
+			PutFloat(bytes, course.scrollSpeed);
+			PutFloat(bytes, course.spacing);
+			PutFloat(bytes, course.lookahead);
+			PutFloat(bytes, course.startGap);
+			PutFloat(bytes, course.minGap);
+			PutFloat(bytes, course.difficultyDistance);
+			PutFloat(bytes, course.maxGapShift);
+			Put32(bytes, course.batchSize);
+
+			Put64(bytes, m_runs.size());
+			for (const Run& run : m_runs)
+			{
+				Put32(bytes, run.ticks);
+				Put32(bytes, run.input.Actions);
+				PutFloat(bytes, run.input.MoveX);
+				PutFloat(bytes, run.input.MoveY);
+			}
+
+			stream.write((const char*)bytes.data(), bytes.size());
+			return !stream.fail();
+		}
+
+		// Returns false, leaving the log empty, if the stream is not a complete log of this version.
+		bool Read(std::istream& stream)
+		{
+			std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+			Reader reader(bytes);
+
+			*this = InputLog();
+
+			uint8_t magic[4];
+			if (!reader.Bytes(magic, 4) || std::memcmp(magic, Magic(), 4) != 0 || reader.Get32() != Version)
+				return false;
+
+			InputLog log;
+			log.m_seed = reader.Get64();
+			log.m_stepSeconds = reader.GetFloat();
+			log.m_tickCount = reader.Get64();
+
+			WorldConfig& config = log.m_config;
+			config.screenSize.Width = reader.GetFloat();
+			config.screenSize.Height = reader.GetFloat();
+			config.playerWidth = (int)reader.Get32();
+			config.playerHeight = (int)reader.Get32();
+			config.enemyWidth = (int)reader.Get32();
+			config.enemyHeight = (int)reader.Get32();
+			config.wallWidth = (int)reader.Get32();
+			config.playerSpeed = reader.GetFloat();
+			config.maxEnemies = reader.Get32();
+			config.spawnPerTick = reader.Get32();
+			config.enemyMinSpeed = (int)reader.Get32();
+			config.enemyMaxSpeed = (int)reader.Get32();
+			config.enemySteer = reader.GetFloat();
+			config.seed = log.m_seed;
+
+			CourseConfig& course = config.course;
+			course.scrollSpeed = reader.GetFloat();
+			course.spacing = reader.GetFloat();
+			course.lookahead = reader.GetFloat();
+			course.startGap = reader.GetFloat();
+			course.minGap = reader.GetFloat();
+			course.difficultyDistance = reader.GetFloat();
+			course.maxGapShift = reader.GetFloat();
+			course.batchSize = reader.Get32();
+
+			uint64_t runCount = reader.Get64();
+			uint64_t ticks = 0;
+			for (uint64_t i = 0; i < runCount && reader.Ok(); i++)
+			{
+				Run run;
+				run.ticks = reader.Get32();
+				run.input.Actions = reader.Get32();
+				run.input.MoveX = reader.GetFloat();
+				run.input.MoveY = reader.GetFloat();
+
+				// Cursor::Next only leaves a run after its last tick, so an empty one would never end.
+				if (run.ticks == 0)
+					return false;
+
+				ticks += run.ticks;
+				log.m_runs.push_back(run);
+			}
+
+			if (!reader.Ok() || ticks != log.m_tickCount)
+				return false;
+
+			log.m_maxRuns = log.m_runs.size();
+			*this = log;
+			return true;
+		}
+
+	private:
+		// 2: walls come from a Course, whose config follows the world's.
+		static const uint32_t Version = 2;
+		static const uint8_t* Magic()			{ return (const uint8_t*)"PGIL"; }
+
+		struct Run
+		{
+			uint32_t		ticks;
+			PlayerInput		input;
+		};
+
+		static bool SameInput(const PlayerInput& a, const PlayerInput& b)
+		{
+			return a.Actions == b.Actions && a.MoveX == b.MoveX && a.MoveY == b.MoveY;
+		}
+
+		static void Put32(std::vector<uint8_t>& bytes, uint32_t value)
+		{
+			for (int i = 0; i < 4; i++)
+				bytes.push_back((uint8_t)(value >> (i * 8)));
+		}
+
+		static void Put64(std::vector<uint8_t>& bytes, uint64_t value)
+		{
+			Put32(bytes, (uint32_t)value);
+			Put32(bytes, (uint32_t)(value >> 32));
+		}
+
+		static void PutFloat(std::vector<uint8_t>& bytes, float value)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			Put32(bytes, bits);
+		}
+
+		// Bounds checked little endian reads; once past the end every read returns 0.
+		class Reader
+		{
+		public:
+			explicit Reader(const std::vector<uint8_t>& bytes) : m_bytes(bytes), m_offset(0), m_ok(true) {}
+
+			bool Bytes(uint8_t* out, size_t count)
+			{
+				if (!m_ok || m_bytes.size() - m_offset < count)
+				{
+					m_ok = false;
+					std::memset(out, 0, count);
+					return false;
+				}
+				std::memcpy(out, m_bytes.data() + m_offset, count);
+				m_offset += count;
+				return true;
+			}
+
+			uint32_t Get32()
+			{
+				uint8_t b[4];
+				Bytes(b, 4);
+				return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+			}
+
+			uint64_t Get64()
+			{
+				uint64_t low = Get32();
+				return low | ((uint64_t)Get32() << 32);
+			}
+
+			float GetFloat()
+			{
+				uint32_t bits = Get32();
+				float value;
+				std::memcpy(&value, &bits, sizeof(value));
+				return value;
+			}
+
+			bool Ok() const			{ return m_ok; }
+
+		private:
+			const std::vector<uint8_t>&		m_bytes;
+			size_t							m_offset;
+			bool							m_ok;
+		};
+
+		WorldConfig								m_config;
+		uint64_t								m_seed;
+		float									m_stepSeconds;
+		uint64_t								m_tickCount;
+		size_t									m_maxRuns;		// Runs Record may add; a log read from a stream is full.
+		std::vector<Run>						m_runs;
+
+		static const size_t						DefaultMaxRuns = 64 * 1024;
+	};
+}
@@ -0,0 +1,262 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Profiler.hpp"
+
+// Persistent work-stealing thread pool. Workers are created once and sleep
+// while there is nothing to do; ParallelFor splits a range into chunks,
+// deals them out over the per-thread queues and has the calling thread
+// work along until every chunk has run. Idle threads steal chunks from the
+// front of the other queues, so uneven chunks still balance out.
+//
+// Submitting work does not allocate: jobs are small records in fixed-size
+// ring buffers, and the loop body is called through a plain function
+// pointer rather than a std::function. Loop bodies must not throw.
+
+namespace Simulation
+{
+	class JobSystem
+	{
+	public:
+		// threadCount counts the calling thread too; 0 uses every hardware thread.
+		explicit JobSystem(unsigned int threadCount = 0) :
+			m_queuedJobs(0),
+			m_quit(false)
+		{
+			if (threadCount == 0)
+			{
+				threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+			}
+
+			for (unsigned int i = 0; i < threadCount; i++)
+			{
+				m_queues.emplace_back(new JobQueue());
+			}
+
+			// Queue 0 belongs to the threads that call ParallelFor.
+			for (unsigned int i = 1; i < threadCount; i++)
+			{
+				m_workers.emplace_back(&JobSystem::WorkerMain, this, i);
+			}
+		}
+
+		~JobSystem()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+				m_quit = true;
+			}
+			m_wake.notify_all();
+
+			for (auto& worker : m_workers)
+			{
+				worker.join();
+			}
+		}
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		unsigned int GetThreadCount() const		{ return (unsigned int)m_queues.size(); }
+
+		// Calls body(begin, end) over [0, count) in chunks of about grainSize
+		// elements and returns once all of them have finished. Small ranges
+		// run inline on the calling thread.
+		template<typename Body>
+		void ParallelFor(size_t count, size_t grainSize, const Body& body)
+		{
+			grainSize = (std::max<size_t>)(grainSize, 1);
+			if (count == 0)
+				return;
+
+			if (m_workers.empty() || count <= grainSize)
+			{
+				body((size_t)0, count);
+				return;
+			}
+
+			// No more chunks than a few per thread, so the bookkeeping stays small.
+			size_t chunkCount = (std::min)((count + grainSize - 1) / grainSize, (size_t)GetThreadCount() * 4);
+			size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+			chunkCount = (count + chunkSize - 1) / chunkSize;
+
+			std::atomic<size_t> pending(chunkCount);
+			size_t home = CurrentQueue();
+
+			for (size_t chunk = 0; chunk < chunkCount; chunk++)
+			{
+				Job job;
+				job.function = &InvokeBody<Body>;
+				job.context = &body;
+				job.begin = chunk * chunkSize;
+				job.end = (std::min)(count, job.begin + chunkSize);
+				job.pending = &pending;
+
+				// Deal chunks round-robin, starting with our own queue. A full
+				// queue just means the chunk runs right here.
+				m_queuedJobs.fetch_add(1);
+				if (!m_queues[(home + chunk) % m_queues.size()]->Push(job))
+				{
+					m_queuedJobs.fetch_sub(1);
+					Execute(job);
+				}
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+			}
+			m_wake.notify_all();
+
+			// Help out until our own chunks are done; this may also run chunks
+			// of other ParallelFor calls, which is fine.
+			while (pending.load(std::memory_order_acquire) > 0)
+			{
+				Job job;
+				if (TryPop(home, job))
+				{
+					Execute(job);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+	private:
+		struct Job
+		{
+			void (*function)(const void* context, size_t begin, size_t end);
+			const void*				context;
+			size_t					begin;
+			size_t					end;
+			std::atomic<size_t>*	pending;
+		};
+
+		// Ring buffer of jobs. The owner pops the newest job from the back,
+		// thieves take the oldest from the front.
+		class JobQueue
+		{
+		public:
+			JobQueue() : m_head(0), m_count(0) {}
+
+			bool Push(const Job& job)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (m_count == Capacity)
+					return false;
+
+				m_jobs[(m_head + m_count) % Capacity] = job;
+				m_count++;
+				return true;
+			}
+
+			bool PopBack(Job& job)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (m_count == 0)
+					return false;
+
+				m_count--;
+				job = m_jobs[(m_head + m_count) % Capacity];
+				return true;
+			}
+
+			bool StealFront(Job& job)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (m_count == 0)
+					return false;
+
+				job = m_jobs[m_head];
+				m_head = (m_head + 1) % Capacity;
+				m_count--;
+				return true;
+			}
+
+		private:
+			static const size_t Capacity = 256;
+
+			std::mutex				m_mutex;
+			Job						m_jobs[Capacity];
+			size_t					m_head;
+			size_t					m_count;
+		};
+
+		template<typename Body>
+		static void InvokeBody(const void* context, size_t begin, size_t end)
+		{
+			(*static_cast<const Body*>(context))(begin, end);
+		}
+
+		static void Execute(const Job& job)
+		{
+			PROFILE_ZONE("Job");
+			job.function(job.context, job.begin, job.end);
+			job.pending->fetch_sub(1, std::memory_order_release);
+		}
+
+		// Index of the queue owned by the current thread; threads outside the pool share queue 0.
+		static size_t& CurrentQueue()
+		{
+			thread_local size_t queue = 0;
+			return queue;
+		}
+
+		bool TryPop(size_t home, Job& job)
+		{
+			bool found = m_queues[home]->PopBack(job);
+			for (size_t i = 1; !found && i < m_queues.size(); i++)
+			{
+				found = m_queues[(home + i) % m_queues.size()]->StealFront(job);
+			}
+
+			if (found)
+			{
+				m_queuedJobs.fetch_sub(1);
+			}
+			return found;
+		}
+
+		void WorkerMain(size_t queue)
+		{
+			CurrentQueue() = queue;
+			Profiler::Get().SetThreadName("Job worker");
+
+			for (;;)
+			{
+				Job job;
+				if (TryPop(queue, job))
+				{
+					Execute(job);
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(m_sleepMutex);
+				m_wake.wait(lock, [this]() { return m_quit || m_queuedJobs.load() > 0; });
+				if (m_quit)
+					return;
+			}
+		}
+
+		std::vector<std::unique_ptr<JobQueue>>		m_queues;
+		std::vector<std::thread>					m_workers;
+
+		// Jobs pushed but not yet taken; workers sleep while it is zero.
+		std::atomic<size_t>							m_queuedJobs;
+		std::mutex									m_sleepMutex;
+		std::condition_variable						m_wake;
+		bool										m_quit;
+	};
+}
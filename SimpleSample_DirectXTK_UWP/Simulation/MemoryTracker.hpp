@@ -0,0 +1,414 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+
+#include "AllocationCounter.hpp"
+
+// Memory use per subsystem. Every allocation is charged to a tag; for each
+// tag the tracker keeps the live bytes, the live and total allocation
+// counts and the most bytes ever live at once, and a budget the live bytes
+// are checked against. Snapshot reads all of it at any time and
+// WriteMemoryReport turns a snapshot into a table for a file.
+//
+// Heap memory is charged to the tag of the allocating thread, set with
+// MemoryTagScope around the subsystem's work, once a program replaces the
+// global operator new with SIMULATION_DEFINE_MEMORY_TRACKER. Each block
+// then carries a small header naming its tag and size, so it is credited
+// back to the right tag whichever thread frees it. Memory the heap does not
+// see, such as textures in video memory, is reported with Add and Remove.
+//
+// Every thread counts into its own cache line, so allocating threads never
+// contend; the counts are only added up by Snapshot. The high-water marks
+// are therefore the most a snapshot or SampleHighWater has seen, which for
+// a game taking one every frame is the peak of any frame.
+
+namespace Simulation
+{
+	enum MemoryTag : uint8_t
+	{
+		MemoryTag_Untagged,
+		MemoryTag_Input,
+		MemoryTag_Entities,
+		MemoryTag_Assets,
+		MemoryTag_Audio,
+		MemoryTag_Overlays,
+		MemoryTag_Textures,		// video memory, estimated from the texture descriptions
+		MemoryTag_Count
+	};
+
+	inline const char* GetMemoryTagName(MemoryTag tag)
+	{
+		static const char* names[MemoryTag_Count] = { "untagged", "input", "entities", "assets", "audio", "overlays", "textures" };
+		return names[tag];
+	}
+
+	struct MemoryTagStats
+	{
+		uint64_t		liveBytes;
+		uint64_t		liveAllocations;
+		uint64_t		totalAllocations;
+		uint64_t		highWaterBytes;
+		uint64_t		budgetBytes;		// 0 when the tag has no budget
+
+		bool IsOverBudget() const			{ return budgetBytes != 0 && liveBytes > budgetBytes; }
+	};
+
+	struct MemorySnapshot
+	{
+		MemoryTagStats	tags[MemoryTag_Count];
+		bool			heapTracked;		// false when operator new is not replaced; only Add and Remove are counted
+
+		// Live bytes of every tag but MemoryTag_Textures.
+		uint64_t GetHeapBytes() const
+		{
+			uint64_t bytes = 0;
+			for (int tag = 0; tag < MemoryTag_Count; tag++)
+			{
+				if (tag != MemoryTag_Textures)
+					bytes += tags[tag].liveBytes;
+			}
+			return bytes;
+		}
+
+		bool IsOverBudget() const
+		{
+			for (const MemoryTagStats& stats : tags)
+			{
+				if (stats.IsOverBudget())
+					return true;
+			}
+			return false;
+		}
+	};
+
+	class MemoryTracker
+	{
+	public:
+		// Called from operator new, so neither constructing the tracker nor
+		// anything below may allocate.
+		static MemoryTracker& Get()
+		{
+			static MemoryTracker tracker;
+			return tracker;
+		}
+
+		void Add(MemoryTag tag, uint64_t bytes)
+		{
+			ThreadCounters& counters = GetThreadCounters();
+			Bump(counters.liveBytes[tag], (int64_t)bytes);
+			Bump(counters.allocations[tag], (uint64_t)1);
+		}
+
+		void Remove(MemoryTag tag, uint64_t bytes)
+		{
+			ThreadCounters& counters = GetThreadCounters();
+			Bump(counters.liveBytes[tag], -(int64_t)bytes);
+			Bump(counters.frees[tag], (uint64_t)1);
+		}
+
+		// 0 removes the budget.
+		void SetBudget(MemoryTag tag, uint64_t bytes)	{ m_budgets[tag].store(bytes, std::memory_order_relaxed); }
+
+		// Starts the high-water marks over from the live bytes, e.g. before a level.
+		void ResetHighWater()
+		{
+			int64_t live[MemoryTag_Count];
+			SumLiveBytes(live);
+			for (int tag = 0; tag < MemoryTag_Count; tag++)
+			{
+				m_highWater[tag].store(Clamp(live[tag]), std::memory_order_relaxed);
+			}
+		}
+
+		// Raises the high-water marks to the live bytes. Snapshot does this
+		// too; a program that takes no snapshot every frame calls it instead.
+		void SampleHighWater()
+		{
+			int64_t live[MemoryTag_Count];
+			SumLiveBytes(live);
+			for (int tag = 0; tag < MemoryTag_Count; tag++)
+			{
+				RaiseHighWater((MemoryTag)tag, Clamp(live[tag]));
+			}
+		}
+
+		MemorySnapshot Snapshot()
+		{
+			int64_t live[MemoryTag_Count] = {};
+			uint64_t allocations[MemoryTag_Count] = {};
+			uint64_t frees[MemoryTag_Count] = {};
+			for (const ThreadCounters* counters = m_threads.load(std::memory_order_acquire); counters; counters = counters->next)
+			{
+				for (int tag = 0; tag < MemoryTag_Count; tag++)
+				{
+					live[tag] += counters->liveBytes[tag].load(std::memory_order_relaxed);
+					allocations[tag] += counters->allocations[tag].load(std::memory_order_relaxed);
+					frees[tag] += counters->frees[tag].load(std::memory_order_relaxed);
+				}
+			}
+
+			MemorySnapshot snapshot;
+			for (int tag = 0; tag < MemoryTag_Count; tag++)
+			{
+				MemoryTagStats& stats = snapshot.tags[tag];
+				stats.liveBytes = Clamp(live[tag]);
+				stats.totalAllocations = allocations[tag];
+				stats.liveAllocations = allocations[tag] > frees[tag] ? allocations[tag] - frees[tag] : 0;
+				stats.highWaterBytes = RaiseHighWater((MemoryTag)tag, stats.liveBytes);
+				stats.budgetBytes = m_budgets[tag].load(std::memory_order_relaxed);
+			}
+			snapshot.heapTracked = m_heapTracked.load(std::memory_order_relaxed);
+			return snapshot;
+		}
+
+		// Tag heap allocations of the calling thread are charged to.
+		static MemoryTag GetThreadTag()					{ return ThreadTag(); }
+		static void SetThreadTag(MemoryTag tag)			{ ThreadTag() = tag; }
+
+		// Set by SIMULATION_DEFINE_MEMORY_TRACKER.
+		void SetHeapTracked(bool tracked)				{ m_heapTracked.store(tracked, std::memory_order_relaxed); }
+
+	private:
+		// Counts of the thread that owns the block, which is the only one
+		// writing them, so counting is a plain load and store on a cache line
+		// no other thread writes. Blocks are never freed: the block of a
+		// thread that exits is taken over by the next new thread, whose
+		// counts simply add to it. Frees are counted on the freeing thread,
+		// so one block's live bytes may be negative; the sum is not.
+		struct alignas(64) ThreadCounters
+		{
+			std::atomic<int64_t>	liveBytes[MemoryTag_Count];
+			std::atomic<uint64_t>	allocations[MemoryTag_Count];
+			std::atomic<uint64_t>	frees[MemoryTag_Count];
+			std::atomic<bool>		owned;
+			ThreadCounters*			next;
+		};
+
+		// Gives the calling thread's block back when the thread exits.
+		struct ThreadRelease
+		{
+			~ThreadRelease()
+			{
+				ThreadCounters*& counters = ThreadCountersOf();
+				if (counters)
+				{
+					counters->owned.store(false, std::memory_order_release);
+					counters = nullptr;
+				}
+			}
+		};
+
+		MemoryTracker() : m_threads(nullptr), m_heapTracked(false)
+		{
+			for (int tag = 0; tag < MemoryTag_Count; tag++)
+			{
+				m_highWater[tag].store(0);
+				m_budgets[tag].store(0);
+			}
+		}
+
+		template <typename T>
+		static void Bump(std::atomic<T>& counter, T delta)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+		}
+
+		static uint64_t Clamp(int64_t bytes)			{ return bytes > 0 ? (uint64_t)bytes : 0; }
+
+		static ThreadCounters*& ThreadCountersOf()
+		{
+			static thread_local ThreadCounters* counters = nullptr;
+			return counters;
+		}
+
+		ThreadCounters& GetThreadCounters()
+		{
+			ThreadCounters*& counters = ThreadCountersOf();
+			if (!counters)
+			{
+				counters = ClaimThreadCounters();
+				// A thread still allocating after its release has run claims
+				// another block and keeps it; that only happens during exit.
+				static thread_local ThreadRelease release;
+				(void)release;
+			}
+			return *counters;
+		}
+
+		ThreadCounters* ClaimThreadCounters()
+		{
+			ThreadCounters* head = m_threads.load(std::memory_order_acquire);
+			for (ThreadCounters* counters = head; counters; counters = counters->next)
+			{
+				bool owned = false;
+				if (!counters->owned.load(std::memory_order_relaxed) &&
+					counters->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+					return counters;
+			}
+
+			// malloc, not new, which would come back here; aligned by hand.
+			void* memory = std::malloc(sizeof(ThreadCounters) + alignof(ThreadCounters));
+			if (!memory)
+				std::abort();
+			uintptr_t aligned = ((uintptr_t)memory + alignof(ThreadCounters) - 1) & ~(uintptr_t)(alignof(ThreadCounters) - 1);
+			ThreadCounters* counters = reinterpret_cast<ThreadCounters*>(aligned);
+			for (int tag = 0; tag < MemoryTag_Count; tag++)
+			{
+				counters->liveBytes[tag].store(0, std::memory_order_relaxed);
+				counters->allocations[tag].store(0, std::memory_order_relaxed);
+				counters->frees[tag].store(0, std::memory_order_relaxed);
+			}
+			counters->owned.store(true, std::memory_order_relaxed);
+
+			counters->next = head;
+			while (!m_threads.compare_exchange_weak(counters->next, counters, std::memory_order_release, std::memory_order_relaxed))
+			{
+			}
+			return counters;
+		}
+
+		void SumLiveBytes(int64_t (&live)[MemoryTag_Count]) const
+		{
+			for (int tag = 0; tag < MemoryTag_Count; tag++)
+			{
+				live[tag] = 0;
+			}
+			for (const ThreadCounters* counters = m_threads.load(std::memory_order_acquire); counters; counters = counters->next)
+			{
+				for (int tag = 0; tag < MemoryTag_Count; tag++)
+				{
+					live[tag] += counters->liveBytes[tag].load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		uint64_t RaiseHighWater(MemoryTag tag, uint64_t live)
+		{
+			uint64_t highWater = m_highWater[tag].load(std::memory_order_relaxed);
+			while (live > highWater && !m_highWater[tag].compare_exchange_weak(highWater, live, std::memory_order_relaxed))
+			{
+			}
+			return (std::max)(highWater, live);
+		}
+
+		static MemoryTag& ThreadTag()
+		{
+			static thread_local MemoryTag tag = MemoryTag_Untagged;
+			return tag;
+		}
+
+		std::atomic<ThreadCounters*>	m_threads;
+		std::atomic<uint64_t>			m_highWater[MemoryTag_Count];
+		std::atomic<uint64_t>			m_budgets[MemoryTag_Count];
+		std::atomic<bool>				m_heapTracked;
+	};
+
+	// Charges the calling thread's heap allocations to tag until destroyed.
+	class MemoryTagScope
+	{
+	public:
+		explicit MemoryTagScope(MemoryTag tag) : m_previous(MemoryTracker::GetThreadTag())
+		{
+			MemoryTracker::SetThreadTag(tag);
+		}
+
+		~MemoryTagScope()
+		{
+			MemoryTracker::SetThreadTag(m_previous);
+		}
+
+		MemoryTagScope(const MemoryTagScope&) = delete;
+		MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+	private:
+		MemoryTag					m_previous;
+	};
+
+	// One line per tag, sizes in KiB; tags over their budget are marked.
+	inline bool WriteMemoryReport(std::ostream& stream, const MemorySnapshot& snapshot)
+	{
+		char line[160];
+		std::snprintf(line, sizeof(line), "%-10s %12s %12s %12s %12s %12s\n", "tag", "live KiB", "live allocs", "total allocs", "peak KiB", "budget KiB");
+		stream << line;
+
+		for (int tag = 0; tag < MemoryTag_Count; tag++)
+		{
+			const MemoryTagStats& stats = snapshot.tags[tag];
+			std::snprintf(line, sizeof(line), "%-10s %12.1f %12llu %12llu %12.1f %12.1f%s\n", GetMemoryTagName((MemoryTag)tag),
+				stats.liveBytes / 1024.0, (unsigned long long)stats.liveAllocations, (unsigned long long)stats.totalAllocations,
+				stats.highWaterBytes / 1024.0, stats.budgetBytes / 1024.0, stats.IsOverBudget() ? "  over budget" : "");
+			stream << line;
+		}
+
+		if (!snapshot.heapTracked)
+		{
+			stream << "heap allocations are not tracked in this build\n";
+		}
+		return !!stream;
+	}
+}
+
+// Replaces the global operator new and delete with versions on top of
+// malloc that charge every block to the allocating thread's tag and count
+// it for AllocationCounter. Use at namespace scope in one source file of
+// the program, instead of SIMULATION_DEFINE_ALLOCATION_COUNTER.
+#define SIMULATION_DEFINE_MEMORY_TRACKER \
+	SIMULATION_ALLOCATION_COUNTER_PRAGMA \
+	namespace \
+	{ \
+		struct TrackedBlockHeader \
+		{ \
+			uint64_t					size; \
+			Simulation::MemoryTag		tag; \
+		}; \
+		static_assert(sizeof(TrackedBlockHeader) <= 16, "the header must keep blocks 16 byte aligned"); \
+		const std::size_t TrackedHeaderSize = 16; \
+		void* AllocateTracked(std::size_t size) \
+		{ \
+			Simulation::AllocationCounter::Note(); \
+			void* memory = std::malloc(TrackedHeaderSize + size); \
+			if (!memory) \
+				return nullptr; \
+			TrackedBlockHeader* header = static_cast<TrackedBlockHeader*>(memory); \
+			header->size = size; \
+			header->tag = Simulation::MemoryTracker::GetThreadTag(); \
+			Simulation::MemoryTracker::Get().Add(header->tag, size); \
+			return static_cast<char*>(memory) + TrackedHeaderSize; \
+		} \
+		void FreeTracked(void* memory) \
+		{ \
+			if (!memory) \
+				return; \
+			TrackedBlockHeader* header = reinterpret_cast<TrackedBlockHeader*>(static_cast<char*>(memory) - TrackedHeaderSize); \
+			Simulation::MemoryTracker::Get().Remove(header->tag, header->size); \
+			std::free(header); \
+		} \
+		struct HeapTrackingInstalled \
+		{ \
+			HeapTrackingInstalled()		{ Simulation::MemoryTracker::Get().SetHeapTracked(true); } \
+		} heapTrackingInstalled; \
+	} \
+	void* operator new(std::size_t size) \
+	{ \
+		if (void* memory = AllocateTracked(size)) \
+			return memory; \
+		throw std::bad_alloc(); \
+	} \
+	void* operator new[](std::size_t size)						{ return operator new(size); } \
+	void* operator new(std::size_t size, const std::nothrow_t&) noexcept		{ return AllocateTracked(size); } \
+	void* operator new[](std::size_t size, const std::nothrow_t&) noexcept	{ return AllocateTracked(size); } \
+	void operator delete(void* memory) noexcept					{ FreeTracked(memory); } \
+	void operator delete[](void* memory) noexcept					{ FreeTracked(memory); } \
+	void operator delete(void* memory, std::size_t) noexcept		{ FreeTracked(memory); } \
+	void operator delete[](void* memory, std::size_t) noexcept		{ FreeTracked(memory); } \
+	void operator delete(void* memory, const std::nothrow_t&) noexcept		{ FreeTracked(memory); } \
+	void operator delete[](void* memory, const std::nothrow_t&) noexcept	{ FreeTracked(memory); }
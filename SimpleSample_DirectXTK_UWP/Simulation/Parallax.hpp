@@ -0,0 +1,159 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "SimTypes.hpp"
+
+// Scrolling of the parallax layers, without a device. Each layer is drawn
+// as one quad covering the screen whose texture coordinates run past the
+// texture's edge; a wrap sampler repeats the texture, so the seam that
+// ScrollingBackground hides by drawing the texture twice is never there.
+// Layers come from a table of speed and scale, so adding a depth layer
+// costs one quad and one screen of fill, which GetFillCost reports.
+//
+// A wrap sampler repeats the whole texture, so a layer cannot be a region
+// of an atlas; ScrollingBackground still draws those.
+//
+// Layers move in the fixed rate update like the rest of the game, and
+// GetQuad blends each between its last two offsets by the same alpha the
+// other sprites are drawn with, so fast layers do not judder on displays
+// faster than the update rate.
+
+namespace Simulation
+{
+	// Whether a layer is drawn behind the gameplay sprites or over them.
+	enum ParallaxPlane
+	{
+		ParallaxPlane_Back,
+		ParallaxPlane_Front
+	};
+
+	struct ParallaxLayerDesc
+	{
+		float			speed;		// screen pixels per second the layer moves left
+		float			scale;		// 1 stretches the texture over the screen, 0.5 repeats it twice each way
+		ParallaxPlane	plane;
+	};
+
+	// The quad that draws a layer. The source rectangle is in texels and
+	// may run past the texture, which the sampler wraps. It starts on a
+	// whole texel, so position moves it left by the part of a texel
+	// scrolled past to keep the scrolling smooth.
+	struct ParallaxQuad
+	{
+		Float2		position;		// top left, on or left of the screen's
+		int32_t		left;
+		int32_t		top;
+		int32_t		right;
+		int32_t		bottom;
+		Float2		scale;			// screen pixels per texel
+	};
+
+	// Estimated GPU cost of a layer per frame. Every layer is one alpha
+	// blended quad over the whole screen, so pixels is the screen area
+	// whatever its speed or scale. Above 1 texel per pixel the texture is
+	// minified, and without mipmaps each pixel reads more texture than it
+	// shows.
+	struct ParallaxFillCost
+	{
+		uint32_t	pixels;
+		float		texelsPerPixel;
+	};
+
+	class ParallaxLayers
+	{
+	public:
+		// Returns the index of the layer; layers are drawn in the order added.
+		size_t Add(const ParallaxLayerDesc& desc, uint32_t textureWidth, uint32_t textureHeight)
+		{
+			Layer layer;
+			layer.desc = desc;
+			layer.textureWidth = (float)textureWidth;
+			layer.textureHeight = (float)textureHeight;
+			layer.offset = 0.f;
+			layer.previousOffset = 0.f;
+			m_layers.push_back(layer);
+			return m_layers.size() - 1;
+		}
+
+		void Clear()										{ m_layers.clear(); }
+
+		void SetScreenSize(const Size& screenSize)			{ m_screenSize = screenSize; }
+
+		// Scroll offsets are kept in texels within the texture's width, so
+		// they lose no precision however long the game runs. The previous
+		// offset is moved by the same wrap, so it stays one update behind.
+		void Update(float elapsedSeconds)
+		{
+			if (m_screenSize.Width <= 0.f)
+				return;
+
+			for (auto& layer : m_layers)
+			{
+				float advanced = layer.offset + layer.desc.speed * elapsedSeconds / ScaleX(layer);
+				float offset = std::fmod(advanced, layer.textureWidth);
+				offset = offset < 0.f ? offset + layer.textureWidth : offset;
+				layer.previousOffset = layer.offset + (offset - advanced);
+				layer.offset = offset;
+			}
+		}
+
+		size_t GetCount() const								{ return m_layers.size(); }
+		const ParallaxLayerDesc& GetDesc(size_t layer) const	{ return m_layers[layer].desc; }
+
+		// alpha blends the layer between its previous and current update.
+		ParallaxQuad GetQuad(size_t index, float alpha = 1.f) const
+		{
+			const Layer& layer = m_layers[index];
+
+			float offset = Lerp(layer.previousOffset, layer.offset, alpha);
+			if (offset < 0.f)
+				offset += layer.textureWidth;
+			else if (offset >= layer.textureWidth)
+				offset -= layer.textureWidth;
+
+			float first = std::floor(offset);
+			float part = offset - first;
+
+			ParallaxQuad quad;
+			quad.scale = Float2(ScaleX(layer), ScaleY(layer));
+			quad.position = Float2(-part * quad.scale.x, 0.f);
+			quad.left = (int32_t)first;
+			quad.top = 0;
+			quad.right = quad.left + (int32_t)std::ceil(m_screenSize.Width / quad.scale.x + part);
+			quad.bottom = (int32_t)std::ceil(m_screenSize.Height / quad.scale.y);
+			return quad;
+		}
+
+		ParallaxFillCost GetFillCost(size_t index) const
+		{
+			const Layer& layer = m_layers[index];
+
+			ParallaxFillCost cost;
+			cost.pixels = (uint32_t)(m_screenSize.Width * m_screenSize.Height);
+			cost.texelsPerPixel = cost.pixels ? 1.f / (ScaleX(layer) * ScaleY(layer)) : 0.f;
+			return cost;
+		}
+
+	private:
+		struct Layer
+		{
+			ParallaxLayerDesc	desc;
+			float				textureWidth;
+			float				textureHeight;
+			float				offset;			// texels scrolled, in [0, textureWidth)
+			float				previousOffset;	// offset before the last update, unwrapped to offset's side
+		};
+
+		float ScaleX(const Layer& layer) const				{ return m_screenSize.Width * layer.desc.scale / layer.textureWidth; }
+		float ScaleY(const Layer& layer) const				{ return m_screenSize.Height * layer.desc.scale / layer.textureHeight; }
+
+		std::vector<Layer>	m_layers;
+		Size				m_screenSize;
+	};
+}
@@ -0,0 +1,228 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Scoped-zone frame profiler. PROFILE_ZONE("name") at the top of a block
+// records when the block was entered and left; zones nest, so a capture
+// shows where every part of a slow frame went without an external profiler.
+//
+// Each thread writes to its own ring buffer of the last ThreadCapacity
+// zones, so recording takes no lock and never allocates after the thread's
+// first zone. While the profiler is disabled a zone is one relaxed load.
+// WriteChromeTrace exports the rings in the Chrome trace event format,
+// which chrome://tracing and ui.perfetto.dev open.
+//
+// Zone names must be string literals (or otherwise outlive the capture).
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ::Simulation::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+namespace Simulation
+{
+	struct ProfileEvent
+	{
+		const char*		name;
+		uint64_t		start;		// nanoseconds since the profiler was created
+		uint64_t		end;
+	};
+
+	class Profiler
+	{
+	public:
+		// Zones kept per thread, about 9 seconds of a frame with 30 zones at 60 Hz.
+		static const uint32_t ThreadCapacity = 16384;
+
+		static Profiler& Get()
+		{
+			static Profiler profiler;
+			return profiler;
+		}
+
+		void SetEnabled(bool enabled)			{ m_enabled.store(enabled, std::memory_order_relaxed); }
+		bool IsEnabled() const					{ return m_enabled.load(std::memory_order_relaxed); }
+
+		uint64_t Now() const
+		{
+			return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+		}
+
+		// Names the calling thread in exported traces; name must be a literal.
+		void SetThreadName(const char* name)
+		{
+			GetThreadBuffer().name = name;
+		}
+
+		void Record(const char* name, uint64_t start, uint64_t end)
+		{
+			ThreadBuffer& buffer = GetThreadBuffer();
+			uint64_t index = buffer.written.load(std::memory_order_relaxed);
+			ProfileEvent& event = buffer.events[index % ThreadCapacity];
+			event.name = name;
+			event.start = start;
+			event.end = end;
+			buffer.written.store(index + 1, std::memory_order_release);
+		}
+
+		// Forgets everything recorded so far, e.g. when a new capture starts.
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lock(m_threadsMutex);
+			for (auto& buffer : m_threads)
+			{
+				buffer->cleared.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+			}
+		}
+
+		// Best read with the profiler disabled. Threads still recording may
+		// overwrite events during the copy; those are detected and dropped.
+		bool WriteChromeTrace(std::ostream& stream) const
+		{
+			stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+			std::lock_guard<std::mutex> lock(m_threadsMutex);
+			bool first = true;
+			std::vector<ProfileEvent> events;
+			for (auto& buffer : m_threads)
+			{
+				WriteSeparator(stream, first);
+				stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+					<< ",\"args\":{\"name\":\"";
+				if (buffer->name)
+					WriteEscaped(stream, buffer->name);
+				else
+					stream << "Thread " << buffer->id;
+				stream << "\"}}";
+
+				uint64_t end = buffer->written.load(std::memory_order_acquire);
+				uint64_t begin = (std::max)(buffer->cleared.load(std::memory_order_relaxed), end > ThreadCapacity ? end - ThreadCapacity : 0);
+				events.clear();
+				for (uint64_t i = begin; i < end; i++)
+				{
+					events.push_back(buffer->events[i % ThreadCapacity]);
+				}
+
+				// Slots the owner reused while they were copied, plus the one it
+				// may be writing now: event 'after' goes in before written moves on.
+				uint64_t after = buffer->written.load(std::memory_order_acquire);
+				uint64_t valid = after + 1 > ThreadCapacity ? after + 1 - ThreadCapacity : 0;
+				for (uint64_t i = (std::max)(begin, valid); i < end; i++)
+				{
+					const ProfileEvent& event = events[(size_t)(i - begin)];
+					WriteSeparator(stream, first);
+					stream << "{\"name\":\"";
+					WriteEscaped(stream, event.name);
+					stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id << ",\"ts\":";
+					WriteMicroseconds(stream, event.start);
+					stream << ",\"dur\":";
+					WriteMicroseconds(stream, event.end - event.start);
+					stream << "}";
+				}
+			}
+
+			stream << "\n]}\n";
+			return !stream.fail();
+		}
+
+	private:
+		struct ThreadBuffer
+		{
+			uint32_t					id;
+			const char*					name;
+			std::atomic<uint64_t>		written;
+			std::atomic<uint64_t>		cleared;
+			ProfileEvent				events[ThreadCapacity];
+		};
+
+		Profiler() : m_enabled(false), m_epoch(std::chrono::steady_clock::now()) {}
+
+		// The buffer of the calling thread, registered on first use. Buffers
+		// live as long as the profiler, so traces keep threads that exited.
+		ThreadBuffer& GetThreadBuffer()
+		{
+			static thread_local ThreadBuffer* current = nullptr;
+			if (!current)
+			{
+				std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer);
+				buffer->name = nullptr;
+				buffer->written.store(0);
+				buffer->cleared.store(0);
+
+				std::lock_guard<std::mutex> lock(m_threadsMutex);
+				buffer->id = (uint32_t)m_threads.size() + 1;
+				current = buffer.get();
+				m_threads.push_back(std::move(buffer));
+			}
+			return *current;
+		}
+
+		static void WriteSeparator(std::ostream& stream, bool& first)
+		{
+			if (!first)
+				stream << ",\n";
+			first = false;
+		}
+
+		static void WriteEscaped(std::ostream& stream, const char* text)
+		{
+			for (; *text; text++)
+			{
+				if (*text == '"' || *text == '\\')
+					stream << '\\';
+				stream << *text;
+			}
+		}
+
+		// Trace timestamps are microseconds; keep the nanoseconds as decimals.
+		static void WriteMicroseconds(std::ostream& stream, uint64_t nanoseconds)
+		{
+			char fraction[4] = { (char)('0' + nanoseconds / 100 % 10), (char)('0' + nanoseconds / 10 % 10), (char)('0' + nanoseconds % 10), 0 };
+			stream << nanoseconds / 1000 << '.' << fraction;
+		}
+
+		std::atomic<bool>								m_enabled;
+		std::chrono::steady_clock::time_point			m_epoch;
+		mutable std::mutex								m_threadsMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>>		m_threads;
+	};
+
+	// Records the enclosing scope as one zone if the profiler is enabled when it is entered.
+	class ProfileZone
+	{
+	public:
+		explicit ProfileZone(const char* name) : m_name(name), m_start(0), m_active(Profiler::Get().IsEnabled())
+		{
+			if (m_active)
+			{
+				m_start = Profiler::Get().Now();
+			}
+		}
+
+		~ProfileZone()
+		{
+			if (m_active)
+			{
+				Profiler& profiler = Profiler::Get();
+				profiler.Record(m_name, m_start, profiler.Now());
+			}
+		}
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+
+	private:
+		const char*		m_name;
+		uint64_t		m_start;
+		bool			m_active;
+	};
+}
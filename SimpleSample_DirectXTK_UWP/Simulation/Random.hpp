@@ -0,0 +1,180 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Seedable random numbers for the simulation. Pcg32 is a 16 byte PCG-XSH-RR
+// generator (O'Neill, pcg-random.org); RandomService derives independent
+// streams from one seed, one per game system and one per worker thread, so
+// a run is reproduced exactly by reusing its seed and adding a consumer
+// never shifts the numbers another system sees.
+
+namespace Simulation
+{
+	class Pcg32
+	{
+	public:
+		typedef uint32_t result_type;
+
+		Pcg32() : m_state(0), m_increment(1)
+		{
+			Seed(0x853c49e6748fea9bull, 0xda3e39cb94b95bdbull);
+		}
+
+		Pcg32(uint64_t seed, uint64_t stream) : m_state(0), m_increment(1)
+		{
+			Seed(seed, stream);
+		}
+
+		// Generators with different stream ids give unrelated sequences for the same seed.
+		void Seed(uint64_t seed, uint64_t stream)
+		{
+			m_state = 0;
+			m_increment = (stream << 1) | 1;
+			Next();
+			m_state += seed;
+			Next();
+		}
+
+		uint32_t Next()
+		{
+			uint64_t old = m_state;
+			m_state = old * 6364136223846793005ull + m_increment;
+
+			uint32_t xorShifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+			uint32_t rotation = (uint32_t)(old >> 59);
+			return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31));
+		}
+
+		// Uniform in [0, range) without modulo bias (Lemire's multiply-shift).
+		uint32_t NextBelow(uint32_t range)
+		{
+			uint64_t product = (uint64_t)Next() * range;
+			uint32_t low = (uint32_t)product;
+			if (low < range)
+			{
+				uint32_t threshold = (0u - range) % range;
+				while (low < threshold)
+				{
+					product = (uint64_t)Next() * range;
+					low = (uint32_t)product;
+				}
+			}
+			return (uint32_t)(product >> 32);
+		}
+
+		// Uniform in [min, max], both inclusive like std::uniform_int_distribution.
+		int NextInt(int min, int max)
+		{
+			uint32_t range = (uint32_t)max - (uint32_t)min + 1;
+			return range ? (int)((uint32_t)min + NextBelow(range)) : (int)Next();
+		}
+
+		// Uniform in [0, 1), 24 bits of precision.
+		float NextFloat()
+		{
+			return (float)(Next() >> 8) * (1.f / 16777216.f);
+		}
+
+		// Uniform in [min, max).
+		float NextFloat(float min, float max)
+		{
+			return min + (max - min) * NextFloat();
+		}
+
+		void FillInt(int* values, size_t count, int min, int max)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				values[i] = NextInt(min, max);
+			}
+		}
+
+		void FillFloat(float* values, size_t count, float min, float max)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				values[i] = NextFloat(min, max);
+			}
+		}
+
+		// Lets the generator be passed to <random> distributions and std::shuffle.
+		static constexpr uint32_t (min)()		{ return 0; }
+		static constexpr uint32_t (max)()		{ return 0xffffffffu; }
+		uint32_t operator()()				{ return Next(); }
+
+	private:
+		uint64_t								m_state;
+		uint64_t								m_increment;
+	};
+
+	// Fixed streams of the game systems. New systems go at the end.
+	enum RandomStream
+	{
+		RandomStream_Spawn,
+		RandomStream_Walls,
+		RandomStream_AI,
+		RandomStream_Count
+	};
+
+	class RandomService
+	{
+	public:
+		// Seed 0 picks a seed from std::random_device; GetSeed tells which one.
+		explicit RandomService(uint64_t seed = 0)
+		{
+			Reset(seed);
+		}
+
+		void Reset(uint64_t seed)
+		{
+			if (seed == 0)
+			{
+				std::random_device device;
+				seed = ((uint64_t)device() << 32) | device();
+			}
+			m_seed = seed;
+
+			for (int stream = 0; stream < RandomStream_Count; stream++)
+			{
+				m_streams[stream].Seed(m_seed, (uint64_t)stream);
+			}
+
+			for (size_t thread = 0; thread < m_threadStreams.size(); thread++)
+			{
+				m_threadStreams[thread].Seed(m_seed, ThreadStreamId(thread));
+			}
+		}
+
+		uint64_t GetSeed() const					{ return m_seed; }
+
+		Pcg32& Get(RandomStream stream)				{ return m_streams[stream]; }
+
+		// One generator per worker thread, for jobs that need random numbers
+		// without sharing state. Call before the workers start.
+		void SetThreadCount(size_t threadCount)
+		{
+			size_t first = m_threadStreams.size();
+			m_threadStreams.resize(threadCount);
+			for (size_t thread = first; thread < threadCount; thread++)
+			{
+				m_threadStreams[thread].Seed(m_seed, ThreadStreamId(thread));
+			}
+		}
+
+		Pcg32& GetThread(size_t thread)				{ return m_threadStreams[thread]; }
+
+	private:
+		// Thread streams are numbered after the system streams.
+		static uint64_t ThreadStreamId(size_t thread)	{ return (uint64_t)RandomStream_Count + thread; }
+
+		uint64_t								m_seed;
+		Pcg32									m_streams[RandomStream_Count];
+		std::vector<Pcg32>						m_threadStreams;
+	};
+}
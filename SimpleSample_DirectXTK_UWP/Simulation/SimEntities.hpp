@@ -0,0 +1,71 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include "SimTypes.hpp"
+
+// Gameplay state of the player, without any texture, animation or
+// Direct3D dependency; Content\Player.hpp only draws what it describes.
+// Enemies live in EnemyPool.hpp and the walls in Course.hpp.
+
+namespace Simulation
+{
+	class Player
+	{
+	public:
+		Player() : width(0), height(0)
+		{
+			position = Float2(300, 512);
+			previousPosition = position;
+			updateBoundingRect();
+		}
+
+		void setSize(int frameWidth, int frameHeight)
+		{
+			width = frameWidth;
+			height = frameHeight;
+			updateBoundingRect();
+		}
+
+		void setPosition(Float2 newPosition)
+		{
+			position = newPosition;
+			updateBoundingRect();
+		}
+
+		Float2 getPosition() const
+		{
+			return position;
+		}
+
+		void storePreviousState()
+		{
+			previousPosition = position;
+		}
+
+		// Position between the previous and the current tick, alpha in [0, 1].
+		Float2 getInterpolatedPosition(float alpha) const
+		{
+			return Float2(Lerp(previousPosition.x, position.x, alpha), Lerp(previousPosition.y, position.y, alpha));
+		}
+
+	public:
+		Rect												rectangle;
+
+	private:
+		void updateBoundingRect()
+		{
+			rectangle.X = position.x;
+			rectangle.Y = position.y;
+			rectangle.Height = (float)height;
+			rectangle.Width = (float)width;
+		}
+
+		Float2												position;
+		Float2												previousPosition;
+
+		int													width;
+		int													height;
+	};
+}
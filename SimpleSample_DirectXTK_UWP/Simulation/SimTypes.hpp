@@ -0,0 +1,65 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+// Plain value types used by the simulation core. They mirror the WinRT
+// Windows::Foundation::Rect/Size and DirectX::XMFLOAT2 layouts so the game
+// can convert between them field by field, but depend on nothing outside
+// the standard library.
+
+namespace Simulation
+{
+	// Blend between the previous and current simulation state for drawing.
+	inline float Lerp(float from, float to, float alpha)
+	{
+		return from + (to - from) * alpha;
+	}
+
+	struct Float2
+	{
+		float x;
+		float y;
+
+		Float2() : x(0.f), y(0.f) {}
+		Float2(float _x, float _y) : x(_x), y(_y) {}
+	};
+
+	struct Size
+	{
+		float Width;
+		float Height;
+
+		Size() : Width(0.f), Height(0.f) {}
+		Size(float width, float height) : Width(width), Height(height) {}
+	};
+
+	struct Rect
+	{
+		float X;
+		float Y;
+		float Width;
+		float Height;
+
+		Rect() : X(0.f), Y(0.f), Width(0.f), Height(0.f) {}
+		Rect(float x, float y, float width, float height) : X(x), Y(y), Width(width), Height(height) {}
+
+		float Left() const		{ return X; }
+		float Top() const		{ return Y; }
+		float Right() const		{ return X + Width; }
+		float Bottom() const	{ return Y + Height; }
+
+		bool IsEmpty() const	{ return Width <= 0.f || Height <= 0.f; }
+
+		// Same rules as Windows::Foundation::Rect::IntersectsWith: touching edges
+		// count as an intersection, empty rectangles never intersect.
+		bool IntersectsWith(const Rect& other) const
+		{
+			if (IsEmpty() || other.IsEmpty())
+				return false;
+
+			return other.Left() <= Right() && other.Right() >= Left() &&
+				other.Top() <= Bottom() && other.Bottom() >= Top();
+		}
+	};
+}
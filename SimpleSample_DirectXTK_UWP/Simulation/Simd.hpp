@@ -0,0 +1,19 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+// Instruction sets the simulation kernels may use. SSE2 is always there on
+// x86/x64; AVX2 only when the compiler targets it (/arch:AVX2, -mavx2).
+// Every kernel keeps a scalar path for ARM and other targets; defining
+// SIMULATION_NO_SIMD builds that path on x86 too, so it can be tested.
+
+#if defined(__AVX2__) && !defined(SIMULATION_NO_SIMD)
+#include <immintrin.h>
+#define SIMULATION_USE_AVX2 1
+#endif
+
+#if (defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)) && !defined(SIMULATION_NO_SIMD)
+#include <emmintrin.h>
+#define SIMULATION_USE_SSE2 1
+#endif
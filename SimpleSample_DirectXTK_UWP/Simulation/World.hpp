@@ -0,0 +1,331 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "SimTypes.hpp"
+#include "SimEntities.hpp"
+#include "Course.hpp"
+#include "EnemyPool.hpp"
+#include "FrameArena.hpp"
+#include "Broadphase.hpp"
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+#include "Random.hpp"
+
+// Platform independent game tick: enemy spawning, player movement, wall and
+// enemy movement, collisions and cleanup. The renderer feeds it input once
+// per update and draws whatever state it ends up in; the Linux tools drive
+// it directly without a device.
+//
+// All speeds are in pixels per second and scaled by the tick length, so the
+// game plays the same at any tick rate. Each tick keeps the state it started
+// from, which lets a fixed-rate simulation be drawn at display rate by
+// interpolating between the last two ticks.
+
+namespace Simulation
+{
+	struct WorldConfig
+	{
+		Size			screenSize;
+		int				playerWidth;
+		int				playerHeight;
+		int				enemyWidth;
+		int				enemyHeight;
+		int				wallWidth;
+		float			playerSpeed;	// pixels per second for a full input deflection
+		unsigned int	maxEnemies;		// enemies are spawned each tick while below this count
+		unsigned int	spawnPerTick;	// upper bound of enemies spawned in one tick
+		int				enemyMinSpeed;	// pixels per second, inclusive
+		int				enemyMaxSpeed;	// pixels per second, inclusive
+		float			enemySteer;		// pixels per second an enemy turns towards the player
+		uint64_t		seed;			// 0 picks a seed from std::random_device, see World::GetSeed
+		CourseConfig	course;			// how the walls are generated
+
+		// Defaults match the shipped assets: 46x27 frames scaled by 3 and a 100px wide pipe.
+		// Speeds are the old per-frame steps at 60 frames per second.
+		WorldConfig() :
+			screenSize(1920.f, 1080.f),
+			playerWidth(138),
+			playerHeight(81),
+			enemyWidth(138),
+			enemyHeight(81),
+			wallWidth(100),
+			playerSpeed(600.f),
+			maxEnemies(5),
+			spawnPerTick(1),
+			enemyMinSpeed(300),
+			enemyMaxSpeed(1500),
+			enemySteer(120.f),
+			seed(0)
+		{
+		}
+	};
+
+	// Digital actions held during a tick, as bits of PlayerInput::Actions.
+	enum InputAction : uint32_t
+	{
+		InputAction_Up		= 0x01,
+		InputAction_Down	= 0x02,
+		InputAction_Left	= 0x04,
+		InputAction_Right	= 0x08
+	};
+
+	// Input of one tick. Movement is per axis in the range of device deflection;
+	// digital inputs contribute -1, 0 or 1 and several devices simply add up.
+	// Actions records which digital controls were held.
+	struct PlayerInput
+	{
+		uint32_t	Actions;
+		float		MoveX;
+		float		MoveY;
+
+		PlayerInput() : Actions(0), MoveX(0.f), MoveY(0.f) {}
+	};
+
+	// Events of one tick that the presentation layer reacts to.
+	struct TickResult
+	{
+		bool			playerHitWall;
+		unsigned int	enemiesSpawned;
+		unsigned int	enemiesHitWall;
+		unsigned int	enemiesDestroyed;
+
+		TickResult() : playerHitWall(false), enemiesSpawned(0), enemiesHitWall(0), enemiesDestroyed(0) {}
+	};
+
+	class World
+	{
+	public:
+		explicit World(const WorldConfig& config) :
+			m_config(config),
+			m_random(config.seed),
+			m_jobs(nullptr),
+			m_enemyClip(0)
+		{
+			m_player.setSize(config.playerWidth, config.playerHeight);
+			m_enemies.SetSize((float)config.enemyWidth, (float)config.enemyHeight);
+			m_course.Reset(config.course, config.screenSize, (float)config.wallWidth, m_random.Get(RandomStream_Walls));
+
+			// Room for a full pool and the most the collision pass can produce,
+			// so the first crowded tick does not grow them in the middle of play.
+			m_enemies.Reserve(config.maxEnemies);
+			size_t walls = 2 * m_course.GetCapacity();
+			size_t proxies = 1 + walls + config.maxEnemies;
+			m_broadphase.Reserve(proxies);
+			m_broadphase.ReserveLayer(BroadphaseLayer_Player, 1);
+			m_broadphase.ReserveLayer(BroadphaseLayer_Wall, walls);
+			m_broadphase.ReserveLayer(BroadphaseLayer_Enemy, config.maxEnemies);
+			m_queryResults.reserve(proxies);
+			// An enemy touches both rects of every wall its width reaches.
+			size_t wallsPerEnemy = (size_t)std::ceil((config.enemyWidth + config.wallWidth) / m_course.GetSpacing()) + 1;
+			m_pairs.reserve(2 * (std::min)(wallsPerEnemy, m_course.GetCapacity()) * config.maxEnemies);
+		}
+
+		TickResult Tick(float elapsedSeconds, const PlayerInput& input)
+		{
+			PROFILE_ZONE("World::Tick");
+			TickResult result;
+
+			m_tickArena.Reset();
+			m_player.storePreviousState();
+			m_enemies.StorePreviousState();
+
+#pragma region Handling Adding Enemies
+			if (m_enemies.Size() < m_config.maxEnemies)
+			{
+				PROFILE_ZONE("Adding enemies");
+				size_t toSpawn = (std::min<size_t>)(m_config.maxEnemies - m_enemies.Size(), m_config.spawnPerTick);
+
+				// Draw the whole batch up front: heights first, then speeds (inclusive,inclusive).
+				Pcg32& random = m_random.Get(RandomStream_Spawn);
+				int* spawnValues = m_tickArena.Allocate<int>(toSpawn * 2);
+				random.FillInt(spawnValues, toSpawn, 0, (int)m_config.screenSize.Height);
+				random.FillInt(spawnValues + toSpawn, toSpawn, m_config.enemyMinSpeed, m_config.enemyMaxSpeed);
+
+				for (size_t i = 0; i < toSpawn; i++)
+				{
+					// Enemies play their sprite's clip from the moment they appear.
+					m_enemies.Spawn(m_config.screenSize.Width, (float)spawnValues[i], (float)spawnValues[toSpawn + i],
+						AnimationPlayback(m_enemyClip, (float)m_time));
+				}
+				result.enemiesSpawned = (unsigned int)toSpawn;
+			}
+#pragma endregion
+
+#pragma region Player movement
+			{
+				PROFILE_ZONE("Player movement");
+				Float2 playerPos = m_player.getPosition();
+				playerPos.x += input.MoveX * m_config.playerSpeed * elapsedSeconds;
+				playerPos.y += input.MoveY * m_config.playerSpeed * elapsedSeconds;
+				m_player.setPosition(playerPos);
+			}
+#pragma endregion
+
+#pragma region Updating Enemies without AI
+			{
+				PROFILE_ZONE("Enemy move");
+				m_enemies.Integrate(elapsedSeconds);
+			}
+#pragma endregion
+
+#pragma region Updating Enemies with AI
+			{
+				PROFILE_ZONE("Enemy AI");
+
+				// Aim the enemy's centre at the player's centre.
+				Rect playerRect = m_player.rectangle;
+				float targetY = playerRect.Y + (playerRect.Height - m_enemies.GetHeight()) / 2;
+				float maxY = m_config.screenSize.Height - m_enemies.GetHeight();
+				float step = m_config.enemySteer * elapsedSeconds;
+				EnemyPool& enemies = m_enemies;
+
+				auto steer = [&](size_t begin, size_t end)
+				{
+					enemies.Steer(begin, end, playerRect.X, targetY, step, maxY);
+				};
+
+				if (m_jobs)
+				{
+					m_jobs->ParallelFor(m_enemies.Size(), AiGrainSize, steer);
+				}
+				else
+				{
+					steer(0, m_enemies.Size());
+				}
+			}
+#pragma endregion
+
+#pragma region Collisions
+			{
+				PROFILE_ZONE("Collisions");
+				m_course.Update(elapsedSeconds, m_random.Get(RandomStream_Walls));
+
+				BuildBroadphase();
+
+				// Collisions of Player with walls and enemies
+				uint8_t* enemyVisible = m_enemies.Visible();
+
+				m_queryResults.clear();
+				m_broadphase.Query(m_player.rectangle, BroadphaseLayer_Wall | BroadphaseLayer_Enemy, m_queryResults);
+				for (uint32_t proxy : m_queryResults)
+				{
+					if (m_broadphase.GetLayer(proxy) == BroadphaseLayer_Wall)
+					{
+						result.playerHitWall = true;
+					}
+					else
+					{
+						enemyVisible[m_broadphase.GetUserId(proxy)] = 0;
+					}
+				}
+
+				//Collisions of Enemies with Walls
+				m_pairs.clear();
+				m_broadphase.FindPairs(BroadphaseLayer_Enemy, BroadphaseLayer_Wall, m_pairs);
+				for (const auto& pair : m_pairs)
+				{
+					uint32_t enemy = m_broadphase.GetUserId(pair.a);
+					if (enemyVisible[enemy])
+					{
+						enemyVisible[enemy] = 0;
+						result.enemiesHitWall++;
+					}
+				}
+			}
+#pragma endregion
+
+#pragma region Final update for enemies
+			{
+				PROFILE_ZONE("Final update");
+				result.enemiesDestroyed = (unsigned int)m_enemies.RemoveInvisible();
+			}
+#pragma endregion
+
+			m_tickCount++;
+			m_time += elapsedSeconds;
+			return result;
+		}
+
+		void SetScreenSize(Size screenSize)
+		{
+			m_config.screenSize = screenSize;
+			m_course.SetScreenSize(screenSize);
+		}
+
+		// Thread pool for the per-enemy passes; not owned, null runs them on the calling thread.
+		void SetJobSystem(JobSystem* jobs)		{ m_jobs = jobs; }
+
+		// Clip new enemies play, an id in the renderer's AnimationClips; 0 by default.
+		// Only drawing depends on it, so it is not part of the config.
+		void SetEnemyClip(uint32_t clip)			{ m_enemyClip = clip; }
+
+		const WorldConfig& GetConfig() const		{ return m_config; }
+		const Player& GetPlayer() const				{ return m_player; }
+		const Course& GetCourse() const				{ return m_course; }
+		const EnemyPool& GetEnemies() const			{ return m_enemies; }
+
+		// Spatial index of the last tick. Proxy user ids are the player (0),
+		// the wall's index in the course or the enemy's dense index,
+		// depending on the layer.
+		const Broadphase& GetBroadphase() const		{ return m_broadphase; }
+
+		// Number of simulated objects touched by one tick.
+		size_t GetEntityCount() const				{ return 1 + m_course.Size() + m_enemies.Size(); }
+		unsigned long long GetTickCount() const		{ return m_tickCount; }
+
+		// Seconds simulated so far; the clock enemy animations are started on.
+		double GetTime() const						{ return m_time; }
+
+		// Seed actually in use; replaying it reproduces the run.
+		uint64_t GetSeed() const					{ return m_random.GetSeed(); }
+
+	private:
+		void BuildBroadphase()
+		{
+			m_broadphase.Clear();
+			m_broadphase.Add(m_player.rectangle, BroadphaseLayer_Player, 0);
+
+			// Walls ahead of the screen cannot be hit yet.
+			size_t walls = m_course.GetVisibleCount();
+			for (size_t i = 0; i < walls; i++)
+			{
+				m_broadphase.Add(m_course.GetUpperRect(i), BroadphaseLayer_Wall, (uint32_t)i);
+				m_broadphase.Add(m_course.GetLowerRect(i), BroadphaseLayer_Wall, (uint32_t)i);
+			}
+
+			for (size_t i = 0; i < m_enemies.Size(); i++)
+			{
+				m_broadphase.Add(m_enemies.GetRect(i), BroadphaseLayer_Enemy, (uint32_t)i);
+			}
+
+			m_broadphase.Build();
+		}
+
+		// Enemies per AI job; below this the pass is not worth splitting.
+		static const size_t AiGrainSize = 4096;
+
+		WorldConfig									m_config;
+		RandomService								m_random;
+		unsigned long long							m_tickCount = 0;
+		double										m_time = 0.0;
+
+		Player										m_player;
+		Course										m_course;
+		EnemyPool									m_enemies;
+
+		Broadphase									m_broadphase;
+		std::vector<uint32_t>						m_queryResults;
+		std::vector<BroadphasePair>					m_pairs;
+		FrameArena									m_tickArena;			// Scratch memory of one tick.
+
+		JobSystem*									m_jobs;
+		uint32_t									m_enemyClip;
+	};
+}
@@ -0,0 +1,131 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// One box against N and N boxes against M: the Rect::IntersectsWith loop
+// the game used against the packed kernel in Aabb.hpp, with bitmask and
+// index list output. Configure with -DTOOLS_NATIVE_ARCH=ON to measure the
+// AVX2 path instead of SSE2.
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Simulation/Aabb.hpp"
+
+namespace
+{
+	// Enemy sized boxes scattered over one 1920x1080 screen.
+	std::vector<Simulation::Rect> MakeRects(size_t count, unsigned int seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> distX(0.f, 1920.f);
+		std::uniform_real_distribution<float> distY(0.f, 1080.f);
+
+		std::vector<Simulation::Rect> rects;
+		for (size_t i = 0; i < count; i++)
+		{
+			rects.push_back(Simulation::Rect(distX(random), distY(random), 138.f, 81.f));
+		}
+		return rects;
+	}
+
+	Simulation::AabbArray Pack(const std::vector<Simulation::Rect>& rects)
+	{
+		Simulation::AabbArray boxes;
+		for (auto& rect : rects)
+		{
+			boxes.Add(Simulation::Aabb::FromRect(rect));
+		}
+		return boxes;
+	}
+
+	const Simulation::Rect Player(300.f, 512.f, 138.f, 81.f);
+
+	void BM_RectOneToMany(benchmark::State& state)
+	{
+		auto rects = MakeRects((size_t)state.range(0), 1);
+
+		for (auto _ : state)
+		{
+			size_t hits = 0;
+			for (auto& rect : rects)
+				hits += rect.IntersectsWith(Player) ? 1 : 0;
+			benchmark::DoNotOptimize(hits);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void BM_AabbOneToManyMask(benchmark::State& state)
+	{
+		auto boxes = Pack(MakeRects((size_t)state.range(0), 1));
+		std::vector<uint32_t> mask((boxes.Size() + 31) / 32);
+
+		for (auto _ : state)
+		{
+			size_t hits = Simulation::AabbOverlapMask(Simulation::Aabb::FromRect(Player), boxes, 0, boxes.Size(), mask.data());
+			benchmark::DoNotOptimize(hits);
+			benchmark::DoNotOptimize(mask.data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void BM_AabbOneToManyIndices(benchmark::State& state)
+	{
+		auto boxes = Pack(MakeRects((size_t)state.range(0), 1));
+		std::vector<uint32_t> hits;
+
+		for (auto _ : state)
+		{
+			hits.clear();
+			Simulation::AabbOverlapIndices(Simulation::Aabb::FromRect(Player), boxes, 0, boxes.Size(), hits);
+			benchmark::DoNotOptimize(hits.data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// 64 wall rectangles against N enemies.
+	void BM_RectManyToMany(benchmark::State& state)
+	{
+		auto walls = MakeRects(64, 2);
+		auto enemies = MakeRects((size_t)state.range(0), 1);
+
+		for (auto _ : state)
+		{
+			size_t hits = 0;
+			for (auto& wall : walls)
+				for (auto& enemy : enemies)
+					hits += enemy.IntersectsWith(wall) ? 1 : 0;
+			benchmark::DoNotOptimize(hits);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0) * 64);
+	}
+
+	void BM_AabbManyToMany(benchmark::State& state)
+	{
+		auto walls = Pack(MakeRects(64, 2));
+		auto enemies = Pack(MakeRects((size_t)state.range(0), 1));
+		std::vector<Simulation::AabbPair> pairs;
+
+		for (auto _ : state)
+		{
+			pairs.clear();
+			Simulation::AabbOverlapPairs(walls, enemies, pairs);
+			benchmark::DoNotOptimize(pairs.data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0) * 64);
+	}
+}
+
+BENCHMARK(BM_RectOneToMany)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK(BM_AabbOneToManyMask)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK(BM_AabbOneToManyIndices)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK(BM_RectManyToMany)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK(BM_AabbManyToMany)->RangeMultiplier(8)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,99 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Checks the packed kernels of Aabb.hpp against Rect::IntersectsWith.
+// AabbOverlapMask runs on ranges of 1 to 72 boxes, including 32 and 36
+// and ranges ending on a word boundary, at several start offsets, into a
+// mask of exactly the documented (last - first + 31) / 32 words, allocated
+// on its own so an address sanitizer build (-fsanitize=address) stops at
+// any access past it. Bits past the range in the last word must be clear.
+//
+// Usage: AabbCheck
+// Prints each failure and returns 1 if there was any.
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Simulation/Aabb.hpp"
+
+namespace
+{
+	int CheckMask(const Simulation::AabbArray& boxes, const std::vector<Simulation::Rect>& rects,
+		const Simulation::Rect& query, size_t first, size_t last)
+	{
+		size_t words = (last - first + 31) / 32;
+		std::unique_ptr<uint32_t[]> mask(new uint32_t[words]);
+		size_t hits = Simulation::AabbOverlapMask(Simulation::Aabb::FromRect(query), boxes, first, last, mask.get());
+
+		int failures = 0;
+		size_t tail = (last - first) & 31;
+		if (tail && (mask[words - 1] >> tail) != 0)
+		{
+			std::printf("AabbOverlapMask [%zu, %zu): bits set past the range\n", first, last);
+			failures++;
+		}
+
+		size_t expectedHits = 0;
+		for (size_t i = first; i < last; i++)
+		{
+			bool expected = rects[i].IntersectsWith(query);
+			bool actual = ((mask[(i - first) >> 5] >> ((i - first) & 31)) & 1) != 0;
+			expectedHits += expected ? 1 : 0;
+			if (expected != actual)
+			{
+				std::printf("AabbOverlapMask [%zu, %zu): box %zu is %s, expected %s\n", first, last, i,
+					actual ? "set" : "clear", expected ? "set" : "clear");
+				failures++;
+			}
+		}
+
+		if (hits != expectedHits)
+		{
+			std::printf("AabbOverlapMask [%zu, %zu): %zu hits, expected %zu\n", first, last, hits, expectedHits);
+			failures++;
+		}
+		return failures;
+	}
+}
+
+int main()
+{
+	// One query covering everything, so every lane of every block hits,
+	// and one that hits about half the boxes.
+	const Simulation::Rect everything(-1000.f, -1000.f, 4000.f, 4000.f);
+	const Simulation::Rect half(0.f, 0.f, 960.f, 1080.f);
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> distX(0.f, 1920.f);
+	std::uniform_real_distribution<float> distY(0.f, 1080.f);
+
+	std::vector<Simulation::Rect> rects;
+	Simulation::AabbArray boxes;
+	for (int i = 0; i < 80; i++)
+	{
+		rects.push_back(Simulation::Rect(distX(random), distY(random), 40.f, 40.f));
+		boxes.Add(Simulation::Aabb::FromRect(rects.back()));
+	}
+
+	int failures = 0;
+	for (size_t first = 0; first < 8; first++)
+	{
+		for (size_t count = 1; first + count <= boxes.Size() && count <= 72; count++)
+		{
+			failures += CheckMask(boxes, rects, everything, first, first + count);
+			failures += CheckMask(boxes, rects, half, first, first + count);
+		}
+	}
+
+	if (failures)
+	{
+		std::printf("%d failures\n", failures);
+		return 1;
+	}
+
+	std::printf("AabbOverlapMask matches Rect::IntersectsWith for ranges of 1 to 72 boxes\n");
+	return 0;
+}
@@ -0,0 +1,132 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Compares animating sprites with one AnimatedTexture style object each,
+// which carries its own copy of the clip and advances a frame counter every
+// tick, with Simulation::EvaluateAnimationFrames, which computes the frame
+// of every 12 byte playback record from the time in one pass over a shared
+// clip table.
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Simulation/Animation.hpp"
+
+namespace
+{
+	const float TickSeconds = 1.f / 60.f;
+
+	// Stand-in for Content\AnimatedTexture.h without the device: the same
+	// per-instance state, held by pointer the way the game objects held it.
+	class LegacyAnimation
+	{
+	public:
+		LegacyAnimation(int frameCount, int framesPerSecond, float startOffset) :
+			mPaused(false), mFrame(0), mFrameCount(frameCount), mTextureWidth(46 * frameCount), mTextureHeight(27),
+			mTimePerFrame(1.f / float(framesPerSecond)), mTotalElapsed(startOffset), mDepth(0.5f), mRotation(0.f),
+			mScaleX(3.f), mScaleY(3.f)
+		{
+		}
+
+		void Update(float elapsed)
+		{
+			if (mPaused)
+				return;
+
+			mTotalElapsed += elapsed;
+			if (mTotalElapsed >= mTimePerFrame)
+			{
+				int frames = int(mTotalElapsed / mTimePerFrame);
+				mFrame = (mFrame + frames) % mFrameCount;
+				mTotalElapsed -= float(frames) * mTimePerFrame;
+			}
+		}
+
+		int GetFrame() const { return mFrame; }
+
+	private:
+		bool		mPaused;
+		int			mFrame;
+		int			mFrameCount;
+		int			mTextureWidth;
+		int			mTextureHeight;
+		float		mTimePerFrame;
+		float		mTotalElapsed;
+		float		mDepth;
+		float		mRotation;
+		float		mScaleX;
+		float		mScaleY;
+	};
+
+	void BM_PerInstanceUpdate(benchmark::State& state)
+	{
+		size_t count = (size_t)state.range(0);
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> distOffset(0.f, 0.25f);
+
+		std::vector<std::unique_ptr<LegacyAnimation>> animations;
+		for (size_t i = 0; i < count; i++)
+		{
+			animations.emplace_back(new LegacyAnimation(4, 4, distOffset(random)));
+		}
+		std::vector<uint32_t> frames(count);
+
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				animations[i]->Update(TickSeconds);
+				frames[i] = (uint32_t)animations[i]->GetFrame();
+			}
+			benchmark::DoNotOptimize(frames.data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * (int64_t)count);
+	}
+
+	void BM_EvaluateFrames(benchmark::State& state)
+	{
+		size_t count = (size_t)state.range(0);
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> distStart(-10.f, 0.f);
+		std::uniform_real_distribution<float> distSpeed(0.5f, 2.f);
+
+		// A few clips, as a game with several kinds of animated sprite would
+		// have, over consecutive frames of one sheet.
+		uint32_t sheetFrames[27];
+		for (uint32_t i = 0; i < 27; i++)
+		{
+			sheetFrames[i] = i;
+		}
+		Simulation::AnimationClips clips;
+		clips.Add("fly", sheetFrames, 4, 4.f);
+		clips.Add("turn", sheetFrames + 4, 8, 12.f);
+		clips.Add("explode", sheetFrames + 12, 15, 15.f, false);
+
+		std::vector<Simulation::AnimationPlayback> playbacks;
+		for (size_t i = 0; i < count; i++)
+		{
+			playbacks.push_back(Simulation::AnimationPlayback((uint32_t)(i % clips.Size()), distStart(random), distSpeed(random)));
+		}
+		std::vector<uint32_t> frames(count);
+
+		double time = 0.0;
+		for (auto _ : state)
+		{
+			time += TickSeconds;
+			Simulation::EvaluateAnimationFrames(clips, playbacks.data(), count, time, frames.data());
+			benchmark::DoNotOptimize(frames.data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * (int64_t)count);
+	}
+}
+
+BENCHMARK(BM_PerInstanceUpdate)->RangeMultiplier(10)->Range(500, 50000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EvaluateFrames)->RangeMultiplier(10)->Range(500, 50000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
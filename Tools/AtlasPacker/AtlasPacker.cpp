@@ -0,0 +1,391 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Build step that packs several uncompressed DDS sprites into one atlas
+// texture, so everything drawn from it shares a single texture bind and
+// SpriteBatch can submit it in one draw call. Next to <out>.dds it writes
+// <out>.txt in the TexturePacker 'MonoGame' format SpriteSheet::Load reads,
+// one entry per input holding its rectangle in the atlas.
+//
+// Usage: AtlasPacker <out> [name=]file.dds[:frames]... [--padding px] [--max-size px]
+//
+// Inputs keep their full size (animation strips stay strips) and must all
+// have the same 32 bit pixel format. Every sprite is surrounded by padding
+// filled with copies of its edge pixels, so linear filtering and stretched
+// draws never pick up a neighbour. An input with :frames is a strip of that
+// many frames side by side; it also gets an entry per frame, named with a
+// 4 digit frame number from 0001, which SpriteSheet::BuildClips makes into
+// a clip of the input's name.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+	void PrintUsage(const char* exe)
+	{
+		std::printf("Usage: %s <out> [name=]file.dds[:frames]... [--padding px] [--max-size px]\n", exe);
+	}
+
+	uint32_t Read32(const uint8_t* bytes)
+	{
+		return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+	}
+
+	void Write32(uint8_t* bytes, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+			bytes[i] = (uint8_t)(value >> (i * 8));
+	}
+
+	// Layout of the parts of a DDS file we touch (see DDS_HEADER in DDS.h).
+	const size_t MagicSize = 4;
+	const size_t HeaderSize = 124;
+	const size_t Dx10HeaderSize = 20;
+	const size_t PixelFormatOffset = MagicSize + 72;
+
+	const uint32_t DDSD_CAPS = 0x1;
+	const uint32_t DDSD_HEIGHT = 0x2;
+	const uint32_t DDSD_WIDTH = 0x4;
+	const uint32_t DDSD_PITCH = 0x8;
+	const uint32_t DDSD_PIXELFORMAT = 0x1000;
+	const uint32_t DDSCAPS_TEXTURE = 0x1000;
+	const uint32_t DDPF_FOURCC = 0x4;
+	const uint32_t DDPF_RGB = 0x40;
+	const uint32_t FourCCDx10 = 0x30315844; // "DX10"
+
+	// 32 bit DXGI formats of a DX10 header: R8G8B8A8 and B8G8R8A8, UNORM and UNORM_SRGB.
+	bool IsSupportedDxgiFormat(uint32_t format)
+	{
+		return format == 28 || format == 29 || format == 87 || format == 91;
+	}
+
+	struct Image
+	{
+		std::string				name;
+		std::string				path;
+		uint32_t				width;
+		uint32_t				height;
+		uint32_t				frames;		// 1, or the frames of an animation strip
+		std::vector<uint32_t>	pixels;
+
+		// Placement in the atlas, without the padding.
+		uint32_t				x;
+		uint32_t				y;
+	};
+
+	// Pixel format part of the header, copied verbatim into the atlas.
+	struct Format
+	{
+		uint8_t					pixelFormat[32];
+		uint8_t					dx10[Dx10HeaderSize];
+		bool					isDx10;
+
+		bool operator==(const Format& other) const
+		{
+			return isDx10 == other.isDx10 &&
+				std::memcmp(pixelFormat, other.pixelFormat, sizeof(pixelFormat)) == 0 &&
+				(!isDx10 || Read32(dx10) == Read32(other.dx10));
+		}
+	};
+
+	bool LoadDds(Image& image, Format& format)
+	{
+		std::ifstream file(image.path, std::ios::binary);
+		std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		if (bytes.size() < MagicSize + HeaderSize || std::memcmp(bytes.data(), "DDS ", 4) != 0 || Read32(&bytes[MagicSize]) != HeaderSize)
+		{
+			std::printf("%s: not a DDS file\n", image.path.c_str());
+			return false;
+		}
+
+		image.height = Read32(&bytes[MagicSize + 8]);
+		image.width = Read32(&bytes[MagicSize + 12]);
+		std::memcpy(format.pixelFormat, &bytes[PixelFormatOffset], sizeof(format.pixelFormat));
+		std::memset(format.dx10, 0, sizeof(format.dx10));
+
+		uint32_t flags = Read32(format.pixelFormat + 4);
+		uint32_t fourCC = Read32(format.pixelFormat + 8);
+		uint32_t bitCount = Read32(format.pixelFormat + 12);
+		size_t offset = MagicSize + HeaderSize;
+
+		format.isDx10 = (flags & DDPF_FOURCC) && fourCC == FourCCDx10;
+		if (format.isDx10)
+		{
+			if (bytes.size() < offset + Dx10HeaderSize || !IsSupportedDxgiFormat(Read32(&bytes[offset])))
+			{
+				std::printf("%s: only 32 bit RGBA/BGRA DDS files can be packed\n", image.path.c_str());
+				return false;
+			}
+			std::memcpy(format.dx10, &bytes[offset], Dx10HeaderSize);
+			offset += Dx10HeaderSize;
+		}
+		else if (!(flags & DDPF_RGB) || bitCount != 32)
+		{
+			std::printf("%s: only uncompressed 32 bit DDS files can be packed\n", image.path.c_str());
+			return false;
+		}
+
+		// Only the top mip level is used; the atlas has no mips.
+		size_t count = (size_t)image.width * image.height;
+		if (count == 0 || bytes.size() - offset < count * 4)
+		{
+			std::printf("%s: truncated pixel data\n", image.path.c_str());
+			return false;
+		}
+
+		image.pixels.resize(count);
+		std::memcpy(image.pixels.data(), &bytes[offset], count * 4);
+		return true;
+	}
+
+	bool WriteDds(const std::string& path, const Format& format, uint32_t width, uint32_t height, const std::vector<uint32_t>& pixels)
+	{
+		std::vector<uint8_t> bytes(MagicSize + HeaderSize + (format.isDx10 ? Dx10HeaderSize : 0), 0);
+		std::memcpy(bytes.data(), "DDS ", 4);
+		Write32(&bytes[MagicSize], (uint32_t)HeaderSize);
+		Write32(&bytes[MagicSize + 4], DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PITCH | DDSD_PIXELFORMAT);
+		Write32(&bytes[MagicSize + 8], height);
+		Write32(&bytes[MagicSize + 12], width);
+		Write32(&bytes[MagicSize + 16], width * 4);
+		Write32(&bytes[MagicSize + 24], 1);
+		std::memcpy(&bytes[PixelFormatOffset], format.pixelFormat, sizeof(format.pixelFormat));
+		Write32(&bytes[PixelFormatOffset + 32], DDSCAPS_TEXTURE);
+		if (format.isDx10)
+		{
+			std::memcpy(&bytes[MagicSize + HeaderSize], format.dx10, Dx10HeaderSize);
+		}
+
+		std::ofstream file(path, std::ios::binary);
+		file.write((const char*)bytes.data(), bytes.size());
+		file.write((const char*)pixels.data(), pixels.size() * 4);
+		return !file.fail();
+	}
+
+	// Shelf packing: tallest sprites first, left to right, a new shelf when a row is full.
+	bool Pack(std::vector<Image*>& order, uint32_t width, uint32_t height, uint32_t padding)
+	{
+		uint32_t x = 0;
+		uint32_t y = 0;
+		uint32_t shelfHeight = 0;
+
+		for (Image* image : order)
+		{
+			uint32_t w = image->width + 2 * padding;
+			uint32_t h = image->height + 2 * padding;
+			if (w > width)
+				return false;
+
+			if (x + w > width)
+			{
+				x = 0;
+				y += shelfHeight;
+				shelfHeight = 0;
+			}
+			if (y + h > height)
+				return false;
+
+			image->x = x + padding;
+			image->y = y + padding;
+			x += w;
+			shelfHeight = (std::max)(shelfHeight, h);
+		}
+		return true;
+	}
+
+	// Copies the sprite and extrudes its border into the padding around it.
+	void Blit(const Image& image, uint32_t padding, std::vector<uint32_t>& atlas, uint32_t atlasWidth)
+	{
+		int w = (int)image.width;
+		int h = (int)image.height;
+		int p = (int)padding;
+
+		for (int y = -p; y < h + p; y++)
+		{
+			int sourceY = (std::min)((std::max)(y, 0), h - 1);
+			uint32_t* row = &atlas[(size_t)(image.y + y) * atlasWidth + image.x];
+			for (int x = -p; x < w + p; x++)
+			{
+				int sourceX = (std::min)((std::max)(x, 0), w - 1);
+				row[x] = image.pixels[(size_t)sourceY * image.width + sourceX];
+			}
+		}
+	}
+
+	std::string FileStem(const std::string& path)
+	{
+		size_t slash = path.find_last_of("/\\");
+		std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+		return name.substr(0, name.find('.'));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3 || !std::strncmp(argv[1], "--", 2))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	std::string outPath = argv[1];
+	uint32_t padding = 2;
+	uint32_t maxSize = 2048;
+	std::vector<Image> images;
+
+	for (int i = 2; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		if (!std::strncmp(arg, "--", 2))
+		{
+			const char* value = (i + 1 < argc) ? argv[++i] : nullptr;
+			if (value && !std::strcmp(arg, "--padding"))			padding = (uint32_t)std::strtoul(value, nullptr, 10);
+			else if (value && !std::strcmp(arg, "--max-size"))		maxSize = (uint32_t)std::strtoul(value, nullptr, 10);
+			else
+			{
+				PrintUsage(argv[0]);
+				return 1;
+			}
+			continue;
+		}
+
+		Image image;
+		const char* equals = std::strchr(arg, '=');
+		image.path = equals ? equals + 1 : arg;
+		image.frames = 1;
+
+		size_t colon = image.path.find_last_of(':');
+		if (colon != std::string::npos && colon + 1 < image.path.size() && image.path.find_first_not_of("0123456789", colon + 1) == std::string::npos)
+		{
+			image.frames = (uint32_t)std::strtoul(image.path.c_str() + colon + 1, nullptr, 10);
+			image.path.erase(colon);
+			if (image.frames == 0 || image.frames > 9999)
+			{
+				std::printf("%s: invalid frame count\n", arg);
+				return 1;
+			}
+		}
+		image.name = equals ? std::string(arg, equals) : FileStem(image.path);
+
+		// SpriteSheet::Load splits lines on ';' and reads whitespace separated words.
+		if (image.name.empty() || image.name.find_first_of("; \t#") != std::string::npos)
+		{
+			std::printf("invalid sprite name '%s'\n", image.name.c_str());
+			return 1;
+		}
+		images.push_back(image);
+	}
+
+	if (images.empty())
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	Format format;
+	uint64_t spriteArea = 0;
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		Format imageFormat;
+		if (!LoadDds(images[i], imageFormat))
+			return 1;
+
+		if (i == 0)
+		{
+			format = imageFormat;
+		}
+		else if (!(imageFormat == format))
+		{
+			std::printf("%s: pixel format differs from %s\n", images[i].path.c_str(), images[0].path.c_str());
+			return 1;
+		}
+
+		if (images[i].width % images[i].frames != 0)
+		{
+			std::printf("%s: %u pixels wide, not a strip of %u frames\n", images[i].path.c_str(), images[i].width, images[i].frames);
+			return 1;
+		}
+
+		for (size_t j = 0; j < i; j++)
+		{
+			if (images[j].name == images[i].name)
+			{
+				std::printf("duplicate sprite name '%s'\n", images[i].name.c_str());
+				return 1;
+			}
+		}
+		spriteArea += (uint64_t)images[i].width * images[i].height;
+	}
+
+	std::vector<Image*> order;
+	for (Image& image : images)
+	{
+		order.push_back(&image);
+	}
+	std::stable_sort(order.begin(), order.end(), [](const Image* a, const Image* b)
+	{
+		return a->height != b->height ? a->height > b->height : a->width > b->width;
+	});
+
+	// Smallest power of two atlas that fits, growing the shorter side first.
+	uint32_t width = 1;
+	uint32_t height = 1;
+	while (!Pack(order, width, height, padding))
+	{
+		if (width > height)
+			height *= 2;
+		else
+			width *= 2;
+
+		if (width > maxSize || height > maxSize)
+		{
+			std::printf("sprites do not fit in a %ux%u atlas\n", maxSize, maxSize);
+			return 1;
+		}
+	}
+
+	std::vector<uint32_t> atlas((size_t)width * height, 0);
+	for (const Image& image : images)
+	{
+		Blit(image, padding, atlas, width);
+	}
+
+	if (!WriteDds(outPath + ".dds", format, width, height, atlas))
+	{
+		std::printf("failed to write %s.dds\n", outPath.c_str());
+		return 1;
+	}
+
+	FILE* sheet = std::fopen((outPath + ".txt").c_str(), "w");
+	if (!sheet)
+	{
+		std::printf("failed to write %s.txt\n", outPath.c_str());
+		return 1;
+	}
+
+	std::fprintf(sheet, "#\n# Sprite sheet data for SpriteSheet::Load, generated by AtlasPacker.\n");
+	std::fprintf(sheet, "# Format: name;rotated;x;y;width;height;sourceWidth;sourceHeight;pivotX;pivotY\n#\n\n");
+	for (const Image& image : images)
+	{
+		std::fprintf(sheet, "%s;0;%u;%u;%u;%u;%u;%u;0;0\n", image.name.c_str(), image.x, image.y, image.width, image.height, image.width, image.height);
+
+		uint32_t frameWidth = image.width / image.frames;
+		for (uint32_t frame = 0; image.frames > 1 && frame < image.frames; frame++)
+		{
+			std::fprintf(sheet, "%s%04u;0;%u;%u;%u;%u;%u;%u;0;0\n", image.name.c_str(), frame + 1, image.x + frame * frameWidth, image.y,
+				frameWidth, image.height, frameWidth, image.height);
+		}
+	}
+	std::fclose(sheet);
+
+	std::printf("%s.dds: %ux%u, %zu sprites, %.1f%% used\n", outPath.c_str(), width, height, images.size(), 100.0 * (double)spriteArea / ((double)width * height));
+	return 0;
+}
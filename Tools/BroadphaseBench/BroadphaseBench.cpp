@@ -0,0 +1,120 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Scaling of the collision pass from 10 to 100k entities: the broadphase
+// (rebuild + player query + enemy-vs-wall + enemy-vs-enemy pairs) against
+// the brute force loops it replaced. Entities are spread over a course that
+// grows with their count, so the density stays close to one screen of the
+// real game.
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Simulation/Broadphase.hpp"
+
+namespace
+{
+	struct Scene
+	{
+		Simulation::Rect				player;
+		std::vector<Simulation::Rect>	walls;
+		std::vector<Simulation::Rect>	enemies;
+	};
+
+	Scene MakeScene(size_t entityCount)
+	{
+		Scene scene;
+		std::mt19937 random(1);
+
+		float courseWidth = 1920.f * (float)(1 + entityCount / 64);
+		std::uniform_real_distribution<float> distX(0.f, courseWidth);
+		std::uniform_real_distribution<float> distY(0.f, 1080.f);
+		std::uniform_real_distribution<float> distGap(0.f, 1080.f - 256.f);
+
+		scene.player = Simulation::Rect(courseWidth / 2, 512.f, 138.f, 81.f);
+
+		// One wall (two rectangles) for every 16 entities, the rest are enemies.
+		size_t wallCount = entityCount / 16;
+		for (size_t i = 0; i < wallCount; i++)
+		{
+			float x = distX(random);
+			float gap = distGap(random);
+			scene.walls.push_back(Simulation::Rect(x, 0.f, 100.f, gap));
+			scene.walls.push_back(Simulation::Rect(x, gap + 256.f, 100.f, 1080.f - gap - 256.f));
+		}
+
+		for (size_t i = wallCount; i < entityCount; i++)
+		{
+			scene.enemies.push_back(Simulation::Rect(distX(random), distY(random), 138.f, 81.f));
+		}
+
+		return scene;
+	}
+
+	void BM_BruteForce(benchmark::State& state)
+	{
+		Scene scene = MakeScene((size_t)state.range(0));
+
+		for (auto _ : state)
+		{
+			size_t hits = 0;
+
+			for (auto& wall : scene.walls)
+				hits += wall.IntersectsWith(scene.player) ? 1 : 0;
+			for (auto& enemy : scene.enemies)
+				hits += enemy.IntersectsWith(scene.player) ? 1 : 0;
+
+			for (auto& enemy : scene.enemies)
+				for (auto& wall : scene.walls)
+					hits += enemy.IntersectsWith(wall) ? 1 : 0;
+
+			for (size_t i = 0; i < scene.enemies.size(); i++)
+				for (size_t j = i + 1; j < scene.enemies.size(); j++)
+					hits += scene.enemies[i].IntersectsWith(scene.enemies[j]) ? 1 : 0;
+
+			benchmark::DoNotOptimize(hits);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void BM_Broadphase(benchmark::State& state)
+	{
+		Scene scene = MakeScene((size_t)state.range(0));
+
+		Simulation::Broadphase broadphase;
+		std::vector<uint32_t> queryResults;
+		std::vector<Simulation::BroadphasePair> pairs;
+
+		for (auto _ : state)
+		{
+			broadphase.Clear();
+			broadphase.Add(scene.player, Simulation::BroadphaseLayer_Player, 0);
+			for (size_t i = 0; i < scene.walls.size(); i++)
+				broadphase.Add(scene.walls[i], Simulation::BroadphaseLayer_Wall, (uint32_t)i);
+			for (size_t i = 0; i < scene.enemies.size(); i++)
+				broadphase.Add(scene.enemies[i], Simulation::BroadphaseLayer_Enemy, (uint32_t)i);
+			broadphase.Build();
+
+			queryResults.clear();
+			broadphase.Query(scene.player, Simulation::BroadphaseLayer_Wall | Simulation::BroadphaseLayer_Enemy, queryResults);
+
+			pairs.clear();
+			broadphase.FindPairs(Simulation::BroadphaseLayer_Enemy, Simulation::BroadphaseLayer_Wall, pairs);
+			broadphase.FindPairs(Simulation::BroadphaseLayer_Enemy, Simulation::BroadphaseLayer_Enemy, pairs);
+
+			benchmark::DoNotOptimize(queryResults.data());
+			benchmark::DoNotOptimize(pairs.data());
+		}
+
+		state.counters["pairs"] = (double)pairs.size();
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+}
+
+BENCHMARK(BM_BruteForce)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Broadphase)->RangeMultiplier(10)->Range(10, 100000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,160 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Compares the structure-of-arrays Simulation::EnemyPool with the previous
+// std::vector<Enemy> layout, where every enemy carried its own refcounted
+// texture and animation handles and dead enemies were erased mid-iteration.
+// Each iteration moves every enemy, kills the ones that left the screen and
+// respawns them at the right edge, keeping the live count constant.
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Simulation/EnemyPool.hpp"
+
+namespace
+{
+	const float ScreenWidth = 1920.f;
+	const float ScreenHeight = 1080.f;
+
+	// Stand-in for the old Content\Enemy.hpp: same fields, with shared_ptrs in
+	// place of the ComPtr texture and shared_ptr<AnimatedTexture> members.
+	class LegacyEnemy
+	{
+	public:
+		LegacyEnemy(const std::shared_ptr<int>& spriteSheet, const std::shared_ptr<int>& animation) :
+			texture(spriteSheet), animation(animation), width(138), height(81), textureWidth(138), textureHeight(81),
+			framesOfAnimation(4), framesToBeShownPerSecond(4), visible(true), flightSpeed(0)
+		{
+		}
+
+		void setPosition(Simulation::Float2 newPosition)
+		{
+			position = newPosition;
+			rectangle = Simulation::Rect(position.x, position.y, (float)width, (float)height);
+		}
+
+		Simulation::Float2 getPosition() { return position; }
+		bool isVisible() { return visible; }
+		void setVisibility(bool visibility) { visible = visibility; }
+		void setFlightSpeed(int speed) { flightSpeed = speed; }
+		int getFlightSpeed() { return flightSpeed; }
+
+		Simulation::Rect		rectangle;
+
+	private:
+		std::shared_ptr<int>	texture;
+		std::shared_ptr<int>	animation;
+		Simulation::Float2		position;
+		int						width;
+		int						height;
+		int						textureWidth;
+		int						textureHeight;
+		int						framesOfAnimation;
+		int						framesToBeShownPerSecond;
+		bool					visible;
+		int						flightSpeed;
+	};
+
+	void BM_VectorOfObjects(benchmark::State& state)
+	{
+		size_t count = (size_t)state.range(0);
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> distX(0.f, ScreenWidth);
+		std::uniform_real_distribution<float> distY(0.f, ScreenHeight);
+		std::uniform_int_distribution<int> distSpeed(5, 25);
+
+		auto texture = std::make_shared<int>(0);
+		auto animation = std::make_shared<int>(0);
+
+		std::vector<LegacyEnemy> enemies;
+		for (size_t i = 0; i < count; i++)
+		{
+			LegacyEnemy enemy(texture, animation);
+			enemy.setFlightSpeed(distSpeed(random));
+			enemy.setPosition(Simulation::Float2(distX(random), distY(random)));
+			enemies.push_back(enemy);
+		}
+
+		for (auto _ : state)
+		{
+			for (auto& enemy : enemies)
+			{
+				Simulation::Float2 tempPos = enemy.getPosition();
+				tempPos.x -= enemy.getFlightSpeed();
+				enemy.setPosition(tempPos);
+				if (tempPos.x < 0)
+				{
+					enemy.setVisibility(false);
+				}
+			}
+
+			size_t removed = 0;
+			for (auto it = enemies.begin(); it < enemies.end();)
+			{
+				if (it->isVisible() == false)
+				{
+					it = enemies.erase(it);
+					removed++;
+				}
+				else
+				{
+					it++;
+				}
+			}
+
+			for (size_t i = 0; i < removed; i++)
+			{
+				LegacyEnemy enemy(texture, animation);
+				enemy.setFlightSpeed(distSpeed(random));
+				enemy.setPosition(Simulation::Float2(ScreenWidth, distY(random)));
+				enemies.push_back(enemy);
+			}
+
+			benchmark::DoNotOptimize(enemies.data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * (int64_t)count);
+	}
+
+	void BM_EnemyPool(benchmark::State& state)
+	{
+		size_t count = (size_t)state.range(0);
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> distX(0.f, ScreenWidth);
+		std::uniform_real_distribution<float> distY(0.f, ScreenHeight);
+		std::uniform_int_distribution<int> distSpeed(5, 25);
+
+		Simulation::EnemyPool pool;
+		pool.SetSize(138.f, 81.f);
+		pool.Reserve(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			pool.Spawn(distX(random), distY(random), (float)distSpeed(random));
+		}
+
+		for (auto _ : state)
+		{
+			pool.Integrate(1.f);
+
+			size_t removed = pool.RemoveInvisible();
+
+			for (size_t i = 0; i < removed; i++)
+			{
+				pool.Spawn(ScreenWidth, distY(random), (float)distSpeed(random));
+			}
+
+			benchmark::DoNotOptimize(pool.X());
+		}
+
+		state.SetItemsProcessed(state.iterations() * (int64_t)count);
+	}
+}
+
+BENCHMARK(BM_VectorOfObjects)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EnemyPool)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
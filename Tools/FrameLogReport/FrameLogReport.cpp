@@ -0,0 +1,106 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Summarises a frame time log written by the game, by default
+// LocalFolder\frame_times.pgft: percentiles of update, render and present
+// over the whole session, the worst rolling window of each, and how many
+// frames missed the frame budget.
+//
+// Usage: FrameLogReport <frame log> [--window frames] [--budget ms]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "Simulation/FrameTimings.hpp"
+
+namespace
+{
+	void PrintUsage(const char* exe)
+	{
+		std::printf("Usage: %s <frame log> [--window frames] [--budget ms]\n", exe);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2 || !std::strncmp(argv[1], "--", 2) || argc % 2 != 0)
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	uint32_t window = 240;
+	double budget = 1000.0 / 60.0;
+	for (int i = 2; i < argc; i += 2)
+	{
+		if (!std::strcmp(argv[i], "--window"))			window = (uint32_t)std::strtoul(argv[i + 1], nullptr, 10);
+		else if (!std::strcmp(argv[i], "--budget"))		budget = std::strtod(argv[i + 1], nullptr);
+		else
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<Simulation::FrameSample> samples;
+	{
+		std::ifstream file(argv[1], std::ios::binary);
+		if (!file || !Simulation::FrameLogWriter::Read(file, samples))
+		{
+			std::printf("%s is not a readable frame log\n", argv[1]);
+			return 1;
+		}
+	}
+
+	if (samples.empty() || window == 0)
+	{
+		std::printf("%s: no frames\n", argv[1]);
+		return 0;
+	}
+
+	uint64_t missing = samples.back().frame + 1 - samples.size();
+	uint32_t overBudget = 0;
+	for (const auto& sample : samples)
+	{
+		double total = 0.0;
+		for (int phase = 0; phase < Simulation::FramePhase_Count; phase++)
+		{
+			total += sample.nanoseconds[phase] * 1e-6;
+		}
+		overBudget += total > budget ? 1 : 0;
+	}
+
+	std::printf("log:                %s\n", argv[1]);
+	std::printf("frames:             %zu (%llu not logged)\n", samples.size(), (unsigned long long)missing);
+	std::printf("over %.2f ms:       %u\n", budget, overBudget);
+	std::printf("%-10s %9s %9s %9s %9s   worst %u frame window p99 / max\n", "ms", "p50", "p95", "p99", "max", window);
+
+	for (int phase = 0; phase < Simulation::FramePhase_Count; phase++)
+	{
+		Simulation::FrameTimeWindow all((uint32_t)samples.size());
+		Simulation::FrameTimeWindow rolling(window);
+		Simulation::FrameTimeStats worst = {};
+		for (size_t i = 0; i < samples.size(); i++)
+		{
+			all.Add(samples[i].nanoseconds[phase]);
+			rolling.Add(samples[i].nanoseconds[phase]);
+
+			// Full windows only, a quarter of a window apart.
+			if (i + 1 >= window && (i + 1 - window) % (window / 4 + 1) == 0)
+			{
+				Simulation::FrameTimeStats stats = rolling.GetStats();
+				if (stats.p99 > worst.p99)
+					worst = stats;
+			}
+		}
+
+		Simulation::FrameTimeStats stats = all.GetStats();
+		std::printf("%-10s %9.3f %9.3f %9.3f %9.3f   %9.3f %9.3f\n", Simulation::GetFramePhaseName((Simulation::FramePhase)phase),
+			stats.p50, stats.p95, stats.p99, stats.max, worst.p99, worst.max);
+	}
+
+	return 0;
+}
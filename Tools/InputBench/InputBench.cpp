@@ -0,0 +1,228 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Cost of the InputManager translate pipeline (Common\InputTranslator.hpp)
+// under synthetic load: up to ten fingers moving on a touch screen with a
+// virtual stick and two virtual buttons, and four gamepads with both
+// sticks, triggers and buttons in use. Every step queues one move event
+// per finger, as the CoreWindow callbacks would, then translates.
+//
+// The read benchmarks compare how a consumer gets at one action per
+// player: copying the frame into a std::vector and scanning it, as
+// GetPlayersActions used to require, against the PlayerActions views.
+
+#include <cmath>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Common/InputTranslator.hpp"
+
+using namespace SimpleSample_DirectXTK_UWP;
+
+namespace
+{
+	const float ScreenWidth = 1920.f;
+	const float ScreenHeight = 1080.f;
+
+	void AddTouchRegions(InputTranslator& translator)
+	{
+		TouchRegionBounds stick = { 0.f, 540.f, 540.f, 1080.f, TOUCH_CONTROL_REGION_ANALOG_STICK, INPUT_MOVE, true };
+		TouchRegionBounds fire = { 1500.f, 800.f, 1700.f, 1000.f, TOUCH_CONTROL_REGION_BUTTON, INPUT_FIRE_DOWN, true };
+		TouchRegionBounds jump = { 1720.f, 600.f, 1900.f, 780.f, TOUCH_CONTROL_REGION_BUTTON, INPUT_JUMP_DOWN, true };
+
+		unsigned int id;
+		translator.AddTouchRegion(stick, id);
+		translator.AddTouchRegion(fire, id);
+		translator.AddTouchRegion(jump, id);
+	}
+
+	// Finger 0 drags the stick, 1 and 2 hold the buttons, the rest wander
+	// over the screen; each traces a small circle around its home point.
+	PointerControllerAction Finger(int finger, int step)
+	{
+		float homeX, homeY;
+		switch (finger)
+		{
+		case 0:		homeX = 270.f;	homeY = 810.f;	break;
+		case 1:		homeX = 1600.f;	homeY = 900.f;	break;
+		case 2:		homeX = 1810.f;	homeY = 690.f;	break;
+		default:	homeX = ScreenWidth * (finger - 2) / 9.f;	homeY = ScreenHeight * 0.3f;	break;
+		}
+
+		float angle = step * 0.05f + finger;
+		float radius = finger == 0 ? 60.f : 20.f;
+
+		PointerControllerAction pointer = {};
+		pointer.PointerId = 100 + finger;
+		pointer.CurrentX = homeX + radius * std::cos(angle);
+		pointer.CurrentY = homeY + radius * std::sin(angle);
+		pointer.IsTouchEvent = true;
+		pointer.IsLeftButtonPressed = true;
+		return pointer;
+	}
+
+	GamepadState Gamepad(int controller, int step)
+	{
+		float angle = step * 0.03f + controller;
+
+		GamepadState gamepad = {};
+		gamepad.Buttons = (uint16_t)(((step / 8 + controller) & 1) ? (GAMEPAD_A | GAMEPAD_X) : GAMEPAD_B);
+		gamepad.LeftTrigger = (uint8_t)(step * 3 + controller * 50);
+		gamepad.RightTrigger = (uint8_t)((step & 16) ? 255 : 0);
+		gamepad.ThumbLX = (int16_t)(30000.f * std::cos(angle));
+		gamepad.ThumbLY = (int16_t)(30000.f * std::sin(angle));
+		gamepad.ThumbRX = (int16_t)(20000.f * std::sin(angle));
+		gamepad.ThumbRY = (int16_t)(20000.f * std::cos(angle));
+		return gamepad;
+	}
+
+	// One frame of input: a move per finger (a press on the first frame), then the gamepads.
+	void FeedFrame(InputTranslator& translator, int fingers, int gamepads, int step)
+	{
+		InputEvent inputEvent = {};
+		inputEvent.Type = step == 0 ? INPUT_EVENT_TYPE_DOWN : INPUT_EVENT_TYPE_MOVED;
+		for (int finger = 0; finger < fingers; finger++)
+		{
+			inputEvent.Pointer = Finger(finger, step);
+			translator.GetEventQueue().Push(inputEvent);
+		}
+
+		for (int controller = 0; controller < gamepads; controller++)
+		{
+			translator.SetGamepadState(controller, Gamepad(controller, step));
+		}
+	}
+
+	void BM_Translate(benchmark::State& state)
+	{
+		int fingers = (int)state.range(0);
+		int gamepads = (int)state.range(1);
+
+		InputTranslator translator;
+		AddTouchRegions(translator);
+
+		int step = 0;
+		for (auto _ : state)
+		{
+			FeedFrame(translator, fingers, gamepads, step++);
+			translator.Translate(INPUT_DEVICE_ALL);
+			benchmark::DoNotOptimize(translator.GetActions().size());
+		}
+
+		state.SetItemsProcessed(state.iterations());
+		state.counters["actions"] = (double)translator.GetActions().size();
+	}
+
+	void BM_TranslateKeyboard(benchmark::State& state)
+	{
+		InputTranslator translator;
+
+		InputEvent inputEvent = {};
+		inputEvent.IsKeyEvent = true;
+		const unsigned int heldKeys[] = { INPUT_KEY_SPACE, INPUT_KEY_LEFT, INPUT_KEY_UP, 'W', 'A' };
+		for (unsigned int key : heldKeys)
+		{
+			inputEvent.Type = INPUT_EVENT_TYPE_DOWN;
+			inputEvent.VirtualKey = key;
+			translator.GetEventQueue().Push(inputEvent);
+		}
+
+		int step = 0;
+		for (auto _ : state)
+		{
+			// Tap control every other frame.
+			inputEvent.Type = (step++ & 1) ? INPUT_EVENT_TYPE_UP : INPUT_EVENT_TYPE_DOWN;
+			inputEvent.VirtualKey = INPUT_KEY_CONTROL;
+			translator.GetEventQueue().Push(inputEvent);
+
+			translator.Translate(INPUT_DEVICE_ALL);
+			benchmark::DoNotOptimize(translator.GetActions().size());
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_EventQueue(benchmark::State& state)
+	{
+		InputEventQueue queue;
+		InputEvent inputEvent = {};
+		for (auto _ : state)
+		{
+			for (int i = 0; i < 10; i++)
+			{
+				inputEvent.Pointer.PointerId = i;
+				queue.Push(inputEvent);
+			}
+			while (queue.Pop(inputEvent))
+				benchmark::DoNotOptimize(inputEvent.Pointer.PointerId);
+		}
+
+		state.SetItemsProcessed(state.iterations() * 10);
+	}
+
+	// A translator holding a frame of ten fingers and four gamepads.
+	InputTranslator& GetLoadedTranslator()
+	{
+		static InputTranslator* translator = nullptr;
+		if (!translator)
+		{
+			translator = new InputTranslator;
+			AddTouchRegions(*translator);
+			FeedFrame(*translator, 10, 4, 0);
+			translator->Translate(INPUT_DEVICE_ALL);
+			FeedFrame(*translator, 10, 4, 1);
+			translator->Translate(INPUT_DEVICE_ALL);
+		}
+		return *translator;
+	}
+
+	// Every player's move and fire state, the way a game loop would read it.
+	void BM_ReadByVectorScan(benchmark::State& state)
+	{
+		const PlayerActions& actions = GetLoadedTranslator().GetActions();
+		for (auto _ : state)
+		{
+			std::vector<PlayerInputData> copy(actions.begin(), actions.end());
+
+			float sum = 0.f;
+			for (unsigned int player = 0; player < INPUT_MAX_PLAYERS; player++)
+			{
+				for (const PlayerInputData& action : copy)
+				{
+					if (action.ID == player && action.PlayerAction == INPUT_MOVE)
+						sum += action.X;
+					if (action.ID == player && action.PlayerAction == INPUT_FIRE_DOWN)
+						sum += 1.f;
+				}
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_ReadByView(benchmark::State& state)
+	{
+		const PlayerActions& actions = GetLoadedTranslator().GetActions();
+		for (auto _ : state)
+		{
+			float sum = 0.f;
+			for (const PlayerInputData& move : actions.OfType(INPUT_MOVE))
+				sum += move.X;
+			for (unsigned int player = 0; player < INPUT_MAX_PLAYERS; player++)
+				sum += actions.Has(player, INPUT_FIRE_DOWN) ? 1.f : 0.f;
+			benchmark::DoNotOptimize(sum);
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+BENCHMARK(BM_Translate)->Args({ 0, 0 })->Args({ 0, 4 })->Args({ 1, 0 })->Args({ 10, 0 })->Args({ 10, 4 })->ArgNames({ "fingers", "gamepads" });
+BENCHMARK(BM_TranslateKeyboard);
+BENCHMARK(BM_EventQueue);
+BENCHMARK(BM_ReadByVectorScan);
+BENCHMARK(BM_ReadByView);
+
+BENCHMARK_MAIN();
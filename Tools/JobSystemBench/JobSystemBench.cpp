@@ -0,0 +1,113 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// The enemy AI pass three ways: one std::async per enemy (what the game's
+// AI region used to do every frame), a single thread, and the persistent
+// JobSystem with 1 to N threads.
+
+#include <future>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Simulation/EnemyPool.hpp"
+#include "Simulation/JobSystem.hpp"
+
+namespace
+{
+	const float TargetX = 300.f;
+	const float TargetY = 512.f;
+	const float MaxStep = 2.f;
+	const float MaxY = 1080.f - 81.f;
+
+	void FillPool(Simulation::EnemyPool& pool, size_t count)
+	{
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> distX(0.f, 1920.f);
+		std::uniform_real_distribution<float> distY(0.f, 1080.f);
+
+		pool.SetSize(138.f, 81.f);
+		for (size_t i = 0; i < count; i++)
+		{
+			pool.Spawn(distX(random), distY(random), 10.f);
+		}
+	}
+
+	void BM_AsyncPerEnemy(benchmark::State& state)
+	{
+		Simulation::EnemyPool pool;
+		FillPool(pool, (size_t)state.range(0));
+
+		for (auto _ : state)
+		{
+			std::vector<std::future<void>> futures;
+			for (size_t i = 0; i < pool.Size(); i++)
+			{
+				futures.push_back(std::async(std::launch::async, [&pool, i]()
+				{
+					pool.Steer(i, i + 1, TargetX, TargetY, MaxStep, MaxY);
+				}));
+			}
+			for (auto& future : futures)
+			{
+				future.get();
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void BM_SingleThread(benchmark::State& state)
+	{
+		Simulation::EnemyPool pool;
+		FillPool(pool, (size_t)state.range(0));
+
+		for (auto _ : state)
+		{
+			pool.Steer(0, pool.Size(), TargetX, TargetY, MaxStep, MaxY);
+			benchmark::DoNotOptimize(pool.Y());
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// range(0) enemies on range(1) threads.
+	void BM_JobSystem(benchmark::State& state)
+	{
+		Simulation::EnemyPool pool;
+		FillPool(pool, (size_t)state.range(0));
+		Simulation::JobSystem jobs((unsigned int)state.range(1));
+
+		for (auto _ : state)
+		{
+			jobs.ParallelFor(pool.Size(), 4096, [&pool](size_t begin, size_t end)
+			{
+				pool.Steer(begin, end, TargetX, TargetY, MaxStep, MaxY);
+			});
+			benchmark::DoNotOptimize(pool.Y());
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void JobSystemArguments(benchmark::internal::Benchmark* benchmark)
+	{
+		int hardwareThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+		for (int enemies = 1000; enemies <= 1000000; enemies *= 10)
+		{
+			for (int threads = 1; threads < hardwareThreads; threads *= 2)
+			{
+				benchmark->Args({ enemies, threads });
+			}
+			benchmark->Args({ enemies, hardwareThreads });
+		}
+	}
+}
+
+BENCHMARK(BM_AsyncPerEnemy)->RangeMultiplier(10)->Range(10, 1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SingleThread)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_JobSystem)->Apply(JobSystemArguments)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+BENCHMARK_MAIN();
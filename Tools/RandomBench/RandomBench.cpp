@@ -0,0 +1,76 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Cost of one random wall gap / enemy spawn value: building a
+// std::random_device and std::mt19937 per call (what Wall::randomizeGap
+// and the spawn code used to do), a persistent mt19937, and Pcg32 one at a
+// time or in bulk.
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Simulation/Random.hpp"
+
+namespace
+{
+	void BM_RandomDevicePerCall(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			std::random_device rd;
+			std::mt19937 random(rd());
+			std::uniform_int_distribution<int> dist(0, 1080 - 256);
+			benchmark::DoNotOptimize(dist(random));
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_Mt19937(benchmark::State& state)
+	{
+		std::mt19937 random(1);
+		std::uniform_int_distribution<int> dist(0, 1080 - 256);
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(dist(random));
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_Pcg32NextInt(benchmark::State& state)
+	{
+		Simulation::Pcg32 random(1, 0);
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(random.NextInt(0, 1080 - 256));
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_Pcg32FillInt(benchmark::State& state)
+	{
+		Simulation::Pcg32 random(1, 0);
+		std::vector<int> values((size_t)state.range(0));
+
+		for (auto _ : state)
+		{
+			random.FillInt(values.data(), values.size(), 0, 1080);
+			benchmark::DoNotOptimize(values.data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+}
+
+BENCHMARK(BM_RandomDevicePerCall);
+BENCHMARK(BM_Mt19937);
+BENCHMARK(BM_Pcg32NextInt);
+BENCHMARK(BM_Pcg32FillInt)->RangeMultiplier(16)->Range(16, 4096);
+
+BENCHMARK_MAIN();
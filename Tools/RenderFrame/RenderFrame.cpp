@@ -0,0 +1,361 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Draws a frame of the game without a GPU. The simulation runs for a number
+// of ticks, then walls, player and enemies are drawn from the gameplay atlas
+// the way Sample3DSceneRenderer::Render draws them, through the
+// SoftwareSpriteRenderer. The frame can be written out as a TGA and is
+// summarised by a hash of its pixels, which is the same at any thread
+// count, so a changed hash flags a change in what the game draws.
+//
+// Usage: RenderFrame [--assets dir] [--ticks N] [--seed N] [--enemies N]
+//                    [--width px] [--height px] [--threads N] [--frames N]
+//                    [--out file.tga] [--expect hash]
+//
+// --threads draws the tiles on a JobSystem with N threads (0 = all hardware
+// threads). --frames draws the frame N times and reports the time per frame.
+// --expect exits with 2 when the hash differs. The parallax layers are
+// block compressed and not drawn; the frame is cleared to a flat colour.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/SoftwareSpriteRenderer.hpp"
+#include "Common/SpriteClips.hpp"
+#include "Common/SpriteSheetData.hpp"
+#include "Simulation/Animation.hpp"
+#include "Simulation/World.hpp"
+
+namespace
+{
+	void PrintUsage(const char* exe)
+	{
+		std::printf("Usage: %s [--assets dir] [--ticks N] [--seed N] [--enemies N] [--width px] [--height px] [--threads N] [--frames N] [--out file.tga] [--expect hash]\n", exe);
+	}
+
+	// The sprites of Content\Player.hpp, Enemy.hpp and Wall.hpp.
+	const float FramesPerSecond = 4.f;
+	const float SpriteScale = 3.f;
+	const uint32_t ClearColor = 0xff402010;		// Dark blue, opaque.
+
+	uint32_t Read32(const uint8_t* bytes)
+	{
+		return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+	}
+
+	bool ReadFile(const std::string& path, std::vector<uint8_t>& bytes)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			return false;
+		bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	// Uncompressed 32 bit DDS files as AtlasPacker writes them, in either byte order.
+	bool LoadDds(const std::string& path, SoftwareTexture& texture)
+	{
+		const size_t HeaderEnd = 4 + 124;
+		const size_t PixelFormatOffset = 4 + 72;
+		const uint32_t DDPF_RGB = 0x40;
+
+		std::vector<uint8_t> bytes;
+		if (!ReadFile(path, bytes) || bytes.size() < HeaderEnd || std::memcmp(bytes.data(), "DDS ", 4) != 0)
+		{
+			std::printf("%s: not a DDS file\n", path.c_str());
+			return false;
+		}
+
+		const uint8_t* format = &bytes[PixelFormatOffset];
+		if (!(Read32(format + 4) & DDPF_RGB) || Read32(format + 12) != 32)
+		{
+			std::printf("%s: only uncompressed 32 bit DDS files are supported\n", path.c_str());
+			return false;
+		}
+
+		texture.height = Read32(&bytes[4 + 8]);
+		texture.width = Read32(&bytes[4 + 12]);
+		size_t count = (size_t)texture.width * texture.height;
+		if (bytes.size() - HeaderEnd < count * 4)
+		{
+			std::printf("%s: truncated pixel data\n", path.c_str());
+			return false;
+		}
+
+		// A red mask in the third byte is BGRA; swap to RGBA.
+		bool bgra = Read32(format + 16) == 0x00ff0000u;
+		texture.pixels.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t pixel = Read32(&bytes[HeaderEnd + i * 4]);
+			texture.pixels[i] = bgra ? (pixel & 0xff00ff00u) | (pixel >> 16 & 0xff) | (pixel & 0xff) << 16 : pixel;
+		}
+		return true;
+	}
+
+	// The gameplay atlas with the sheet's clips, as FinishLoading sets them up.
+	struct Atlas
+	{
+		SoftwareTexture					texture;
+		std::vector<uint8_t>			sheetFile;
+		SpriteSheetView					sheet;
+		Simulation::AnimationClips		clips;
+		uint32_t						playerClip;
+		uint32_t						enemyClip;
+		SpriteRect						pipe;
+
+		SpriteRect GetFrame(uint32_t id) const
+		{
+			const SpriteSheetFileFrame& frame = sheet.GetFrame(id);
+			return SpriteRect(frame.left, frame.top, frame.right, frame.bottom);
+		}
+
+		SpriteRect GetFirstFrame(uint32_t clip) const
+		{
+			return GetFrame(clips.GetFrame(clips.Get(clip), 0));
+		}
+	};
+
+	bool FindClip(const Simulation::AnimationClips& clips, const char* name, uint32_t& clip)
+	{
+		clip = clips.Find(name);
+		if (clip == Simulation::InvalidAnimationClip)
+		{
+			std::printf("gameplay atlas has no clip '%s'\n", name);
+			return false;
+		}
+		return true;
+	}
+
+	void DrawScene(SpriteRenderer& renderer, Atlas& atlas, const Simulation::World& world, std::vector<uint32_t>& enemyFrames)
+	{
+		renderer.Begin();
+
+		const Simulation::Course& course = world.GetCourse();
+		float pipeHeight = (float)(atlas.pipe.bottom - atlas.pipe.top);
+		for (size_t i = 0; i < course.GetVisibleCount(); i++)
+		{
+			Simulation::Rect upper = course.GetUpperRect(i);
+			Simulation::Rect lower = course.GetLowerRect(i);
+
+			SpriteDraw wall(&atlas.texture, atlas.pipe, upper.X, upper.Y);
+			wall.scaleY = upper.Height / pipeHeight;
+			renderer.Draw(wall);
+
+			wall.y = lower.Y;
+			wall.scaleY = lower.Height / pipeHeight;
+			renderer.Draw(wall);
+		}
+
+		Simulation::AnimationPlayback playerPlayback(atlas.playerClip, 0.f);
+		uint32_t playerFrame;
+		Simulation::EvaluateAnimationFrames(atlas.clips, &playerPlayback, 1, world.GetTime(), &playerFrame);
+
+		const Simulation::Rect& playerRect = world.GetPlayer().rectangle;
+		SpriteDraw player(&atlas.texture, atlas.GetFrame(playerFrame), playerRect.X, playerRect.Y);
+		player.scaleX = player.scaleY = SpriteScale;
+		player.depth = 0.5f;
+		renderer.Draw(player);
+
+		const Simulation::EnemyPool& enemies = world.GetEnemies();
+		enemyFrames.resize(enemies.Size());
+		Simulation::EvaluateAnimationFrames(atlas.clips, enemies.Animation(), enemies.Size(), world.GetTime(), enemyFrames.data());
+		for (size_t i = 0; i < enemies.Size(); i++)
+		{
+			SpriteDraw enemy(&atlas.texture, atlas.GetFrame(enemyFrames[i]), enemies.X()[i], enemies.Y()[i]);
+			enemy.scaleX = enemy.scaleY = SpriteScale;
+			enemy.depth = 0.5f;
+			renderer.Draw(enemy);
+		}
+
+		renderer.End();
+	}
+
+	// FNV-1a over the visible pixels, row by row.
+	uint64_t HashPixels(const SoftwareSpriteRenderer& renderer)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (uint32_t y = 0; y < renderer.GetHeight(); y++)
+		{
+			const uint32_t* row = renderer.GetPixels() + (size_t)y * renderer.GetStride();
+			for (uint32_t x = 0; x < renderer.GetWidth(); x++)
+			{
+				hash = (hash ^ row[x]) * 1099511628211ull;
+			}
+		}
+		return hash;
+	}
+
+	// Uncompressed 32 bit TGA, top row first.
+	bool WriteTga(const char* path, const SoftwareSpriteRenderer& renderer)
+	{
+		uint8_t header[18] = {};
+		header[2] = 2;
+		header[12] = (uint8_t)renderer.GetWidth();
+		header[13] = (uint8_t)(renderer.GetWidth() >> 8);
+		header[14] = (uint8_t)renderer.GetHeight();
+		header[15] = (uint8_t)(renderer.GetHeight() >> 8);
+		header[16] = 32;
+		header[17] = 0x28;
+
+		std::vector<uint8_t> bytes(header, header + sizeof(header));
+		for (uint32_t y = 0; y < renderer.GetHeight(); y++)
+		{
+			const uint32_t* row = renderer.GetPixels() + (size_t)y * renderer.GetStride();
+			for (uint32_t x = 0; x < renderer.GetWidth(); x++)
+			{
+				uint32_t pixel = row[x];
+				uint8_t bgra[4] = { (uint8_t)(pixel >> 16), (uint8_t)(pixel >> 8), (uint8_t)pixel, (uint8_t)(pixel >> 24) };
+				bytes.insert(bytes.end(), bgra, bgra + 4);
+			}
+		}
+
+		std::ofstream file(path, std::ios::binary);
+		file.write((const char*)bytes.data(), bytes.size());
+		return (bool)file;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string assets = GAME_ASSETS_DIR;
+	unsigned long long ticks = 600;
+	Simulation::WorldConfig config;
+	config.seed = 1;
+	bool useJobs = false;
+	unsigned int threads = 0;
+	int frames = 1;
+	const char* outPath = nullptr;
+	const char* expected = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+		if (!value || std::strncmp(arg, "--", 2) != 0)
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+
+		if (!std::strcmp(arg, "--assets"))			assets = value;
+		else if (!std::strcmp(arg, "--ticks"))		ticks = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--seed"))		config.seed = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--enemies"))	config.maxEnemies = (unsigned int)std::strtoul(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--width"))		config.screenSize.Width = std::strtof(value, nullptr);
+		else if (!std::strcmp(arg, "--height"))		config.screenSize.Height = std::strtof(value, nullptr);
+		else if (!std::strcmp(arg, "--threads"))
+		{
+			useJobs = true;
+			threads = (unsigned int)std::strtoul(value, nullptr, 10);
+		}
+		else if (!std::strcmp(arg, "--frames"))		frames = (std::max)(1, std::atoi(value));
+		else if (!std::strcmp(arg, "--out"))		outPath = value;
+		else if (!std::strcmp(arg, "--expect"))		expected = value;
+		else
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+		i++;
+	}
+
+	Atlas atlas;
+	std::vector<uint8_t> sheetText;
+	std::vector<SpriteSheetEntry> entries;
+	std::string error;
+	if (!LoadDds(assets + "/gameplay.dds", atlas.texture))
+		return 1;
+	if (!ReadFile(assets + "/gameplay.txt", sheetText) ||
+		!ParseSpriteSheetText((const char*)sheetText.data(), sheetText.size(), entries, error))
+	{
+		std::printf("%s/gameplay.txt: %s\n", assets.c_str(), error.empty() ? "cannot be read" : error.c_str());
+		return 1;
+	}
+	atlas.sheetFile = BuildSpriteSheetFile(entries);
+	if (!atlas.sheet.Open(atlas.sheetFile.data(), atlas.sheetFile.size()))
+	{
+		std::printf("%s/gameplay.txt: cannot be laid out as a sheet\n", assets.c_str());
+		return 1;
+	}
+	BuildSpriteClips(atlas.sheet, FramesPerSecond, atlas.clips);
+	if (!FindClip(atlas.clips, "player", atlas.playerClip) || !FindClip(atlas.clips, "enemy", atlas.enemyClip))
+		return 1;
+
+	const SpriteSheetFileFrame* pipe = atlas.sheet.Find("pipe");
+	if (!pipe)
+	{
+		std::printf("gameplay atlas has no sprite 'pipe'\n");
+		return 1;
+	}
+	atlas.pipe = SpriteRect(pipe->left, pipe->top, pipe->right, pipe->bottom);
+
+	// Sizes as FinishLoading gives them to the world.
+	SpriteRect playerFrame = atlas.GetFirstFrame(atlas.playerClip);
+	SpriteRect enemyFrame = atlas.GetFirstFrame(atlas.enemyClip);
+	config.playerWidth = (int)((playerFrame.right - playerFrame.left) * SpriteScale);
+	config.playerHeight = (int)((playerFrame.bottom - playerFrame.top) * SpriteScale);
+	config.enemyWidth = (int)((enemyFrame.right - enemyFrame.left) * SpriteScale);
+	config.enemyHeight = (int)((enemyFrame.bottom - enemyFrame.top) * SpriteScale);
+	config.wallWidth = atlas.pipe.right - atlas.pipe.left;
+
+	std::unique_ptr<Simulation::JobSystem> jobs;
+	if (useJobs)
+	{
+		jobs.reset(new Simulation::JobSystem(threads));
+	}
+
+	// Enemies steer towards a player that bobs up and down.
+	Simulation::World world(config);
+	world.SetJobSystem(jobs.get());
+	world.SetEnemyClip(atlas.enemyClip);
+	for (unsigned long long tick = 0; tick < ticks; tick++)
+	{
+		Simulation::PlayerInput input;
+		input.MoveY = (tick / 60) % 2 ? 0.5f : -0.5f;
+		world.Tick(1.f / 60.f, input);
+	}
+
+	std::vector<uint32_t> enemyFrames;
+
+	SoftwareSpriteRenderer renderer((uint32_t)config.screenSize.Width, (uint32_t)config.screenSize.Height, jobs.get());
+
+	auto start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < frames; frame++)
+	{
+		renderer.Clear(ClearColor);
+		DrawScene(renderer, atlas, world, enemyFrames);
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	uint64_t hash = HashPixels(renderer);
+	size_t sprites = 1 + 2 * world.GetCourse().GetVisibleCount() + world.GetEnemies().Size();
+
+	std::printf("size:               %ux%u\n", renderer.GetWidth(), renderer.GetHeight());
+	std::printf("threads:            %u\n", jobs ? jobs->GetThreadCount() : 1u);
+	std::printf("sprites:            %zu\n", sprites);
+	std::printf("ms/frame:           %.3f\n", seconds * 1000.0 / frames);
+	std::printf("sprites/sec:        %.0f\n", sprites * frames / seconds);
+	std::printf("hash:               %016llx\n", (unsigned long long)hash);
+
+	if (outPath && !WriteTga(outPath, renderer))
+	{
+		std::printf("failed to write %s\n", outPath);
+		return 1;
+	}
+
+	if (expected && std::strtoull(expected, nullptr, 16) != hash)
+	{
+		std::printf("hash differs from the expected %s\n", expected);
+		return 2;
+	}
+	return 0;
+}
@@ -0,0 +1,247 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Replays an input log through the simulation at full speed and reports how
+// long every tick took. The world is rebuilt from the config and seed stored
+// in the log, so two builds replaying the same log do identical work; a
+// matching state hash at the end proves it, and the timing profile shows
+// where one build got slower.
+//
+// Usage: ReplayRunner <input log> [--profile file.csv] [--trace file.json] [--threads N]
+//
+// The profile has one line per tick: tick, nanoseconds, entity count.
+// The trace holds the profiler zones of the last ticks of every thread, for
+// chrome://tracing or ui.perfetto.dev.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "Common/StepTimer.h"
+#include "Simulation/InputLog.hpp"
+#include "Simulation/Profiler.hpp"
+#include "Simulation/World.hpp"
+
+namespace
+{
+	void PrintUsage(const char* exe)
+	{
+		std::printf("Usage: %s <input log> [--profile file.csv] [--trace file.json] [--threads N]\n", exe);
+	}
+
+	// FNV-1a over the bits of everything the simulation moves.
+	class StateHash
+	{
+	public:
+		StateHash() : m_hash(14695981039346656037ull) {}
+
+		void Add(const void* data, size_t size)
+		{
+			const uint8_t* bytes = (const uint8_t*)data;
+			for (size_t i = 0; i < size; i++)
+			{
+				m_hash = (m_hash ^ bytes[i]) * 1099511628211ull;
+			}
+		}
+
+		void Add(float value)		{ Add(&value, sizeof(value)); }
+		uint64_t Get() const		{ return m_hash; }
+
+	private:
+		uint64_t m_hash;
+	};
+
+	uint64_t HashWorld(const Simulation::World& world)
+	{
+		StateHash hash;
+
+		auto tick = world.GetTickCount();
+		hash.Add(&tick, sizeof(tick));
+
+		auto player = world.GetPlayer().getPosition();
+		hash.Add(player.x);
+		hash.Add(player.y);
+
+		auto& course = world.GetCourse();
+		for (size_t i = 0; i < course.Size(); i++)
+		{
+			hash.Add(course.GetGapRect(i).X);
+			hash.Add(course.GetGapRect(i).Y);
+		}
+
+		auto& enemies = world.GetEnemies();
+		uint64_t count = enemies.Size();
+		hash.Add(&count, sizeof(count));
+		hash.Add(enemies.X(), enemies.Size() * sizeof(float));
+		hash.Add(enemies.Y(), enemies.Size() * sizeof(float));
+
+		return hash.Get();
+	}
+
+	double Percentile(const std::vector<uint64_t>& sorted, double fraction)
+	{
+		if (sorted.empty())
+			return 0.0;
+		size_t index = (size_t)(fraction * (sorted.size() - 1) + 0.5);
+		return (double)sorted[index];
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2 || !std::strncmp(argv[1], "--", 2))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	const char* logPath = argv[1];
+	const char* profilePath = nullptr;
+	const char* tracePath = nullptr;
+	bool useJobs = false;
+	unsigned int threads = 0;
+
+	for (int i = 2; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+		if (!value)
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+
+		if (!std::strcmp(arg, "--profile"))			profilePath = value;
+		else if (!std::strcmp(arg, "--trace"))		tracePath = value;
+		else if (!std::strcmp(arg, "--threads"))
+		{
+			useJobs = true;
+			threads = (unsigned int)std::strtoul(value, nullptr, 10);
+		}
+		else
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+		i++;
+	}
+
+	Simulation::InputLog log;
+	{
+		std::ifstream file(logPath, std::ios::binary);
+		if (!file || !log.Read(file))
+		{
+			std::printf("%s is not a readable input log\n", logPath);
+			return 1;
+		}
+	}
+
+	std::unique_ptr<Simulation::JobSystem> jobs;
+	Simulation::World world(log.GetConfig());
+	if (useJobs)
+	{
+		jobs.reset(new Simulation::JobSystem(threads));
+		world.SetJobSystem(jobs.get());
+	}
+
+	// One fixed step per Tick, as fast as the CPU allows.
+	uint64_t stepTicks = DX::StepTimer::SecondsToTicks(log.GetStepSeconds());
+	DX::StepTimer timer(std::make_shared<DX::VirtualClock>(stepTicks));
+	timer.SetFixedTimeStep(true);
+	timer.SetTargetElapsedTicks(stepTicks);
+
+	std::vector<uint64_t> tickNanoseconds;
+	std::vector<uint32_t> tickEntities;
+	tickNanoseconds.reserve((size_t)log.GetTickCount());
+	tickEntities.reserve((size_t)log.GetTickCount());
+
+	Simulation::InputLog::Cursor cursor(log);
+	Simulation::PlayerInput input;
+	bool more = true;
+
+	if (tracePath)
+	{
+		Simulation::Profiler::Get().SetThreadName("Replay");
+		Simulation::Profiler::Get().SetEnabled(true);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	while (more)
+	{
+		timer.Tick([&]()
+		{
+			if (!(more = cursor.Next(input)))
+				return;
+
+			tickEntities.push_back((uint32_t)world.GetEntityCount());
+
+			auto tickStart = std::chrono::steady_clock::now();
+			world.Tick((float)timer.GetElapsedSeconds(), input);
+			auto tickEnd = std::chrono::steady_clock::now();
+
+			tickNanoseconds.push_back((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(tickEnd - tickStart).count());
+		});
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	if (profilePath)
+	{
+		FILE* file = std::fopen(profilePath, "w");
+		if (!file)
+		{
+			std::printf("failed to write %s\n", profilePath);
+			return 1;
+		}
+
+		std::fprintf(file, "tick,ns,entities\n");
+		for (size_t i = 0; i < tickNanoseconds.size(); i++)
+		{
+			std::fprintf(file, "%zu,%llu,%u\n", i, (unsigned long long)tickNanoseconds[i], tickEntities[i]);
+		}
+		std::fclose(file);
+	}
+
+	if (tracePath)
+	{
+		Simulation::Profiler::Get().SetEnabled(false);
+
+		std::ofstream file(tracePath);
+		if (!file || !Simulation::Profiler::Get().WriteChromeTrace(file))
+		{
+			std::printf("failed to write %s\n", tracePath);
+			return 1;
+		}
+	}
+
+	std::vector<uint64_t> sorted = tickNanoseconds;
+	std::sort(sorted.begin(), sorted.end());
+	double total = 0.0;
+	for (uint64_t ns : sorted)
+	{
+		total += (double)ns;
+	}
+
+	std::printf("log:                %s\n", logPath);
+	std::printf("seed:               %llu\n", (unsigned long long)log.GetSeed());
+	std::printf("ticks:              %llu\n", (unsigned long long)world.GetTickCount());
+	std::printf("simulated time:     %.1f s\n", timer.GetTotalSeconds());
+	std::printf("wall time:          %.3f ms\n", seconds * 1000.0);
+	std::printf("tick mean:          %.1f ns\n", sorted.empty() ? 0.0 : total / sorted.size());
+	std::printf("tick p50:           %.0f ns\n", Percentile(sorted, 0.50));
+	std::printf("tick p95:           %.0f ns\n", Percentile(sorted, 0.95));
+	std::printf("tick p99:           %.0f ns\n", Percentile(sorted, 0.99));
+	std::printf("tick max:           %.0f ns\n", sorted.empty() ? 0.0 : (double)sorted.back());
+	std::printf("state hash:         %016llx\n", (unsigned long long)HashWorld(world));
+
+	return 0;
+}
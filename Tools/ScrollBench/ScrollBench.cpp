@@ -0,0 +1,117 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Cost of everything that scrolls, per 60 Hz tick: Course::Update moving
+// the walls and generating the ones entering the lookahead (what
+// Wall::randomizeGap did for each wall), reading the interpolated rects of
+// the visible walls as the renderer does, and ParallaxLayers::Update, which
+// replaced ScrollingBackground::Update. Courses are the game's (one wall a
+// screen) and CourseConfig::Hard (a wall every 8 pixels, about 250 on a
+// 1920 pixel screen); parallax runs the game's 3 layers and far more.
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "Simulation/Course.hpp"
+#include "Simulation/Parallax.hpp"
+#include "Simulation/Random.hpp"
+
+namespace
+{
+	const float TickSeconds = 1.f / 60.f;
+	const Simulation::Size ScreenSize(1920.f, 1080.f);
+	const float WallWidth = 100.f;
+
+	Simulation::CourseConfig GetCourseConfig(int64_t hard)
+	{
+		return hard ? Simulation::CourseConfig::Hard() : Simulation::CourseConfig();
+	}
+
+	void BM_CourseReset(benchmark::State& state)
+	{
+		Simulation::CourseConfig config = GetCourseConfig(state.range(0));
+		Simulation::Pcg32 random(1, 1);
+		Simulation::Course course;
+
+		for (auto _ : state)
+		{
+			course.Reset(config, ScreenSize, WallWidth, random);
+			benchmark::DoNotOptimize(course.Size());
+		}
+
+		state.SetItemsProcessed(state.iterations() * (int64_t)course.Size());
+	}
+
+	void BM_CourseUpdate(benchmark::State& state)
+	{
+		Simulation::CourseConfig config = GetCourseConfig(state.range(0));
+		Simulation::Pcg32 random(1, 1);
+		Simulation::Course course;
+		course.Reset(config, ScreenSize, WallWidth, random);
+
+		for (auto _ : state)
+		{
+			course.Update(TickSeconds, random);
+			benchmark::DoNotOptimize(course.GetDistance());
+		}
+
+		state.counters["walls"] = (double)course.Size();
+	}
+
+	// The walls Render draws, at the interpolated scroll position.
+	void BM_CourseVisibleRects(benchmark::State& state)
+	{
+		Simulation::CourseConfig config = GetCourseConfig(state.range(0));
+		Simulation::Pcg32 random(1, 1);
+		Simulation::Course course;
+		course.Reset(config, ScreenSize, WallWidth, random);
+		for (int i = 0; i < 600; i++)
+		{
+			course.Update(TickSeconds, random);
+		}
+
+		size_t walls = 0;
+		for (auto _ : state)
+		{
+			walls = course.GetVisibleCount();
+			for (size_t i = 0; i < walls; i++)
+			{
+				float x = course.GetInterpolatedX(i, 0.5f);
+				Simulation::Rect upper = course.GetUpperRect(i);
+				Simulation::Rect lower = course.GetLowerRect(i);
+				benchmark::DoNotOptimize(x);
+				benchmark::DoNotOptimize(upper);
+				benchmark::DoNotOptimize(lower);
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * (int64_t)walls);
+	}
+
+	void BM_ParallaxUpdate(benchmark::State& state)
+	{
+		Simulation::ParallaxLayers layers;
+		layers.SetScreenSize(ScreenSize);
+		for (int64_t i = 0; i < state.range(0); i++)
+		{
+			Simulation::ParallaxLayerDesc desc = { 100.f + 50.f * i, 1.f / (1 + i % 4), Simulation::ParallaxPlane_Back };
+			layers.Add(desc, 1024, 512);
+		}
+
+		for (auto _ : state)
+		{
+			layers.Update(TickSeconds);
+			benchmark::DoNotOptimize(layers.GetQuad(0));
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+}
+
+BENCHMARK(BM_CourseReset)->ArgName("hard")->Arg(0)->Arg(1);
+BENCHMARK(BM_CourseUpdate)->ArgName("hard")->Arg(0)->Arg(1);
+BENCHMARK(BM_CourseVisibleRects)->ArgName("hard")->Arg(0)->Arg(1);
+BENCHMARK(BM_ParallaxUpdate)->Arg(3)->Arg(64)->Arg(1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,210 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Headless driver for the simulation core. Runs a fixed number of ticks at a
+// fixed time step and reports throughput, so the game tick can be profiled
+// and capacity-planned on machines without a GPU. Ticks go through the
+// game's DX::StepTimer on a virtual clock, so they follow the same fixed
+// timestep path as the app, only as fast as the CPU allows.
+//
+// Usage: SimulationBench [--ticks N] [--dt seconds] [--enemies N] [--seed N]
+//                        [--spawn-per-tick N] [--width px] [--height px]
+//                        [--threads N] [--record file] [--course hard]
+//                        [--wall-spacing px] [--warmup N]
+//                        [--memory-report file]
+//
+// --threads runs the per-enemy passes on a JobSystem with N threads
+// (0 = all hardware threads); without it everything runs on one thread.
+// --record saves the generated input as an input log for ReplayRunner.
+// --course hard flies the dense tunnel of CourseConfig::Hard; --wall-spacing
+// changes how far apart the walls are, and so how many are on screen.
+// Heap allocations made by the ticks after --warmup (default 600) are
+// counted and reported; a steady-state tick should make none.
+// --memory-report writes the memory used per subsystem at the end of the
+// run, with the world and its ticks charged to the entities tag.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#include "Common/StepTimer.h"
+#include "Simulation/InputLog.hpp"
+#include "Simulation/MemoryTracker.hpp"
+#include "Simulation/World.hpp"
+
+SIMULATION_DEFINE_MEMORY_TRACKER
+
+namespace
+{
+	void PrintUsage(const char* exe)
+	{
+		std::printf("Usage: %s [--ticks N] [--dt seconds] [--enemies N] [--seed N] [--spawn-per-tick N] [--width px] [--height px] [--threads N] [--record file] [--course hard] [--wall-spacing px] [--warmup N] [--memory-report file]\n", exe);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned long long ticks = 100000;
+	float dt = 1.f / 60.f;
+	Simulation::WorldConfig config;
+	config.seed = 1;
+	bool useJobs = false;
+	unsigned int threads = 0;
+	const char* recordPath = nullptr;
+	unsigned long long warmup = 600;
+	const char* memoryReportPath = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+		if (!value || std::strncmp(arg, "--", 2) != 0)
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+
+		if (!std::strcmp(arg, "--ticks"))			ticks = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--dt"))			dt = std::strtof(value, nullptr);
+		else if (!std::strcmp(arg, "--enemies"))	config.maxEnemies = (unsigned int)std::strtoul(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--seed"))		config.seed = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--spawn-per-tick"))	config.spawnPerTick = (unsigned int)std::strtoul(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--width"))		config.screenSize.Width = std::strtof(value, nullptr);
+		else if (!std::strcmp(arg, "--height"))		config.screenSize.Height = std::strtof(value, nullptr);
+		else if (!std::strcmp(arg, "--threads"))
+		{
+			useJobs = true;
+			threads = (unsigned int)std::strtoul(value, nullptr, 10);
+		}
+		else if (!std::strcmp(arg, "--record"))	recordPath = value;
+		else if (!std::strcmp(arg, "--course") && !std::strcmp(value, "hard"))	config.course = Simulation::CourseConfig::Hard();
+		else if (!std::strcmp(arg, "--wall-spacing"))	config.course.spacing = std::strtof(value, nullptr);
+		else if (!std::strcmp(arg, "--warmup"))		warmup = std::strtoull(value, nullptr, 10);
+		else if (!std::strcmp(arg, "--memory-report"))	memoryReportPath = value;
+		else
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+		i++;
+	}
+
+	// The world, its worker threads and its ticks are what the entities tag measures.
+	Simulation::MemoryTagScope entities(Simulation::MemoryTag_Entities);
+
+	std::unique_ptr<Simulation::JobSystem> jobs;
+	Simulation::World world(config);
+	if (useJobs)
+	{
+		jobs.reset(new Simulation::JobSystem(threads));
+		world.SetJobSystem(jobs.get());
+	}
+
+	Simulation::InputLog inputLog;
+	{
+		Simulation::MemoryTagScope inputTag(Simulation::MemoryTag_Input);
+		// The input below changes every 120 ticks, starting a run each time.
+		inputLog.Begin(config, world.GetSeed(), dt, recordPath ? (size_t)(ticks / 120 + 1) : 0);
+	}
+
+	// A fixed input pattern keeps the player sweeping up and down through the walls.
+	Simulation::PlayerInput input;
+	unsigned long long entityUpdates = 0;
+	unsigned long long wallHits = 0;
+	unsigned long long enemiesDestroyed = 0;
+	unsigned long long steadyAllocations = 0;
+	unsigned long long allocatingTicks = 0;
+
+	// The virtual clock moves exactly one step per Tick, so every Tick runs one update.
+	uint64_t stepTicks = DX::StepTimer::SecondsToTicks(dt);
+	DX::StepTimer timer(std::make_shared<DX::VirtualClock>(stepTicks));
+	timer.SetFixedTimeStep(true);
+	timer.SetTargetElapsedTicks(stepTicks);
+
+	auto start = std::chrono::steady_clock::now();
+
+	// Counted here rather than with the timer's 32-bit frame count, so --ticks may pass 2^32.
+	unsigned long long updates = 0;
+	while (updates < ticks)
+	{
+		timer.Tick([&]()
+		{
+			updates++;
+			unsigned long long tick = world.GetTickCount();
+			Simulation::AllocationScope allocations;
+			input.MoveY = ((tick / 120) % 2) ? 1.f : -1.f;
+			input.Actions = ((tick / 120) % 2) ? Simulation::InputAction_Down : Simulation::InputAction_Up;
+			if (recordPath)
+			{
+				inputLog.Record(input);
+			}
+
+			entityUpdates += world.GetEntityCount();
+			auto result = world.Tick((float)timer.GetElapsedSeconds(), input);
+
+			wallHits += result.playerHitWall ? 1 : 0;
+			enemiesDestroyed += result.enemiesDestroyed;
+
+			if (tick >= warmup && allocations.GetCount())
+			{
+				steadyAllocations += allocations.GetCount();
+				allocatingTicks++;
+			}
+
+			// The tracker's peaks are only as fine as its samples.
+			if (memoryReportPath)
+			{
+				Simulation::MemoryTracker::Get().SampleHighWater();
+			}
+		});
+	}
+
+	auto end = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+	double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count();
+
+	std::printf("ticks:              %llu\n", ticks);
+	std::printf("dt:                 %.6f s\n", dt);
+	std::printf("simulated time:     %.1f s\n", timer.GetTotalSeconds());
+	std::printf("seed:               %llu\n", (unsigned long long)world.GetSeed());
+	std::printf("threads:            %u\n", jobs ? jobs->GetThreadCount() : 1u);
+	std::printf("max enemies:        %u\n", config.maxEnemies);
+	std::printf("live enemies:       %zu\n", world.GetEnemies().Size());
+	std::printf("walls on screen:    %zu (%zu generated ahead)\n", world.GetCourse().GetVisibleCount(),
+		world.GetCourse().Size() - world.GetCourse().GetVisibleCount());
+	std::printf("wall hits:          %llu\n", wallHits);
+	std::printf("enemies destroyed:  %llu\n", enemiesDestroyed);
+	std::printf("wall time:          %.3f ms\n", seconds * 1000.0);
+	std::printf("ticks/sec:          %.0f\n", ticks / seconds);
+	std::printf("ns/tick:            %.1f\n", nanoseconds / ticks);
+	std::printf("ns/entity:          %.2f\n", entityUpdates ? nanoseconds / entityUpdates : 0.0);
+	std::printf("steady allocations: %llu in %llu ticks (after %llu warm-up ticks)\n", steadyAllocations, allocatingTicks, warmup);
+
+	if (recordPath)
+	{
+		std::ofstream file(recordPath, std::ios::binary);
+		if (!inputLog.Write(file))
+		{
+			std::printf("failed to write %s\n", recordPath);
+			return 1;
+		}
+		std::printf("recorded:           %s (%zu runs)\n", recordPath, inputLog.GetRunCount());
+	}
+
+	if (memoryReportPath)
+	{
+		std::ofstream file(memoryReportPath);
+		if (!Simulation::WriteMemoryReport(file, Simulation::MemoryTracker::Get().Snapshot()))
+		{
+			std::printf("failed to write %s\n", memoryReportPath);
+			return 1;
+		}
+		std::printf("memory report:      %s\n", memoryReportPath);
+	}
+
+	return 0;
+}
@@ -0,0 +1,374 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Sprite sheet load and lookup cost: the .txt loader SpriteSheet::Load
+// originally used (std::wifstream, wcstok, one std::wstring and one
+// std::map node per frame) against mapping the binary form from
+// Common\SpriteSheetData.hpp.
+// Sheets are Assets\ships-0.txt and synthetic sheets of 1k to 64k frames,
+// written to the temp directory on first use. Loads hit the file cache, so
+// this measures parsing and allocation rather than disk speed. BM_Convert
+// is the build time conversion from the .txt to the binary form.
+//
+// The playback benchmarks animate ships-0's alien1 clip (alien10001 ...
+// alien10015) for 1000 sprites per step, once by building each frame name
+// and looking it up, once through a clip of frame indices.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "Common/MappedFile.hpp"
+#include "Common/SpriteClips.hpp"
+#include "Common/SpriteSheetData.hpp"
+
+namespace
+{
+	struct Frame
+	{
+		long	left;
+		long	top;
+		long	right;
+		long	bottom;
+		float	sizeX;
+		float	sizeY;
+		float	originX;
+		float	originY;
+		bool	rotated;
+	};
+
+	// The original SpriteSheet::Load with the standard equivalents of the
+	// MSVC functions it called (wcstok_s, _wtol, _wtof).
+	bool LoadText(const char* path, std::map<std::wstring, Frame>& sprites)
+	{
+		sprites.clear();
+
+		std::wifstream inFile(path);
+		if (!inFile)
+			return false;
+
+		wchar_t strLine[1024];
+		for (;;)
+		{
+			inFile >> strLine;
+			if (!inFile)
+				break;
+
+			if (0 != wcscmp(strLine, L"#"))
+			{
+				static const wchar_t* delim = L";\n";
+				wchar_t* context = nullptr;
+				wchar_t* name = wcstok(strLine, delim, &context);
+				if (!name || !*name || sprites.find(name) != sprites.cend())
+					return false;
+
+				wchar_t* fields[9];
+				for (int i = 0; i < 9; i++)
+				{
+					fields[i] = wcstok(nullptr, delim, &context);
+					if (!fields[i])
+						return false;
+				}
+
+				Frame frame;
+				frame.rotated = (wcstol(fields[0], nullptr, 10) == 1);
+				frame.left = wcstol(fields[1], nullptr, 10);
+				frame.top = wcstol(fields[2], nullptr, 10);
+				long dx = wcstol(fields[3], nullptr, 10);
+				long dy = wcstol(fields[4], nullptr, 10);
+				frame.right = frame.left + dx;
+				frame.bottom = frame.top + dy;
+				frame.sizeX = (float)wcstod(fields[5], nullptr);
+				frame.sizeY = (float)wcstod(fields[6], nullptr);
+				float pivotX = (float)wcstod(fields[7], nullptr);
+				float pivotY = (float)wcstod(fields[8], nullptr);
+				frame.originX = frame.rotated ? dx * (1.f - pivotY) : dx * pivotX;
+				frame.originY = frame.rotated ? dy * pivotX : dy * pivotY;
+
+				sprites.insert(std::pair<std::wstring, Frame>(std::wstring(name), frame));
+			}
+
+			inFile.ignore(1000, '\n');
+		}
+		return true;
+	}
+
+	std::string TempPath(const std::string& name)
+	{
+		const char* dir = std::getenv("TMPDIR");
+		return std::string(dir && *dir ? dir : "/tmp") + "/" + name;
+	}
+
+	bool WriteFile(const std::string& path, const void* data, size_t size)
+	{
+		std::ofstream file(path, std::ios::binary);
+		file.write((const char*)data, size);
+		return !file.fail();
+	}
+
+	// A .txt sheet and its binary form on disk, removed at exit.
+	struct SheetFiles
+	{
+		std::string					text;
+		std::string					binary;
+		std::vector<std::wstring>	names;
+
+		~SheetFiles()
+		{
+			std::remove(text.c_str());
+			std::remove(binary.c_str());
+		}
+	};
+
+	bool Convert(const std::string& text, SheetFiles& files)
+	{
+		std::vector<SpriteSheetEntry> entries;
+		std::string error;
+		if (!ParseSpriteSheetText(text.data(), text.size(), entries, error))
+			return false;
+
+		std::vector<uint8_t> file = BuildSpriteSheetFile(entries);
+		for (const SpriteSheetEntry& entry : entries)
+		{
+			files.names.push_back(std::wstring(entry.name.begin(), entry.name.end()));
+		}
+		return WriteFile(files.text, text.data(), text.size()) && WriteFile(files.binary, file.data(), file.size());
+	}
+
+	// frameCount 0 is Assets\ships-0.txt.
+	const SheetFiles* GetSheet(int frameCount)
+	{
+		static std::map<int, std::unique_ptr<SheetFiles>> sheets;
+
+		auto it = sheets.find(frameCount);
+		if (it != sheets.end())
+			return it->second.get();
+
+		std::unique_ptr<SheetFiles> files(new SheetFiles);
+		std::string prefix = "SpriteSheetBench-" + std::to_string(frameCount);
+		files->text = TempPath(prefix + ".txt");
+		files->binary = TempPath(prefix + ".pgss");
+
+		std::string text;
+		if (frameCount == 0)
+		{
+			std::ifstream in(GAME_ASSETS_DIR "/ships-0.txt", std::ios::binary);
+			text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+		else
+		{
+			text = "#\n# Synthetic sheet\n#\n\n";
+			char line[128];
+			for (int i = 0; i < frameCount; i++)
+			{
+				std::snprintf(line, sizeof(line), "alien%d%04d;%d;%d;%d;64;64;64;64;0.5;0.5\n", i / 10000, i % 10000, i & 1, (i % 64) * 64, (i / 64) * 64);
+				text += line;
+			}
+		}
+
+		if (text.empty() || !Convert(text, *files))
+			return nullptr;
+
+		SheetFiles* result = files.get();
+		sheets[frameCount] = std::move(files);
+		return result;
+	}
+
+	void BM_LoadText(benchmark::State& state)
+	{
+		const SheetFiles* sheet = GetSheet((int)state.range(0));
+		if (!sheet)
+		{
+			state.SkipWithError("sheet not available");
+			return;
+		}
+
+		std::map<std::wstring, Frame> sprites;
+		for (auto _ : state)
+		{
+			if (!LoadText(sheet->text.c_str(), sprites))
+			{
+				state.SkipWithError("text load failed");
+				break;
+			}
+			benchmark::DoNotOptimize(sprites.size());
+		}
+
+		state.SetItemsProcessed(state.iterations() * sheet->names.size());
+	}
+
+	void BM_LoadBinary(benchmark::State& state)
+	{
+		const SheetFiles* sheet = GetSheet((int)state.range(0));
+		if (!sheet)
+		{
+			state.SkipWithError("sheet not available");
+			return;
+		}
+
+		MappedFile file;
+		SpriteSheetView view;
+		for (auto _ : state)
+		{
+			if (!file.Open(sheet->binary.c_str()) || !view.Open(file.Data(), file.Size()))
+			{
+				state.SkipWithError("binary load failed");
+				break;
+			}
+			benchmark::DoNotOptimize(view.GetFrameCount());
+		}
+
+		state.SetItemsProcessed(state.iterations() * sheet->names.size());
+	}
+
+	// What SpriteSheetConverter does at build time: parse the .txt with
+	// ParseSpriteSheetText and lay out the binary form.
+	void BM_Convert(benchmark::State& state)
+	{
+		const SheetFiles* sheet = GetSheet((int)state.range(0));
+		if (!sheet)
+		{
+			state.SkipWithError("sheet not available");
+			return;
+		}
+
+		std::ifstream in(sheet->text, std::ios::binary);
+		std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+		std::vector<SpriteSheetEntry> entries;
+		std::string error;
+		for (auto _ : state)
+		{
+			if (!ParseSpriteSheetText(text.data(), text.size(), entries, error))
+			{
+				state.SkipWithError("text parse failed");
+				break;
+			}
+			benchmark::DoNotOptimize(BuildSpriteSheetFile(entries).data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * sheet->names.size());
+	}
+
+	void BM_FindText(benchmark::State& state)
+	{
+		const SheetFiles* sheet = GetSheet((int)state.range(0));
+		std::map<std::wstring, Frame> sprites;
+		if (!sheet || !LoadText(sheet->text.c_str(), sprites))
+		{
+			state.SkipWithError("sheet not available");
+			return;
+		}
+
+		size_t i = 0;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(sprites.find(sheet->names[i].c_str()));
+			i = (i + 1) % sheet->names.size();
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_FindBinary(benchmark::State& state)
+	{
+		const SheetFiles* sheet = GetSheet((int)state.range(0));
+		MappedFile file;
+		SpriteSheetView view;
+		if (!sheet || !file.Open(sheet->binary.c_str()) || !view.Open(file.Data(), file.Size()))
+		{
+			state.SkipWithError("sheet not available");
+			return;
+		}
+
+		size_t i = 0;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(view.Find(sheet->names[i].c_str()));
+			i = (i + 1) % sheet->names.size();
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	const int PlaybackSprites = 1000;
+	const float PlaybackStep = 1.f / 60.f;
+
+	void BM_ClipPlaybackByName(benchmark::State& state)
+	{
+		const SheetFiles* sheet = GetSheet(0);
+		std::map<std::wstring, Frame> sprites;
+		if (!sheet || !LoadText(sheet->text.c_str(), sprites))
+		{
+			state.SkipWithError("sheet not available");
+			return;
+		}
+
+		float time = 0.f;
+		for (auto _ : state)
+		{
+			for (int sprite = 0; sprite < PlaybackSprites; sprite++)
+			{
+				int frame = (int)((time + sprite * 0.01f) * 15.f) % 15 + 1;
+				wchar_t name[32];
+				std::swprintf(name, 32, L"alien1%04d", frame);
+				benchmark::DoNotOptimize(sprites.find(name)->second.left);
+			}
+			time += PlaybackStep;
+		}
+
+		state.SetItemsProcessed(state.iterations() * PlaybackSprites);
+	}
+
+	void BM_ClipPlaybackById(benchmark::State& state)
+	{
+		const SheetFiles* sheet = GetSheet(0);
+		MappedFile file;
+		SpriteSheetView view;
+		if (!sheet || !file.Open(sheet->binary.c_str()) || !view.Open(file.Data(), file.Size()))
+		{
+			state.SkipWithError("sheet not available");
+			return;
+		}
+
+		Simulation::AnimationClips clips;
+		BuildSpriteClips(view, 15.f, clips);
+		uint32_t id = clips.Find("alien1");
+		if (id == Simulation::InvalidAnimationClip || clips.Get(id).frameCount != 15)
+		{
+			state.SkipWithError("alien1 clip not found");
+			return;
+		}
+		const Simulation::AnimationClip& clip = clips.Get(id);
+
+		float time = 0.f;
+		for (auto _ : state)
+		{
+			for (int sprite = 0; sprite < PlaybackSprites; sprite++)
+			{
+				benchmark::DoNotOptimize(view.GetFrame(Simulation::AnimationFrameAt(clips, clip, time + sprite * 0.01f)).left);
+			}
+			time += PlaybackStep;
+		}
+
+		state.SetItemsProcessed(state.iterations() * PlaybackSprites);
+	}
+}
+
+BENCHMARK(BM_LoadText)->Arg(0)->Arg(1024)->Arg(16384)->Arg(65536)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LoadBinary)->Arg(0)->Arg(1024)->Arg(16384)->Arg(65536)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Convert)->Arg(0)->Arg(1024)->Arg(16384)->Arg(65536)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FindText)->Arg(0)->Arg(65536);
+BENCHMARK(BM_FindBinary)->Arg(0)->Arg(65536);
+BENCHMARK(BM_ClipPlaybackByName);
+BENCHMARK(BM_ClipPlaybackById);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,68 @@
+//For educational use only
+//NOT TO BE USED IN COMMERCIAL OR SCHOOL PROJECTS
+
+// Converts TexturePacker 'MonoGame' .txt sprite data into the binary sheet
+// format of Common\SpriteSheetData.hpp, which SpriteSheet::Load maps
+// instead of parsing. The result is read back and every frame looked up
+// before the tool reports success.
+//
+// Usage: SpriteSheetConverter <in.txt> <out.pgss>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Common/SpriteSheetData.hpp"
+
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		std::printf("Usage: %s <in.txt> <out.pgss>\n", argv[0]);
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::binary);
+	if (!in)
+	{
+		std::printf("failed to read %s\n", argv[1]);
+		return 1;
+	}
+	std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+	std::vector<SpriteSheetEntry> entries;
+	std::string error;
+	if (!ParseSpriteSheetText(text.data(), text.size(), entries, error))
+	{
+		std::printf("%s: %s\n", argv[1], error.c_str());
+		return 1;
+	}
+
+	std::vector<uint8_t> file = BuildSpriteSheetFile(entries);
+
+	// std::vector storage is suitably aligned for the view.
+	SpriteSheetView view;
+	bool valid = view.Open(file.data(), file.size());
+	for (size_t i = 0; valid && i < entries.size(); i++)
+	{
+		valid = view.Find(entries[i].name.c_str()) == &view.GetFrame((uint32_t)i);
+	}
+	if (!valid)
+	{
+		std::printf("%s: converted sheet failed verification\n", argv[1]);
+		return 1;
+	}
+
+	std::ofstream out(argv[2], std::ios::binary);
+	out.write((const char*)file.data(), file.size());
+	if (!out)
+	{
+		std::printf("failed to write %s\n", argv[2]);
+		return 1;
+	}
+
+	std::printf("%s: %zu frames, %zu bytes\n", argv[2], entries.size(), file.size());
+	return 0;
+}